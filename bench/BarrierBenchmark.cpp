@@ -0,0 +1,101 @@
+/*! \file BarrierBenchmark.cpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Measures the cost of one barrier round versus the number of threads.
+ *  \details Compares the StepBarrier of the parallel engine with a std::mutex/std::condition_variable barrier.
+ *  \details Usage: BarrierBenchmark [max_threads] [rounds]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <cstdlib>
+#include "../src/StepBarrier.hpp"
+
+/*! Barrier based on a mutex and a condition variable, the reference to beat */
+class MutexBarrier
+{
+	private :
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		unsigned int const count_;
+		unsigned int waiting_;
+		unsigned long generation_;
+
+	public :
+		explicit MutexBarrier(unsigned int count) : count_(count), waiting_(0), generation_(0) {}
+
+		void wait()
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			unsigned long const generation(generation_);
+			if (++waiting_ == count_) {
+				waiting_ = 0;
+				++generation_;
+				condition_.notify_all();
+			} else {
+				condition_.wait(lock, [this, generation] { return generation_ != generation; });
+			}
+		}
+};
+
+/*! Runs rounds barrier rounds on threads threads, returns the mean duration of a round [ns] */
+template <typename Barrier>
+double time_rounds(unsigned int threads, unsigned int rounds)
+{
+	Barrier barrier(threads);
+	auto run = [&barrier, rounds] {
+		for (unsigned int round(0); round < rounds; ++round) {
+			barrier.wait();
+		}
+	};
+
+	// one extra round, so that the clock starts once every thread is running
+	std::vector<std::thread> others;
+	for (unsigned int thread(1); thread < threads; ++thread) {
+		others.push_back(std::thread([&barrier, &run] { barrier.wait(); run(); }));
+	}
+	barrier.wait();
+	auto start = std::chrono::steady_clock::now();
+	run();
+	auto end = std::chrono::steady_clock::now();
+	for (auto& thread : others) {
+		thread.join();
+	}
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int max_threads(std::thread::hardware_concurrency());
+	unsigned int rounds(100000);
+	if (argc > 1) {
+		max_threads = std::atoi(argv[1]);
+	}
+	if (argc > 2) {
+		rounds = std::atoi(argv[2]);
+	}
+	if (max_threads == 0) {
+		max_threads = 1;
+	}
+
+	std::cout << "Mean cost of one barrier round (" << rounds << " rounds, "
+			  << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+	std::cout << std::setw(8) << "threads" << std::setw(20) << "StepBarrier [ns]" << std::setw(22) << "mutex/condvar [ns]" << std::endl;
+
+	for (unsigned int threads(1); threads <= max_threads; threads = (threads < 4 ? threads + 1 : threads * 2)) {
+		double const step(time_rounds<StepBarrier>(threads, rounds));
+		double const mutex(time_rounds<MutexBarrier>(threads, rounds));
+		std::cout << std::fixed << std::setprecision(1)
+				  << std::setw(8) << threads << std::setw(20) << step << std::setw(22) << mutex << std::endl;
+	}
+	return 0;
+}
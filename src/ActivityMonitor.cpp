@@ -0,0 +1,114 @@
+#include "ActivityMonitor.hpp"
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include "Neuron.hpp"
+
+ActivityMonitor::ActivityMonitor(unsigned int number_of_neurons, double time_step, double tolerance)
+	: number_of_neurons_(number_of_neurons), time_step_(time_step), tolerance_(tolerance),
+	  window_steps_(std::max(1L, std::lround(MONITOR_WINDOW / time_step))),
+	  steps_(0), window_spikes_(0), status_(ActivityStatus::running)
+{
+	assert(number_of_neurons > 0 and time_step > 0);
+}
+
+void ActivityMonitor::record(int spikes)
+{
+	if (status_ != ActivityStatus::running) {
+		return;
+	}
+	++steps_;
+	window_spikes_ += spikes;
+	if (steps_ % window_steps_ != 0) {
+		return;
+	}
+
+	double const window_time(window_steps_ * time_step_);
+	double const rate(window_spikes_ * 1000.0 / (number_of_neurons_ * window_time));
+	window_spikes_ = 0;
+
+	if (time() >= MONITOR_GRACE_PERIOD + window_time) {
+		// the network had the grace period to start firing
+		if (rate == 0.0) {
+			status_ = ActivityStatus::quiescent;
+			return;
+		}
+		if (rate >= SATURATION_FRACTION * 1000.0 / (REFRACTORY_PERIOD * DEFAULT_TIME_STEP)) {
+			status_ = ActivityStatus::saturated;
+			return;
+		}
+	}
+
+	if (time() < MONITOR_BURN_IN + window_time) {
+		return;
+	}
+	window_rates_.push_back(rate);
+	if (window_rates_.size() < MINIMUM_WINDOWS) {
+		return;
+	}
+
+	double const mean(mean_rate());
+	double variance(0.0);
+	for (double const window_rate : window_rates_) {
+		variance += (window_rate - mean) * (window_rate - mean);
+	}
+	variance /= window_rates_.size() - 1;
+	if (std::sqrt(variance / window_rates_.size()) > tolerance_ * mean) {
+		return;
+	}
+
+	// a trend, which also widens the spread of the windows, shows as a difference between the earlier and the later ones
+	size_t const half(window_rates_.size() / 2);
+	double first_mean(0.0), second_mean(0.0);
+	for (size_t window(0); window < window_rates_.size(); ++window) {
+		(window < half ? first_mean : second_mean) += window_rates_[window];
+	}
+	first_mean /= half;
+	second_mean /= window_rates_.size() - half;
+	double spread(0.0);
+	for (size_t window(0); window < window_rates_.size(); ++window) {
+		double const deviation(window_rates_[window] - (window < half ? first_mean : second_mean));
+		spread += deviation * deviation;
+	}
+	double const difference_error(std::sqrt(spread / (window_rates_.size() - 2)
+											* (1.0 / half + 1.0 / (window_rates_.size() - half))));
+	if (std::abs(second_mean - first_mean) <= DRIFT_DEVIATIONS * difference_error) {
+		status_ = ActivityStatus::stationary;
+	}
+}
+
+ActivityStatus ActivityMonitor::status() const
+{
+	return status_;
+}
+
+double ActivityMonitor::mean_rate() const
+{
+	if (window_rates_.empty()) {
+		return 0.0;
+	}
+	double sum(0.0);
+	for (double const rate : window_rates_) {
+		sum += rate;
+	}
+	return sum / window_rates_.size();
+}
+
+double ActivityMonitor::time() const
+{
+	return steps_ * time_step_;
+}
+
+char const* to_string(ActivityStatus status)
+{
+	switch (status) {
+		case ActivityStatus::quiescent :
+			return "quiescent";
+		case ActivityStatus::saturated :
+			return "saturated";
+		case ActivityStatus::stationary :
+			return "stationary";
+		default :
+			return "running";
+	}
+}
@@ -0,0 +1,104 @@
+/*! \class ActivityMonitor
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Watches the number of spikes of the network at each time step, to end runs whose outcome is known.
+ *  \details The steps are grouped in windows of MONITOR_WINDOW ms. After MONITOR_GRACE_PERIOD ms, a window
+ *  \details without any spike means that the activity died out, and a window in which the neurons fire at
+ *  \details SATURATION_FRACTION of the inverse of the refractory period or more means that they saturate.
+ *  \details The rate is stationary once the mean of the rates of the windows after MONITOR_BURN_IN ms
+ *  \details is known to a relative tolerance, i.e. when its standard error falls below the tolerance, and doesn't
+ *  \details drift: the means of the first and of the second half of these windows have to agree within their noise.
+ *  \details Every rank of a distributed simulation monitors the sums of the whole network, so that they all stop at the same step.
+ */
+
+#ifndef ACTIVITYMONITOR_H
+#define ACTIVITYMONITOR_H
+
+#include <vector>
+
+/*! Length of the windows over which the rate is measured [ms] */
+constexpr double MONITOR_WINDOW (50.0);
+
+/*! Time the network is given before it is found quiescent or saturated [ms] */
+constexpr double MONITOR_GRACE_PERIOD (100.0);
+
+/*! Time left out of the stationary rate [ms] */
+constexpr double MONITOR_BURN_IN (200.0);
+
+/*! Fraction of the highest possible rate from which the network is saturated */
+constexpr double SATURATION_FRACTION (0.5);
+
+/*! Smallest number of windows the stationary rate is estimated from */
+constexpr unsigned int MINIMUM_WINDOWS (4);
+
+/*! Number of standard errors by which the means of the two halves of the windows may differ in a stationary rate */
+constexpr double DRIFT_DEVIATIONS (2.0);
+
+/*! What the monitor found out about the activity */
+enum class ActivityStatus
+{
+	/*! Nothing yet */
+	running,
+	/*! The activity died out */
+	quiescent,
+	/*! The neurons fire at the refractory limit */
+	saturated,
+	/*! The rate converged */
+	stationary
+};
+
+class ActivityMonitor
+{
+	private :
+
+		unsigned int const number_of_neurons_;
+		double const time_step_;
+
+		/*! \brief Relative standard error of the mean rate at which it is stationary */
+		double const tolerance_;
+
+		/*! \brief Number of time steps of a window */
+		int const window_steps_;
+
+		/*! \brief Number of time steps recorded */
+		int steps_;
+
+		/*! \brief Number of spikes of the current window */
+		long window_spikes_;
+
+		/*! \brief Rates of the complete windows after the burn-in [Hz] */
+		std::vector<double> window_rates_;
+
+		ActivityStatus status_;
+
+	public :
+
+		/*! \brief Constructor
+		 * @param[in] number_of_neurons the number of neurons of the network
+		 * @param[in] time_step the time step of the simulation [ms]
+		 * @param[in] tolerance the relative standard error of the mean rate at which it is stationary
+		 */
+		ActivityMonitor(unsigned int number_of_neurons, double time_step, double tolerance);
+
+		/*! \brief Records the number of spikes of the network in the next time step
+		 *  \details The status doesn't change anymore once it isn't running.
+		 */
+		void record(int spikes);
+
+		/*! \brief Returns what the monitor found out so far */
+		ActivityStatus status() const;
+
+		/*! \brief Returns the mean rate of the windows after the burn-in [Hz], 0 if there is none */
+		double mean_rate() const;
+
+		/*! \brief Returns the simulated time [ms] */
+		double time() const;
+};
+
+/*! \brief Returns the name of a status */
+char const* to_string(ActivityStatus status);
+
+#endif /* ActivityMonitor_hpp */
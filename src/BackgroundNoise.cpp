@@ -0,0 +1,96 @@
+#include "BackgroundNoise.hpp"
+#include <cmath>
+#include <cassert>
+
+namespace {
+
+constexpr double TWO_PI (6.283185307179586);
+
+/*! Probability below which the numbers beyond the mean are left out of a PoissonTable */
+constexpr double NEGLIGIBLE_PROBABILITY (1e-18);
+
+/*! Number of standard deviations below the mean from which a PoissonTable starts, e^-50 less likely */
+constexpr double TABLE_DEVIATIONS (10.0);
+
+/*! Box-Muller transform of pairs of uniform numbers in (0, 1] and [0, 1) */
+inline void box_muller(double u1, double u2, double& first, double& second)
+{
+	double const radius(std::sqrt(-2.0 * std::log(u1)));
+	first = radius * std::cos(TWO_PI * u2);
+	second = radius * std::sin(TWO_PI * u2);
+}
+
+}
+
+void fill_normal(std::default_random_engine& generator, std::vector<double>& normals, unsigned int count)
+{
+	// an even number of uniforms, the last normal of an odd count is dropped
+	unsigned int const pairs((count + 1) / 2);
+	normals.resize(2 * pairs);
+
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+	for (unsigned int i(0); i < 2 * pairs; ++i) {
+		normals[i] = uniform(generator);
+	}
+	for (unsigned int i(0); i < pairs; ++i) {
+		// log(0) is avoided by taking 1 - u
+		box_muller(1.0 - normals[2 * i], normals[2 * i + 1], normals[2 * i], normals[2 * i + 1]);
+	}
+	normals.resize(count);
+}
+
+double normal(CounterRandom& random)
+{
+	double const u1(1.0 - random.uniform());
+	double const u2(random.uniform());
+	double first, second;
+	box_muller(u1, u2, first, second);
+	return first;
+}
+
+PoissonTable::PoissonTable(double mean)
+	: mean_(mean), first_(0)
+{
+	assert(mean >= 0);
+	if (mean == 0.0) {
+		cumulative_.assign(1, 1.0);
+		guide_.assign(1, 0);
+		return;
+	}
+	// in logarithms, exp(-mean) underflows from a mean of 745 on
+	first_ = std::max(0.0, std::floor(mean - TABLE_DEVIATIONS * std::sqrt(mean) - TABLE_DEVIATIONS));
+	double const log_mean(std::log(mean));
+	double sum(0.0);
+	for (int k(first_); ; ++k) {
+		double const probability(std::exp(k * log_mean - mean - std::lgamma(k + 1.0)));
+		sum += probability;
+		cumulative_.push_back(sum);
+		if (k > mean and probability < NEGLIGIBLE_PROBABILITY * sum) {
+			break;
+		}
+	}
+	for (auto& cumulative : cumulative_) {
+		cumulative /= sum;
+	}
+	cumulative_.back() = 1.0;
+
+	guide_.resize(cumulative_.size());
+	unsigned int i(0);
+	for (size_t j(0); j < guide_.size(); ++j) {
+		double const u(static_cast<double>(j) / guide_.size());
+		while (cumulative_[i] <= u) {
+			++i;
+		}
+		guide_[j] = i;
+	}
+}
+
+double PoissonTable::mean() const
+{
+	return mean_;
+}
+
+size_t PoissonTable::size() const
+{
+	return cumulative_.size();
+}
@@ -0,0 +1,96 @@
+/*! \file BackgroundNoise.hpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Models of the background input of the neurons, from the rest of the brain.
+ *  \details Each neuron receives J k per time step, with k Poisson distributed with mean lambda. The diffusion
+ *  \details approximation replaces it by a Gaussian of mean J lambda and variance J^2 lambda, whose numbers are drawn
+ *  \details in bulk by the Box-Muller transform, without the loops of the Poisson samplers. It drops the skew of the
+ *  \details Poisson numbers, which changes the firing of a neuron driven at the threshold by a few percent.
+ *  \details The shared model gives a part of the variance of the Gaussian to a number common to all neurons
+ *  \details at a time step, so that the inputs of two neurons are correlated by that fraction.
+ *  \details A PoissonTable draws the Poisson numbers of a mean by inverting a uniform number with a table of the
+ *  \details cumulative distribution, built once per mean, for the rates which vary in time, see Stimulus.hpp.
+ */
+
+#ifndef BACKGROUNDNOISE_H
+#define BACKGROUNDNOISE_H
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include "CounterRandom.hpp"
+
+/*! Stream of the counter-based generator from which the number shared by all neurons is drawn */
+constexpr uint32_t SHARED_NOISE_STREAM (0xFFFFFFFF);
+
+/*! The models of the background input */
+enum class BackgroundModel
+{
+	/*! J times a Poisson number, exact */
+	poisson,
+	/*! Gaussian of the same mean and variance, independent for each neuron */
+	gaussian,
+	/*! Gaussian of the same mean and variance, a fraction of the variance common to all neurons */
+	shared
+};
+
+/*! \class PoissonTable
+ *  \brief Inverts uniform numbers into Poisson numbers of a mean with a table of the cumulative distribution.
+ *  \details The table leaves out the numbers whose probability is negligible and is normalized, a guide table
+ *  \details gives where to start searching it, so that a number takes about one comparison whatever the mean.
+ */
+class PoissonTable
+{
+	private :
+
+		/*! \brief Mean of the distribution */
+		double mean_;
+
+		/*! \brief Smallest number of the table */
+		int first_;
+
+		/*! \brief Probability of the numbers up to first_ + i, the last one 1 */
+		std::vector<double> cumulative_;
+
+		/*! \brief Index of the first cumulative probability above j / size, for a uniform number in [j / size, (j + 1) / size) */
+		std::vector<unsigned int> guide_;
+
+	public :
+
+		/*! \brief Constructor, builds the tables
+		 * @param[in] mean the mean of the distribution, positive or 0
+		 */
+		explicit PoissonTable(double mean = 0.0);
+
+		/*! \brief Returns the mean of the distribution */
+		double mean() const;
+
+		/*! \brief Returns the number of entries of the table */
+		size_t size() const;
+
+		/*! \brief Returns the Poisson number of a uniform number in [0, 1) */
+		int operator()(double u) const
+		{
+			unsigned int const last(cumulative_.size() - 1);
+			unsigned int i(guide_[std::min<unsigned int>(u * guide_.size(), guide_.size() - 1)]);
+			while (i < last and u >= cumulative_[i]) {
+				++i;
+			}
+			return first_ + i;
+		}
+};
+
+/*! \brief Fills normals with count standard normal numbers
+ *  \details The uniform numbers are drawn first and transformed pairwise by Box-Muller in a separate loop,
+ *  \details free of branches, which the compiler can vectorize.
+ */
+void fill_normal(std::default_random_engine& generator, std::vector<double>& normals, unsigned int count);
+
+/*! \brief Returns a standard normal number from the two first uniform numbers of a counter-based stream */
+double normal(CounterRandom& random);
+
+#endif /* BackgroundNoise_hpp */
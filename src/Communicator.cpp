@@ -0,0 +1,110 @@
+#include "Communicator.hpp"
+#include "SharedMemoryCommunicator.hpp"
+#include "SocketCommunicator.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <csignal>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/wait.h>
+
+Communicator::Communicator(int rank, int size)
+	: rank_(rank), size_(size)
+{
+	assert(size > 0);
+	assert(rank >= 0 and rank < size);
+}
+
+Communicator::~Communicator()
+{
+	wait_for_children();
+}
+
+int Communicator::get_rank() const
+{
+	return rank_;
+}
+
+int Communicator::get_size() const
+{
+	return size_;
+}
+
+void Communicator::barrier()
+{
+	// an exchange of empty buffers can only complete once every rank has entered it
+	RankBuffers nothing(size_), ignored;
+	exchange(nothing, ignored);
+}
+
+void Communicator::abort()
+{}
+
+void Communicator::adopt_children(std::vector<pid_t> const& children)
+{
+	children_ = children;
+}
+
+int Communicator::wait_for_children()
+{
+	int failed(0);
+	for (auto const child : children_) {
+		int status(0);
+		if (waitpid(child, &status, 0) < 0 or !WIFEXITED(status) or WEXITSTATUS(status) != 0) {
+			++failed;
+		}
+	}
+	children_.clear();
+	return failed;
+}
+
+Communicator* launch_local_ranks(std::string const& transport, int size, std::size_t capacity, int port)
+{
+	if (transport != "shm" and transport != "socket") {
+		throw std::runtime_error("unknown transport " + transport);
+	}
+
+	// the shared segment has to exist before forking, so that every rank inherits it
+	SharedMemoryCommunicator* shared(nullptr);
+	if (transport == "shm") {
+		shared = new SharedMemoryCommunicator(size, capacity);
+	}
+
+	// don't let the children print what is still buffered in the parent
+	std::cout << std::flush;
+	std::cerr << std::flush;
+
+	std::vector<pid_t> children;
+	int rank(0);
+	for (int r(1); r < size; ++r) {
+		pid_t pid = fork();
+		if (pid < 0) {
+			// the ranks already forked would wait for this one forever
+			for (auto const child : children) {
+				kill(child, SIGKILL);
+				waitpid(child, nullptr, 0);
+			}
+			delete shared;
+			throw std::runtime_error("couldn't fork rank " + std::to_string(r));
+		}
+		if (pid == 0) {
+			rank = r;
+			children.clear();
+			break;
+		}
+		children.push_back(pid);
+	}
+
+	Communicator* communicator(nullptr);
+	if (shared != nullptr) {
+		shared->set_rank(rank);
+		communicator = shared;
+	} else {
+		communicator = new SocketCommunicator(rank, size, "127.0.0.1", port);
+	}
+
+	// only the parent waits, the children exit on their own
+	communicator->adopt_children(children);
+	return communicator;
+}
@@ -0,0 +1,96 @@
+/*! \class Communicator
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief MPI-style communicator connecting the ranks of a distributed simulation.
+ *  \details Each rank simulates a contiguous block of the neurons of the Cortex.
+ *  \details Once per min-delay epoch the ranks call exchange() to hand each other the spikes
+ *  \details that have targets on the receiving rank.
+ *  \details Two transports implement this interface: SharedMemoryCommunicator (local processes)
+ *  \details and SocketCommunicator (TCP, also usable across machines).
+ */
+
+#ifndef COMMUNICATOR_H
+#define COMMUNICATOR_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <sys/types.h>
+
+/*! One buffer of words per peer rank, indexed by rank */
+typedef std::vector<std::vector<unsigned int> > RankBuffers;
+
+class Communicator
+{
+	protected :
+
+		/*! \brief Rank of this process, in [0, size_) */
+		int rank_;
+
+		/*! \brief Number of ranks taking part in the simulation */
+		int size_;
+
+		/*! \brief Processes forked by launch_local_ranks(), only set on rank 0 */
+		std::vector<pid_t> children_;
+
+	public :
+
+		/*! \brief Constructor
+		 * @param[in] rank the rank of this process
+		 * @param[in] size the number of ranks
+		 */
+		Communicator(int rank, int size);
+
+		/*! \brief Destructor
+		 *  \details Waits for the forked ranks, if any.
+		 */
+		virtual ~Communicator();
+
+		/*! \brief Returns the rank of this process */
+		int get_rank() const;
+
+		/*! \brief Returns the number of ranks */
+		int get_size() const;
+
+		/*! \brief All-to-all exchange of variable sized buffers.
+		 *  \details Collective: every rank has to call it. outgoing[r] is delivered to rank r,
+		 *  \details and incoming[r] receives what rank r sent to this rank.
+		 * @param[in] outgoing one buffer per destination rank
+		 * @param[out] incoming one buffer per source rank
+		 * \throw runtime_error if the transport fails
+		 */
+		virtual void exchange(RankBuffers const& outgoing, RankBuffers& incoming) = 0;
+
+		/*! \brief Blocks until every rank has reached the barrier */
+		virtual void barrier();
+
+		/*! \brief Called by a rank which fails, so that the other ranks don't wait for it forever
+		 *  \details The ranks waiting in, or later entering, exchange() or barrier() throw instead.
+		 *  \details Does nothing by default: a transport which notices the end of a peer doesn't need it.
+		 */
+		virtual void abort();
+
+		/*! \brief Registers the processes forked for the other ranks, so they can be waited for */
+		void adopt_children(std::vector<pid_t> const& children);
+
+		/*! \brief Waits for the forked ranks to terminate.
+		 *  \return the number of ranks which did not exit successfully
+		 */
+		int wait_for_children();
+};
+
+/*! \brief Forks size - 1 processes and connects them with the given transport.
+ *  \details Returns in every process, with a communicator whose rank tells the process which
+ *  \details part of the network it simulates. Rank 0 is the calling process.
+ * @param[in] transport "shm" for POSIX shared memory, "socket" for TCP on the loopback interface
+ * @param[in] size the number of ranks
+ * @param[in] capacity maximal number of words a rank sends to another rank per exchange (shm only)
+ * @param[in] port first TCP port, rank r listens on port + r (socket only)
+ * \throw runtime_error if the transport cannot be set up
+ */
+Communicator* launch_local_ranks(std::string const& transport, int size, std::size_t capacity, int port);
+
+#endif /* Communicator_hpp */
@@ -6,6 +6,10 @@
 #include <stdexcept>
 #include <random>
 #include <chrono>
+#include <algorithm>
+#include <iomanip>
+#include <cmath>
+#include "Numa.hpp"
 
 // various strings used for terminal animations
 #define BOLD "\033[1m\033[37m"
@@ -18,6 +22,7 @@
 
 std::vector<Neuron*> Cortex::neurons_;
 int Cortex::spike_sum_;
+long Cortex::total_spike_sum_(0);
 int Cortex::spikes_saved_to_file_;
 double Cortex::relative_inhibitory_amplitude_;
 double Cortex::excitatory_amplitude_;
@@ -28,19 +33,77 @@ std::default_random_engine Cortex::generator_;
 std::poisson_distribution<int> Cortex::distribution_; 
 bool Cortex::verbose_(true);
 double Cortex::timestep_;
+Communicator* Cortex::communicator_(nullptr);
+unsigned int Cortex::first_local_neuron_(0);
+unsigned int Cortex::number_of_local_neurons_(12500);
+std::vector<std::vector<short unsigned int> > Cortex::remote_connections_;
+std::vector<std::vector<int> > Cortex::destination_ranks_;
+RankBuffers Cortex::epoch_spikes_;
+std::vector<unsigned int> Cortex::epoch_spike_sums_;
+std::vector<std::vector<unsigned int> > Cortex::remote_spike_queue_;
+unsigned int Cortex::number_of_threads_(1);
+std::vector<int> Cortex::cpus_;
+WorkerPool* Cortex::workers_(nullptr);
+std::vector<unsigned int> Cortex::worker_first_neuron_;
+std::vector<Cortex::Worker*> Cortex::worker_states_;
+thread_local Cortex::Worker* Cortex::current_worker_(nullptr);
+bool Cortex::write_files_(true);
+int Cortex::step_spike_sum_(0);
+bool Cortex::deterministic_(false);
+unsigned long Cortex::seed_(0);
+PoissonSampler Cortex::background_sampler_;
+BackgroundModel Cortex::background_model_(BackgroundModel::poisson);
+double Cortex::shared_fraction_(0.0);
+ExternalDrive* Cortex::drive_(nullptr);
+double Cortex::shared_normal_(0.0);
+std::vector<double> Cortex::background_noise_;
+ActivityMonitor* Cortex::monitor_(nullptr);
+SpikeStatistics* Cortex::statistics_(nullptr);
+PopulationSpectrum* Cortex::spectrum_(nullptr);
+SpikeStoreWriter* Cortex::spike_store_(nullptr);
+NpyRecording* Cortex::npy_recording_(nullptr);
+Multimeter* Cortex::multimeter_(nullptr);
+TelemetryWriter* Cortex::telemetry_(nullptr);
+RecordingPolicy Cortex::recording_;
+int Cortex::sum_step_(0);
+long Cortex::binned_sum_(0);
+std::vector<Population> Cortex::populations_;
+std::vector<unsigned int> Cortex::population_sums_;
+std::vector<unsigned int> Cortex::step_population_sums_;
+std::vector<long> Cortex::binned_population_sums_;
+std::vector<long> Cortex::total_population_sums_;
+bool Cortex::write_population_sums_(false);
+bool Cortex::collect_step_spikes_(false);
+std::vector<unsigned int> Cortex::step_spikes_;
+std::vector<Cortex::SpikeSubscription> Cortex::subscriptions_;
+int Cortex::observed_step_(0);
+std::vector<bool> Cortex::observed_bins_(NUMBER_OF_CHOSEN_NEURONS, false);
 
 Cortex::Cortex(double relative_inhibitory_amplitude, double excitatory_amplitude, unsigned int number_of_neurons, 
 				bool verbose, double time_step, std::poisson_distribution<int> distribution, std::default_random_engine generator)
 {
 	relative_inhibitory_amplitude_ = relative_inhibitory_amplitude;
 	excitatory_amplitude_ = excitatory_amplitude;
-	verbose_ = verbose;
+	// in a distributed simulation, only rank 0 talks to the terminal
+	verbose_ = verbose and is_root();
 	inhibitory_amplitude_ = (- relative_inhibitory_amplitude * excitatory_amplitude);
 	number_of_neurons_ = number_of_neurons;
 	spike_sum_ = 0;
+	total_spike_sum_ = 0;
+	sum_step_ = 0;
+	binned_sum_ = 0;
 	timestep_ = time_step;
+	Neuron::set_time_step(time_step);
 	distribution_ = distribution;
 	generator_ = generator;
+	background_sampler_ = PoissonSampler(distribution.mean());
+	int const rank(communicator_ ? communicator_->get_rank() : 0);
+	int const size(communicator_ ? communicator_->get_size() : 1);
+	first_local_neuron_ = first_neuron_of_rank(rank, size);
+	number_of_local_neurons_ = first_neuron_of_rank(rank + 1, size) - first_local_neuron_;
+	// the inhibitory neurons come first, see initialize_neurons()
+	unsigned int const inhibitory_amount(number_of_neurons * INHIBITORY_PROPORTION);
+	set_populations({Population{"inhibitory", 0, inhibitory_amount}, Population{"excitatory", inhibitory_amount, number_of_neurons}});
 	
 	// empty existing output files
 	reset_output_files();
@@ -48,27 +111,480 @@ Cortex::Cortex(double relative_inhibitory_amplitude, double excitatory_amplitude
 
 void Cortex::update(int t)
 {	
-	for (auto& neuron : neurons_) {
+	step_spikes_.clear();
+	if (drive_ != nullptr) {
+		// the rates of the time step and their tables, before the workers read them
+		drive_->prepare(t, background_model_ == BackgroundModel::poisson);
+	}
+	if (background_model_ == BackgroundModel::shared) {
+		// the same number on every worker and every rank
+		CounterRandom random(seed_, SHARED_NOISE_STREAM, t);
+		shared_normal_ = normal(random);
+	}
+
+	if (workers_ != nullptr) {
+		update_in_parallel(t);
+	} else {
+		add_background_noise(0, neurons_.size(), t, generator_, distribution_, background_noise_);
+
+		if (!collects_crossings()) {
+			update_neurons(0, neurons_.size(), t, nullptr);
+		} else {
+			if (communicator_ != nullptr) {
+				// spikes of other ranks reach their targets on this rank like local ones would
+				deliver_remote_spikes(t);
+			}
+
+			std::vector<unsigned int> crossed;
+			update_neurons(0, neurons_.size(), t, &crossed);
+			for (auto const index : crossed) {
+				record_crossing(index, t);
+			}
+		}
+	}
+
+	if (multimeter_ != nullptr and multimeter_->samples(t)) {
+		multimeter_->sample(t, neurons_);
+	}
+
+	step_spike_sum_ = spike_sum_;
+	step_population_sums_ = population_sums_;
+	if (statistics_ != nullptr) {
+		statistics_->record_step(step_spike_sum_);
+	}
+	if (!subscriptions_.empty()) {
+		publish_step_spikes(t);
+	}
+	if (communicator_ == nullptr) {
+		record_activity(spike_sum_);
+		// write the sum of spikes (from our 12500 neurons) in this timestep into a file
+		write_spike_sum_file();
+		return;
+	}
+
+	// the sum of spikes of the whole network is only known on rank 0 after the exchange
+	epoch_spike_sums_.push_back(spike_sum_);
+	epoch_spike_sums_.insert(epoch_spike_sums_.end(), population_sums_.begin(), population_sums_.end());
+	spike_sum_ = 0;
+	std::fill(population_sums_.begin(), population_sums_.end(), 0);
+	if ((t + 1) % exchange_epoch() == 0) {
+		exchange_spikes();
+	}
+}
+
+void Cortex::update_in_parallel(int t)
+{
+	workers_->run([t](unsigned int worker) { update_worker(worker, t); });
+
+	// gather what the workers recorded, in the order of the neurons
+	for (auto const worker : worker_states_) {
+		spike_sum_ += worker->spike_sum;
+		worker->spike_sum = 0;
+		for (size_t population(0); population < population_sums_.size(); ++population) {
+			population_sums_[population] += worker->population_sums[population];
+			worker->population_sums[population] = 0;
+		}
+		for (bool const spiked : worker->observed_spikes) {
+			save_to_file(spiked);
+		}
+		worker->observed_spikes.clear();
+		for (auto const index : worker->crossed) {
+			record_crossing(index, t);
+		}
+		worker->crossed.clear();
+	}
+
+	if (communicator_ != nullptr) {
+		// the inputs of this time step have all been reset, the remote spikes can be added
+		deliver_remote_spikes(t);
+	}
+}
+
+void Cortex::draw_driven_noise(unsigned int first, unsigned int last, int t, std::default_random_engine& generator, std::vector<double>& noise)
+{
+	unsigned int const count(last - first);
+	unsigned int const offset(first_local_neuron_ + first);
+
+	if (background_model_ == BackgroundModel::poisson) {
+		// the uniform numbers are drawn in bulk, then inverted by the table of the rate of each neuron
+		if (deterministic_) {
+			for (unsigned int i(0); i < count; ++i) {
+				CounterRandom random(seed_, offset + i, t);
+				noise[i] = random.uniform();
+			}
+		} else {
+			std::uniform_real_distribution<double> uniform(0.0, 1.0);
+			for (unsigned int i(0); i < count; ++i) {
+				noise[i] = uniform(generator);
+			}
+		}
+		for (unsigned int i(0); i < count; ++i) {
+			noise[i] = excitatory_amplitude_ * drive_->table(offset + i)(noise[i]);
+		}
+		return;
+	}
+
+	if (deterministic_) {
+		for (unsigned int i(0); i < count; ++i) {
+			CounterRandom random(seed_, offset + i, t);
+			noise[i] = normal(random);
+		}
+	} else {
+		fill_normal(generator, noise, count);
+	}
+	for (unsigned int i(0); i < count; ++i) {
+		double const mean(drive_->mean(offset + i));
+		noise[i] = excitatory_amplitude_ * (mean + std::sqrt(shared_fraction_ * mean) * shared_normal_
+											+ std::sqrt((1.0 - shared_fraction_) * mean) * noise[i]);
+	}
+}
+
+void Cortex::update_worker(unsigned int worker, int t)
+{
+	Worker& state(*worker_states_[worker]);
+	unsigned int const first(worker_first_neuron_[worker]);
+	unsigned int const last(worker_first_neuron_[worker + 1]);
+
+	// nobody reads the spikes of the previous time step anymore
+	state.senders.clear();
+	workers_->clear_tasks(worker);
+
+	// the spikes sent by the neurons of this worker are only collected
+	current_worker_ = &state;
+	add_background_noise(first, last, t, state.generator, state.distribution, state.noise);
+	update_neurons(first, last, t, collects_crossings() ? &state.crossed : nullptr);
+	current_worker_ = nullptr;
+
+	// the delivery of the collected spikes is split into chunks, which idle workers can steal
+	for (unsigned int begin(0); begin < state.senders.size(); begin += DELIVERY_CHUNK_SIZE) {
+		unsigned int const end(std::min<size_t>(begin + DELIVERY_CHUNK_SIZE, state.senders.size()));
+		workers_->push_task(worker, WorkerTask{worker, begin, end});
+	}
+
+	// every spike of this time step has been collected
+	workers_->synchronize();
+
+	WorkerTask task;
+	while (workers_->next_task(worker, task)) {
+		deliver_spikes(task, state.buckets);
+	}
+
+	// every spike of this time step has been delivered
+	workers_->synchronize();
+
+	// the inputs of the neurons of this worker, from the bucket of each worker
+	for (auto const other : worker_states_) {
+		std::vector<Delivery>& bucket(other->buckets[worker]);
+		if (deterministic_) {
+			// integer sums don't depend on the order in which the spikes were added
+			for (auto const& delivery : bucket) {
+				state.fixed_input[delivery.index - first] += std::llround(delivery.amplitude * FIXED_POINT_SCALE);
+			}
+		} else {
+			for (auto const& delivery : bucket) {
+				neurons_[delivery.index]->sum_input(delivery.amplitude);
+			}
+		}
+		bucket.clear();
+	}
+
+	if (deterministic_) {
+		for (unsigned int i(first); i < last; ++i) {
+			if (state.fixed_input[i - first] != 0) {
+				neurons_[i]->sum_input(state.fixed_input[i - first] / FIXED_POINT_SCALE);
+				state.fixed_input[i - first] = 0;
+			}
+		}
+	}
+}
+
+unsigned int Cortex::worker_of(unsigned int index)
+{
+	// worker w owns the neurons from floor(n w / threads) on, see start_workers()
+	unsigned long const threads(workers_->size());
+	return ((index + 1ul) * threads - 1) / neurons_.size();
+}
+
+void Cortex::add_background_noise(unsigned int first, unsigned int last, int t, std::default_random_engine& generator,
+								  std::poisson_distribution<int>& distribution, std::vector<double>& noise)
+{
+	unsigned int const count(last - first);
+	noise.resize(count);
+
+	if (drive_ != nullptr) {
+		draw_driven_noise(first, last, t, generator, noise);
+	} else if (background_model_ == BackgroundModel::poisson) {
+		for (unsigned int i(0); i < count; ++i) {
+			if (deterministic_) {
+				// the noise of a neuron at time t doesn't depend on which worker draws it
+				CounterRandom random(seed_, first_local_neuron_ + first + i, t);
+				noise[i] = excitatory_amplitude_ * background_sampler_(random);
+			} else {
+				noise[i] = excitatory_amplitude_ * distribution(generator);
+			}
+		}
+	} else {
+		// J (lambda + sqrt(lambda) (sqrt(1 - c) z + sqrt(c) z_shared)), same mean and variance as J Poisson(lambda)
+		double const mean(distribution.mean());
+		double const own_deviation(std::sqrt((1.0 - shared_fraction_) * mean));
+		double const shared_input(mean + std::sqrt(shared_fraction_ * mean) * shared_normal_);
+		if (own_deviation == 0.0) {
+			std::fill(noise.begin(), noise.end(), 0.0);
+		} else if (deterministic_) {
+			for (unsigned int i(0); i < count; ++i) {
+				CounterRandom random(seed_, first_local_neuron_ + first + i, t);
+				noise[i] = normal(random);
+			}
+		} else {
+			fill_normal(generator, noise, count);
+		}
+		for (unsigned int i(0); i < count; ++i) {
+			noise[i] = excitatory_amplitude_ * (shared_input + own_deviation * noise[i]);
+		}
+	}
+
+	for (unsigned int i(0); i < count; ++i) {
 		// add background input to the incoming spikes of the neuron
-		neuron->sum_input(excitatory_amplitude_ * distribution_(generator_));
+		neurons_[first + i]->sum_input(noise[i]);
 		// neuron knows it's a new time step, knows to receive spikes sent in the previous timestep
-		neuron->reset_input();
-    }
-    
-    for (auto& neuron : neurons_) {
-		neuron->update(t);
-    }
-	
-	// write the sum of spikes (from our 12500 neurons) in this timestep into a file
-	write_spike_sum_file();
+		neurons_[first + i]->reset_input();
+	}
+}
+
+void Cortex::deliver_spikes(WorkerTask const& task, std::vector<std::vector<Delivery> >& buckets)
+{
+	std::vector<Sender> const& senders(worker_states_[task.owner]->senders);
+	for (unsigned int i(task.begin); i < task.end; ++i) {
+		double const amplitude(senders[i].amplitude);
+		for (auto const index : *senders[i].connection_indexes) {
+			buckets[worker_of(index)].push_back(Delivery{index, amplitude});
+		}
+	}
+}
+
+void Cortex::update_neurons(unsigned int first, unsigned int last, int t, std::vector<unsigned int>* crossed)
+{
+	if (Neuron::has_default_propagators()) {
+		update_neurons<DefaultPropagators>(first, last, t, crossed);
+	} else {
+		update_neurons<RuntimePropagators>(first, last, t, crossed);
+	}
 }
 
-void Cortex::increment_spike_sum() {
-	++spike_sum_;
+template <typename Propagators>
+void Cortex::update_neurons(unsigned int first, unsigned int last, int t, std::vector<unsigned int>* crossed)
+{
+	switch (Neuron::get_model()) {
+		case NeuronModel::lif_delta :
+			update_neurons_with<LifDelta<Propagators> >(first, last, t, crossed);
+			break;
+		case NeuronModel::lif_exponential :
+			update_neurons_with<LifExponential<Propagators> >(first, last, t, crossed);
+			break;
+		case NeuronModel::adaptive_lif :
+			update_neurons_with<AdaptiveLif<Propagators> >(first, last, t, crossed);
+			break;
+	}
+}
+
+template <typename Model>
+void Cortex::update_neurons_with(unsigned int first, unsigned int last, int t, std::vector<unsigned int>* crossed)
+{
+	int& spike_sum(current_worker_ != nullptr ? current_worker_->spike_sum : spike_sum_);
+	std::vector<unsigned int>& population_sums(current_worker_ != nullptr ? current_worker_->population_sums : population_sums_);
+
+	// updates the neurons of [begin, end) and returns the number of spikes they sent
+	auto const update_part = [first, last, t, crossed](unsigned int begin, unsigned int end) {
+		unsigned int sent(0);
+		for (unsigned int i(std::max(begin, first)); i < std::min(end, last); ++i) {
+			sent += neurons_[i]->update_with<Model>(t);
+			if (neurons_[i]->get_last_spike() == t) {
+				if (crossed != nullptr) {
+					crossed->push_back(i);
+				}
+				if (statistics_ != nullptr) {
+					statistics_->record_spike(i, t);
+				}
+			}
+		}
+		return sent;
+	};
+
+	// the populations in local indexes, with the neurons between them, which only count in the sum
+	unsigned int begin(first);
+	for (size_t population(0); population < populations_.size() and begin < last; ++population) {
+		Population const& range(populations_[population]);
+		unsigned int const population_first(std::max(range.first, first_local_neuron_) - first_local_neuron_);
+		unsigned int const population_end(std::max(range.end, first_local_neuron_) - first_local_neuron_);
+		if (begin < population_first) {
+			spike_sum += update_part(begin, population_first);
+			begin = population_first;
+		}
+		if (begin < population_end) {
+			unsigned int const sent(update_part(begin, population_end));
+			spike_sum += sent;
+			population_sums[population] += sent;
+			begin = population_end;
+		}
+	}
+	if (begin < last) {
+		spike_sum += update_part(begin, last);
+	}
+}
+
+void Cortex::record_crossing(unsigned int index, int t)
+{
+	if (collects_step_spikes()) {
+		step_spikes_.push_back(first_local_neuron_ + index);
+	}
+	if (recording_.records_spike(first_local_neuron_ + index, t)) {
+		if (spike_store_ != nullptr) {
+			spike_store_->record(first_local_neuron_ + index, t);
+		}
+		if (npy_recording_ != nullptr) {
+			npy_recording_->record_spike(first_local_neuron_ + index, t);
+		}
+	}
+	if (communicator_ == nullptr) {
+		return;
+	}
+
+	// reached the threshold now: the other ranks need to know before the spike is sent
+	for (auto const rank : destination_ranks_[index]) {
+		epoch_spikes_[rank].push_back(first_local_neuron_ + index);
+		epoch_spikes_[rank].push_back(t);
+	}
+	if (Neuron::is_precise()) {
+		unsigned int const offset(std::min(neurons_[index]->get_spike_offset() * SPIKE_OFFSET_SCALE, SPIKE_OFFSET_SCALE - 1));
+		for (auto const rank : destination_ranks_[index]) {
+			epoch_spikes_[rank].push_back(offset);
+		}
+	}
+}
+
+void Cortex::deliver_remote_spikes(int t)
+{
+	std::vector<unsigned int>& arriving(remote_spike_queue_[t % remote_spike_queue_.size()]);
+	int inhibitory_amount(number_of_neurons_ * INHIBITORY_PROPORTION);
+	for (size_t i(0); i < arriving.size(); i += 2) {
+		unsigned int const index(arriving[i]);
+		double amplitude(index < static_cast<unsigned int>(inhibitory_amount) ? inhibitory_amplitude_ : excitatory_amplitude_);
+		if (arriving[i + 1] != 0) {
+			amplitude *= Neuron::offset_decay(arriving[i + 1] / SPIKE_OFFSET_SCALE);
+		}
+		send_spike(remote_connections_[index], amplitude);
+	}
+	arriving.clear();
+}
+
+void Cortex::exchange_spikes()
+{
+	int const size(communicator_->get_size());
+
+	// to each rank: the number of spike words, the (index, time) pairs, or (index, time, offset) triples with
+	// precise spike times, the number of sums, the sums
+	// (every rank adds up the sums, so that all monitors see the activity of the whole network)
+	RankBuffers outgoing(size), incoming;
+	for (int rank(0); rank < size; ++rank) {
+		std::vector<unsigned int>& buffer(outgoing[rank]);
+		buffer.push_back(epoch_spikes_[rank].size());
+		buffer.insert(buffer.end(), epoch_spikes_[rank].begin(), epoch_spikes_[rank].end());
+		buffer.push_back(epoch_spike_sums_.size());
+		buffer.insert(buffer.end(), epoch_spike_sums_.begin(), epoch_spike_sums_.end());
+		epoch_spikes_[rank].clear();
+	}
+
+	communicator_->exchange(outgoing, incoming);
+
+	std::vector<unsigned int> sums(epoch_spike_sums_.size(), 0);
+	size_t const row_size(1 + populations_.size());
+	bool const precise(Neuron::is_precise());
+	unsigned int const words_per_spike(precise ? 3 : 2);
+	for (int rank(0); rank < size; ++rank) {
+		std::vector<unsigned int> const& buffer(incoming[rank]);
+		unsigned int const spike_words(buffer[0]);
+		if (rank != communicator_->get_rank()) {
+			for (unsigned int i(1); i < spike_words; i += words_per_spike) {
+				// reaches the targets when the sending neuron itself would send it
+				int delivery(buffer[i + 1] + Neuron::get_send_steps());
+				unsigned int arrival_word(0);
+				if (precise) {
+					double arrival_offset(0);
+					Neuron::schedule_spike(buffer[i + 1], buffer[i + 2] / SPIKE_OFFSET_SCALE, delivery, arrival_offset);
+					arrival_word = std::min(arrival_offset * SPIKE_OFFSET_SCALE, SPIKE_OFFSET_SCALE - 1);
+				}
+				std::vector<unsigned int>& queue(remote_spike_queue_[delivery % remote_spike_queue_.size()]);
+				queue.push_back(buffer[i]);
+				queue.push_back(arrival_word);
+			}
+		}
+		unsigned int const sum_count(buffer[spike_words + 1]);
+		for (unsigned int i(0); i < sum_count; ++i) {
+			sums[i] += buffer[spike_words + 2 + i];
+		}
+	}
+	epoch_spike_sums_.clear();
+
+	for (size_t row(0); row < sums.size(); row += row_size) {
+		record_activity(sums[row]);
+		if (is_root()) {
+			spike_sum_ = sums[row];
+			std::copy(sums.begin() + row + 1, sums.begin() + row + row_size, population_sums_.begin());
+			write_spike_sum_file();
+		}
+	}
+}
+
+void Cortex::abort_ranks()
+{
+	if (communicator_ != nullptr) {
+		communicator_->abort();
+		// the communicator of rank 0 waits for the other ranks, which throw as well
+		delete communicator_;
+		communicator_ = nullptr;
+		first_local_neuron_ = 0;
+		number_of_local_neurons_ = number_of_neurons_;
+	}
+}
+
+void Cortex::finish()
+{
+	if (communicator_ != nullptr) {
+		// the last epoch may be shorter than the others, gather what is left
+		exchange_spikes();
+
+		// the communicator of rank 0 waits for the other ranks to finish
+		delete communicator_;
+		communicator_ = nullptr;
+		first_local_neuron_ = 0;
+		number_of_local_neurons_ = number_of_neurons_;
+	}
+	if (spike_store_ != nullptr) {
+		spike_store_->close();
+	}
+	if (npy_recording_ != nullptr) {
+		npy_recording_->close();
+	}
+	if (multimeter_ != nullptr) {
+		multimeter_->close();
+	}
+	if (telemetry_ != nullptr) {
+		telemetry_->finish();
+	}
+	for (auto& subscription : subscriptions_) {
+		flush_subscription(subscription);
+		subscription.subscriber->on_finish();
+	}
 }
 
 void Cortex::send_spike(std::vector<short unsigned int> const& connection_indexes, double amplitude)
 {
+	if (current_worker_ != nullptr) {
+		// other workers may be updating the targets, the spike is delivered after the update phase
+		current_worker_->senders.push_back(Sender{&connection_indexes, amplitude});
+		return;
+	}
+
 	// sends a spike to all neurons with indexes inside connection_indexes
 	for (auto const index : connection_indexes) {
 		neurons_[index]->sum_input(amplitude);
@@ -77,6 +593,15 @@ void Cortex::send_spike(std::vector<short unsigned int> const& connection_indexe
 
 void Cortex::initialize_neurons()
 {
+	if (communicator_ != nullptr) {
+		if (exchange_epoch() < 1) {
+			throw std::runtime_error("the ranks need a transmission delay of at least three time steps to exchange precise spikes");
+		}
+		remote_connections_.assign(number_of_neurons_, std::vector<short unsigned int>());
+		epoch_spikes_.assign(communicator_->get_size(), std::vector<unsigned int>());
+		remote_spike_queue_.assign(Neuron::get_delay_steps(), std::vector<unsigned int>());
+	}
+
 	// Check that the amplitudes have been initialized correctly
 	assert(inhibitory_amplitude_ <= 0.0);
 	assert(excitatory_amplitude_ >= 0.0);
@@ -86,6 +611,8 @@ void Cortex::initialize_neurons()
 	// creating their lists of connections at the same time
 
 	std::vector<short unsigned int> connection_indexes;
+	// ranks on which the current neuron has targets
+	std::vector<bool> reached_ranks(communicator_ ? communicator_->get_size() : 1);
 	// select indices with a certain connection probability
 	std::default_random_engine generator;
 	std::bernoulli_distribution distribution(CONNECTION_PROBABILITY);
@@ -100,16 +627,33 @@ void Cortex::initialize_neurons()
 	int inhibitory_amount(number_of_neurons_ * INHIBITORY_PROPORTION);
 	
 	for (short unsigned int i(0); i < inhibitory_amount; ++i) {
+		bool const source_is_local(is_local(i));
 
 		for (short unsigned int j(0); j < number_of_neurons_ ; ++j) {
 
 			if (distribution(generator) and (j != i)) { // can't have connection to itself
-				// add connection to other neuron with a certain probability
-				connection_indexes.push_back(j);
+				// add connection to other neuron with a certain probability,
+				// but only keep the targets simulated by this rank
+				if (is_local(j)) {
+					connection_indexes.push_back(j - first_local_neuron_);
+				}
+				if (source_is_local and communicator_ != nullptr) {
+					reached_ranks[rank_of(j)] = true;
+				}
+			}
+		}
+
+		if (source_is_local and communicator_ != nullptr) {
+			destination_ranks_.push_back(std::vector<int>());
+			for (size_t rank(0); rank < reached_ranks.size(); ++rank) {
+				if (reached_ranks[rank] and static_cast<int>(rank) != communicator_->get_rank()) {
+					destination_ranks_.back().push_back(rank);
+				}
 			}
+			std::fill(reached_ranks.begin(), reached_ranks.end(), false);
 		}
 
-		neurons_.push_back(new Neuron(inhibitory_amplitude_, connection_indexes));
+		add_neuron(i, inhibitory_amplitude_, connection_indexes);
 
 		connection_indexes.clear();
 	}
@@ -128,15 +672,32 @@ void Cortex::initialize_neurons()
     double excitatory_amount(number_of_neurons_ * (1.0 - INHIBITORY_PROPORTION));
 
 	for (short unsigned int i(0) ; i < excitatory_amount ; ++i) {
+		unsigned int const index(inhibitory_amount + i);
+		bool const source_is_local(is_local(index));
 
 		for(short unsigned int j(0); j < number_of_neurons_ ; ++j) {
 
 			if (distribution(generator) and (j != i)) { // can't have connection to itself
-				connection_indexes.push_back(j);
+				if (is_local(j)) {
+					connection_indexes.push_back(j - first_local_neuron_);
+				}
+				if (source_is_local and communicator_ != nullptr) {
+					reached_ranks[rank_of(j)] = true;
+				}
 			}
 		}
 
-		neurons_.push_back(new Neuron(excitatory_amplitude_, connection_indexes));
+		if (source_is_local and communicator_ != nullptr) {
+			destination_ranks_.push_back(std::vector<int>());
+			for (size_t rank(0); rank < reached_ranks.size(); ++rank) {
+				if (reached_ranks[rank] and static_cast<int>(rank) != communicator_->get_rank()) {
+					destination_ranks_.back().push_back(rank);
+				}
+			}
+			std::fill(reached_ranks.begin(), reached_ranks.end(), false);
+		}
+
+		add_neuron(index, excitatory_amplitude_, connection_indexes);
 
 		connection_indexes.clear();
 		
@@ -147,8 +708,102 @@ void Cortex::initialize_neurons()
 		std::cout << BOLD << "  COMPLETE" << RESET << std::endl;
 	}
 	
-	// choose 50 random neurons to track
-	Cortex::choose_50_random_neurons();
+	// choose 50 random neurons to track, rank 0 is the one writing them to the file
+	if (is_root()) {
+		Cortex::choose_50_random_neurons();
+	}
+
+	if (statistics_ != nullptr) {
+		statistics_->start(neurons_.size());
+	}
+	if (multimeter_ != nullptr and multimeter_->neurons().back() >= neurons_.size()) {
+		throw std::runtime_error("the neuron " + std::to_string(multimeter_->neurons().back()) + " sampled by the multimeter isn't simulated by rank 0");
+	}
+
+	// a deterministic simulation always takes the multithreaded path, even with one thread,
+	// so that its results don't depend on the number of threads
+	if (number_of_threads_ > 1 or deterministic_) {
+		start_workers();
+	}
+}
+
+void Cortex::start_workers()
+{
+	unsigned int const threads(std::min<size_t>(number_of_threads_, neurons_.size()));
+	workers_ = new WorkerPool(threads, cpus_);
+
+	// contiguous ranges of neurons of (almost) equal size
+	worker_first_neuron_.clear();
+	for (unsigned int worker(0); worker <= threads; ++worker) {
+		worker_first_neuron_.push_back(static_cast<unsigned long>(neurons_.size()) * worker / threads);
+	}
+
+	// every worker draws its own background noise
+	std::vector<unsigned int> seeds;
+	for (unsigned int worker(0); worker < threads; ++worker) {
+		seeds.push_back(generator_());
+	}
+
+	worker_states_.assign(threads, nullptr);
+	workers_->run([&seeds](unsigned int worker) {
+		// the worker allocates and touches first what it owns, so that it is placed on its NUMA node
+		Worker* state = new Worker;
+		// the buckets keep their capacity from step to step, the pages stay where this worker touched them
+		state->buckets.resize(worker_first_neuron_.size() - 1);
+		for (auto& bucket : state->buckets) {
+			bucket.resize(DELIVERY_BUCKET_SIZE);
+			bucket.clear();
+		}
+		if (deterministic_) {
+			state->fixed_input.assign(worker_first_neuron_[worker + 1] - worker_first_neuron_[worker], 0);
+		}
+		state->generator.seed(seeds[worker]);
+		state->distribution = distribution_;
+		state->spike_sum = 0;
+		state->population_sums.assign(populations_.size(), 0);
+		worker_states_[worker] = state;
+
+		for (unsigned int i(worker_first_neuron_[worker]); i < worker_first_neuron_[worker + 1]; ++i) {
+			Neuron* moved = new Neuron(*neurons_[i]);
+			delete neurons_[i];
+			neurons_[i] = moved;
+		}
+	});
+
+	if (verbose_) {
+		report_placement();
+	}
+}
+
+void Cortex::report_placement()
+{
+	std::cout << "Memory placement of the " << workers_->size() << " workers:" << std::endl;
+	for (unsigned int worker(0); worker < workers_->size(); ++worker) {
+		unsigned int const first(worker_first_neuron_[worker]);
+		unsigned int const last(worker_first_neuron_[worker + 1]);
+		int const cpu(workers_->cpu_of(worker));
+
+		std::cout << "     worker " << std::setw(3) << worker
+				  << "  neurons " << std::setw(5) << first_local_neuron_ + first << "-" << std::setw(5) << first_local_neuron_ + last - 1
+				  << "  cpu " << std::setw(3);
+		if (cpu >= 0) {
+			std::cout << cpu << " (node " << node_of_cpu(cpu) << ")";
+		} else {
+			std::cout << "any";
+		}
+		Worker const& state(*worker_states_[worker]);
+		std::cout << "  state on node " << node_of_address(neurons_[first])
+				  << ", buckets on node " << node_of_address(state.buckets[0].data()) << std::endl;
+	}
+}
+
+void Cortex::add_neuron(unsigned int index, double amplitude, std::vector<short unsigned int> const& connection_indexes)
+{
+	if (is_local(index)) {
+		neurons_.push_back(new Neuron(amplitude, connection_indexes, communicator_ != nullptr));
+	} else if (!connection_indexes.empty()) {
+		remote_connections_[index] = connection_indexes;
+	}
 }
 
 void Cortex::reset()
@@ -159,10 +814,79 @@ void Cortex::reset()
 		neuron = nullptr;
 	}
 	neurons_.clear();
+
+	remote_connections_.clear();
+	destination_ranks_.clear();
+	epoch_spikes_.clear();
+	epoch_spike_sums_.clear();
+	remote_spike_queue_.clear();
+
+	delete workers_;
+	workers_ = nullptr;
+	for (auto& worker : worker_states_) {
+		delete worker;
+	}
+	worker_states_.clear();
+	worker_first_neuron_.clear();
+
+	delete monitor_;
+	monitor_ = nullptr;
+	delete statistics_;
+	statistics_ = nullptr;
+	delete spectrum_;
+	spectrum_ = nullptr;
+	delete spike_store_;
+	spike_store_ = nullptr;
+	delete npy_recording_;
+	npy_recording_ = nullptr;
+	delete multimeter_;
+	multimeter_ = nullptr;
+	delete telemetry_;
+	telemetry_ = nullptr;
+	step_spikes_.clear();
+	delete drive_;
+	drive_ = nullptr;
+	for (auto& subscription : subscriptions_) {
+		delete subscription.subscriber;
+	}
+	subscriptions_.clear();
 }
 
 void Cortex::write_spike_sum_file ()
 {
+	total_spike_sum_ += spike_sum_;
+	for (size_t population(0); population < population_sums_.size(); ++population) {
+		total_population_sums_[population] += population_sums_[population];
+	}
+	if (telemetry_ != nullptr) {
+		telemetry_->publish(sum_step_, spike_sum_, population_sums_);
+	}
+	RecordingAction const action(recording_.action(sum_step_));
+	++sum_step_;
+	if (action != RecordingAction::skip) {
+		binned_sum_ += spike_sum_;
+		for (size_t population(0); population < population_sums_.size(); ++population) {
+			binned_population_sums_[population] += population_sums_[population];
+		}
+	}
+	std::fill(population_sums_.begin(), population_sums_.end(), 0);
+	if (action != RecordingAction::write) {
+		spike_sum_ = 0;
+		return;
+	}
+	long const sum(binned_sum_);
+	binned_sum_ = 0;
+	std::vector<long> const population_sums(write_population_sums_ ? binned_population_sums_ : std::vector<long>());
+	std::fill(binned_population_sums_.begin(), binned_population_sums_.end(), 0);
+
+	if (npy_recording_ != nullptr) {
+		npy_recording_->record_sum(sum, population_sums);
+	}
+	if (!write_files_) {
+		spike_sum_ = 0;
+		return;
+	}
+
     std::ofstream output_file(SPIKE_SUM_FILE, std::ofstream::out | std::ofstream::app);
 
     if (output_file.fail()) {
@@ -170,7 +894,11 @@ void Cortex::write_spike_sum_file ()
 		std::string file_name(SPIKE_SUM_FILE);
         throw std::runtime_error("file " + file_name + " couldn't be opened");
     } else {
-			output_file << spike_sum_ << std::endl;
+			output_file << sum;
+			for (auto const population_sum : population_sums) {
+				output_file << " " << population_sum;
+			}
+			output_file << std::endl;
     }
     output_file.close();
     
@@ -180,6 +908,37 @@ void Cortex::write_spike_sum_file ()
 
 void Cortex::save_to_file(bool spiked)
 {
+	if (current_worker_ != nullptr) {
+		// written once all workers are done, so that the columns keep the order of the neurons
+		current_worker_->observed_spikes.push_back(spiked);
+		return;
+	}
+
+	// one call per observed neuron and time step, a row of the file per recorded time step or bin
+	unsigned int const column(spikes_saved_to_file_);
+	RecordingAction const action(recording_.action(observed_step_));
+	if (action != RecordingAction::skip and spiked) {
+		observed_bins_[column] = true;
+	}
+	++spikes_saved_to_file_;
+	bool const row_complete(spikes_saved_to_file_ >= static_cast<int>(observed_bins_.size()));
+	if (row_complete) {
+		spikes_saved_to_file_ = 0;
+		++observed_step_;
+	}
+	if (action != RecordingAction::write) {
+		return;
+	}
+	spiked = observed_bins_[column];
+	observed_bins_[column] = false;
+
+	if (npy_recording_ != nullptr) {
+		npy_recording_->record_observed(spiked);
+	}
+	if (!write_files_) {
+		return;
+	}
+
 	std::ofstream output_file(SPIKE_DETAIL_FILE, std::ofstream::out | std::ofstream::app);
 
     if (output_file.fail()) {
@@ -194,12 +953,10 @@ void Cortex::save_to_file(bool spiked)
 		// the neuron didn't spike --> write 0
 		output_file << "0 ";
     }
-    ++spikes_saved_to_file_;
 
-    if (spikes_saved_to_file_ >= 50) {
+    if (row_complete) {
 		// the spikes from this time step have been written into the file
 		output_file << std::endl;
-		spikes_saved_to_file_ = 0;
 	}
 
     output_file.close();
@@ -207,6 +964,10 @@ void Cortex::save_to_file(bool spiked)
 
 void Cortex::reset_output_files()
 {
+	if (!is_root() or !write_files_) {
+		return;
+	}
+
 	// erase the content of the two output files
 	
 	std::ofstream overwrite_sums;
@@ -222,11 +983,31 @@ void Cortex::reset_output_files()
 
 void Cortex::choose_50_random_neurons() {
 	
+	spikes_saved_to_file_ = 0;
+	observed_step_ = 0;
+	std::vector<unsigned int> const& listed(recording_.neurons());
+	if (!listed.empty()) {
+		// the neurons to record were listed, they are the observed ones
+		if (listed.back() >= neurons_.size()) {
+			throw std::runtime_error("the recorded neuron " + std::to_string(listed.back()) + " isn't simulated by rank 0");
+		}
+		for (auto const index : listed) {
+			neurons_[index]->set_observed(true);
+		}
+		observed_bins_.assign(listed.size(), false);
+		return;
+	}
+	observed_bins_.assign(std::min<size_t>(NUMBER_OF_CHOSEN_NEURONS, neurons_.size()), false);
+
+	// the same neurons are observed in every deterministic run with the same seed
 	unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
+	if (deterministic_) {
+		seed = seed_;
+	}
 	std::default_random_engine generator(seed);
 	
-	std::uniform_int_distribution<> distribution(0, number_of_neurons_ - 1);
-	spikes_saved_to_file_ = 0;
+	// in a distributed simulation, only the neurons of rank 0 can be chosen
+	std::uniform_int_distribution<> distribution(0, neurons_.size() - 1);
 	int n(0);
 	int index;
 	
@@ -238,7 +1019,7 @@ void Cortex::choose_50_random_neurons() {
 				++n;
 		}
 
-	} while (n < NUMBER_OF_CHOSEN_NEURONS);
+	} while (n < NUMBER_OF_CHOSEN_NEURONS and n < static_cast<int>(neurons_.size()));
 }
 
 void Cortex::set_spike_sum (int nbr)
@@ -259,3 +1040,328 @@ Cortex::~Cortex()
 double Cortex::get_excitatory_amplitude(){
 	return excitatory_amplitude_;
 }
+
+void Cortex::set_communicator(Communicator* communicator)
+{
+	communicator_ = communicator;
+}
+
+bool Cortex::is_root()
+{
+	return communicator_ == nullptr or communicator_->get_rank() == 0;
+}
+
+unsigned int Cortex::first_neuron_of_rank(int rank, int size)
+{
+	// contiguous blocks of (almost) equal size
+	return static_cast<unsigned long>(number_of_neurons_) * rank / size;
+}
+
+bool Cortex::is_local(unsigned int neuron)
+{
+	return neuron >= first_local_neuron_ and neuron - first_local_neuron_ < number_of_local_neurons_;
+}
+
+int Cortex::rank_of(unsigned int neuron)
+{
+	int const size(communicator_->get_size());
+	// first rank whose block starts after the neuron, minus one
+	int rank((static_cast<unsigned long>(neuron) * size) / number_of_neurons_);
+	while (rank + 1 < size and first_neuron_of_rank(rank + 1, size) <= neuron) {
+		++rank;
+	}
+	while (first_neuron_of_rank(rank, size) > neuron) {
+		--rank;
+	}
+	return rank;
+}
+
+int Cortex::exchange_epoch()
+{
+	return Neuron::get_send_steps();
+}
+
+void Cortex::set_threads(unsigned int threads, std::vector<int> const& cpus)
+{
+	assert(threads > 0);
+	number_of_threads_ = threads;
+	cpus_ = cpus;
+}
+
+void Cortex::set_deterministic(bool deterministic, unsigned long seed)
+{
+	deterministic_ = deterministic;
+	seed_ = seed;
+}
+
+void Cortex::set_monitor(ActivityMonitor* monitor)
+{
+	delete monitor_;
+	monitor_ = monitor;
+}
+
+ActivityMonitor const* Cortex::get_monitor()
+{
+	return monitor_;
+}
+
+ActivityStatus Cortex::get_activity_status()
+{
+	return monitor_ != nullptr ? monitor_->status() : ActivityStatus::running;
+}
+
+void Cortex::set_statistics(SpikeStatistics* statistics)
+{
+	delete statistics_;
+	statistics_ = statistics;
+}
+
+SpikeStatistics const* Cortex::get_statistics()
+{
+	return statistics_;
+}
+
+void Cortex::set_spectrum(PopulationSpectrum* spectrum)
+{
+	delete spectrum_;
+	spectrum_ = spectrum;
+}
+
+PopulationSpectrum const* Cortex::get_spectrum()
+{
+	return spectrum_;
+}
+
+void Cortex::set_spike_store(SpikeStoreWriter* spike_store)
+{
+	delete spike_store_;
+	spike_store_ = spike_store;
+}
+
+SpikeStoreWriter const* Cortex::get_spike_store()
+{
+	return spike_store_;
+}
+
+void Cortex::set_npy_recording(NpyRecording* npy_recording)
+{
+	delete npy_recording_;
+	npy_recording_ = npy_recording;
+}
+
+NpyRecording const* Cortex::get_npy_recording()
+{
+	return npy_recording_;
+}
+
+void Cortex::set_multimeter(Multimeter* multimeter)
+{
+	delete multimeter_;
+	multimeter_ = multimeter;
+}
+
+Multimeter const* Cortex::get_multimeter()
+{
+	return multimeter_;
+}
+
+void Cortex::set_telemetry(TelemetryWriter* telemetry)
+{
+	delete telemetry_;
+	telemetry_ = telemetry;
+}
+
+TelemetryWriter const* Cortex::get_telemetry()
+{
+	return telemetry_;
+}
+
+void Cortex::set_recording(RecordingPolicy const& recording)
+{
+	recording_ = recording;
+}
+
+RecordingPolicy const& Cortex::get_recording()
+{
+	return recording_;
+}
+
+bool Cortex::collects_crossings()
+{
+	return communicator_ != nullptr or spike_store_ != nullptr or npy_recording_ != nullptr or collects_step_spikes();
+}
+
+bool Cortex::collects_step_spikes()
+{
+	return collect_step_spikes_ or !subscriptions_.empty();
+}
+
+void Cortex::record_activity(int spikes)
+{
+	if (monitor_ != nullptr) {
+		monitor_->record(spikes);
+	}
+	if (spectrum_ != nullptr) {
+		spectrum_->record(spikes);
+	}
+}
+
+void Cortex::set_background(BackgroundModel model, double shared_fraction)
+{
+	if (shared_fraction < 0.0 or shared_fraction > 1.0) {
+		throw std::runtime_error("the shared fraction of the background noise has to be between 0 and 1");
+	}
+	background_model_ = model;
+	shared_fraction_ = (model == BackgroundModel::shared) ? shared_fraction : 0.0;
+	shared_normal_ = 0.0;
+}
+
+void Cortex::set_drive(ExternalDrive* drive)
+{
+	delete drive_;
+	drive_ = drive;
+}
+
+void Cortex::set_write_files(bool write_files)
+{
+	write_files_ = write_files;
+}
+
+unsigned int Cortex::get_number_of_local_neurons()
+{
+	return neurons_.size();
+}
+
+Neuron const& Cortex::get_local_neuron(unsigned int index)
+{
+	assert(index < neurons_.size());
+	return *neurons_[index];
+}
+
+int Cortex::get_step_spike_sum()
+{
+	return step_spike_sum_;
+}
+
+long Cortex::get_total_spike_sum()
+{
+	return total_spike_sum_;
+}
+
+void Cortex::set_populations(std::vector<Population> const& populations)
+{
+	unsigned int end(0);
+	for (auto const& population : populations) {
+		if (population.first < end or population.end <= population.first or population.end > number_of_neurons_) {
+			throw std::runtime_error("the population " + population.name + " has to be a non-empty range of neurons after the previous population");
+		}
+		end = population.end;
+	}
+	populations_ = populations;
+	population_sums_.assign(populations.size(), 0);
+	step_population_sums_.assign(populations.size(), 0);
+	binned_population_sums_.assign(populations.size(), 0);
+	total_population_sums_.assign(populations.size(), 0);
+}
+
+std::vector<Population> const& Cortex::get_populations()
+{
+	return populations_;
+}
+
+std::vector<unsigned int> const& Cortex::get_step_population_sums()
+{
+	return step_population_sums_;
+}
+
+std::vector<long> const& Cortex::get_total_population_sums()
+{
+	return total_population_sums_;
+}
+
+void Cortex::set_collect_step_spikes(bool collect)
+{
+	collect_step_spikes_ = collect;
+}
+
+std::vector<unsigned int> const& Cortex::get_step_spikes()
+{
+	return step_spikes_;
+}
+
+void Cortex::add_spike_subscriber(SpikeSubscriber* subscriber, int batch_steps)
+{
+	if (batch_steps < 1) {
+		delete subscriber;
+		throw std::runtime_error("a batch of spikes has to span at least one time step");
+	}
+	subscriptions_.push_back(SpikeSubscription{subscriber, batch_steps, -1, {}, {0}});
+}
+
+void Cortex::publish_step_spikes(int t)
+{
+	for (auto& subscription : subscriptions_) {
+		if (subscription.batch_steps == 1) {
+			// a view of step_spikes_, without a copy
+			unsigned int const offsets[2] = {0, static_cast<unsigned int>(step_spikes_.size())};
+			subscription.subscriber->on_spikes(SpikeSpan{t, 1, step_spikes_.data(), offsets});
+			continue;
+		}
+		if (subscription.first_step < 0) {
+			subscription.first_step = t;
+		}
+		subscription.neurons.insert(subscription.neurons.end(), step_spikes_.begin(), step_spikes_.end());
+		subscription.offsets.push_back(subscription.neurons.size());
+		if (static_cast<int>(subscription.offsets.size()) > subscription.batch_steps) {
+			flush_subscription(subscription);
+		}
+	}
+}
+
+void Cortex::flush_subscription(SpikeSubscription& subscription)
+{
+	if (subscription.first_step < 0) {
+		return;
+	}
+	int const steps(subscription.offsets.size() - 1);
+	subscription.subscriber->on_spikes(SpikeSpan{subscription.first_step, steps, subscription.neurons.data(), subscription.offsets.data()});
+	// the buffers keep their capacity for the next batch
+	subscription.first_step = -1;
+	subscription.neurons.clear();
+	subscription.offsets.resize(1);
+}
+
+void Cortex::set_write_population_sums(bool write_population_sums)
+{
+	write_population_sums_ = write_population_sums;
+}
+
+bool Cortex::writes_population_sums()
+{
+	return write_population_sums_;
+}
+
+unsigned int Cortex::get_number_of_neurons()
+{
+	return number_of_neurons_;
+}
+
+uint64_t Cortex::state_hash()
+{
+	uint64_t hash(14695981039346656037ULL);
+	auto const mix = [&hash](void const* data, size_t size) {
+		unsigned char const* bytes(static_cast<unsigned char const*>(data));
+		for (size_t i(0); i < size; ++i) {
+			hash = (hash ^ bytes[i]) * 1099511628211ULL;
+		}
+	};
+
+	for (auto const neuron : neurons_) {
+		double const values[6] = {neuron->get_potential(), neuron->get_current_input(), neuron->get_next_input(),
+								  neuron->get_synaptic_current(), neuron->get_adaptation(), neuron->get_spike_offset()};
+		int const last_spike(neuron->get_last_spike());
+		mix(values, sizeof(values));
+		mix(&last_spike, sizeof(last_spike));
+	}
+	return hash;
+}
@@ -15,7 +15,23 @@
 #include <memory>
 #include <fstream>
 #include <random>
+#include <cstdint>
 #include "Neuron.hpp"
+#include "Communicator.hpp"
+#include "WorkerPool.hpp"
+#include "CounterRandom.hpp"
+#include "BackgroundNoise.hpp"
+#include "ActivityMonitor.hpp"
+#include "SpikeStatistics.hpp"
+#include "PopulationSpectrum.hpp"
+#include "SpikeStore.hpp"
+#include "NpyExport.hpp"
+#include "RecordingPolicy.hpp"
+#include "Multimeter.hpp"
+#include "Telemetry.hpp"
+#include "Population.hpp"
+#include "SpikeSubscriber.hpp"
+#include "Stimulus.hpp"
 
 #ifdef TEST
 #include <gtest/gtest_prod.h>
@@ -30,6 +46,18 @@ constexpr double CONNECTION_PROBABILITY (0.1);
 /*! Number of neurons chosen randomly to be observed during the simulation */
 constexpr double NUMBER_OF_CHOSEN_NEURONS(50);
 
+/*! Number of spiking neurons whose spikes are delivered by one task of a multithreaded simulation */
+constexpr unsigned int DELIVERY_CHUNK_SIZE(8);
+
+/*! Number of inputs each bucket of a worker has room for from the start, see Cortex::Worker */
+constexpr unsigned int DELIVERY_BUCKET_SIZE(4096);
+
+/*! Number of fixed-point units per mV of input in a deterministic simulation */
+constexpr double FIXED_POINT_SCALE(4294967296.0);
+
+/*! Number of fixed-point units per time step of the spike offsets sent to other ranks */
+constexpr double SPIKE_OFFSET_SCALE(4294967296.0);
+
 class Cortex
 {
 	private:
@@ -38,13 +66,18 @@ class Cortex
         	#ifdef TEST
 		FRIEND_TEST(Cortex_Test, initialize_cortex);
 		FRIEND_TEST(Cortex_Test, update);
-		FRIEND_TEST(Cortex_Test, increment_spike_sum);
 		FRIEND_TEST(Cortex_Test, send_spike);
 		FRIEND_TEST(Cortex_Test, initialize_neuron_types);
 		FRIEND_TEST(Cortex_Test, choose_50_random_neurons);
 		FRIEND_TEST(Cortex_Test, save_to_file);
 		FRIEND_TEST(Cortex_Test, write_spike_sum_file);
 		FRIEND_TEST(Cortex_Test, reset_neurons);
+		FRIEND_TEST(Cortex_Test, domain_decomposition);
+		FRIEND_TEST(Cortex_Test, update_in_parallel);
+		FRIEND_TEST(Cortex_Test, deterministic_update);
+		FRIEND_TEST(Cortex_Test, background_noise);
+		FRIEND_TEST(Cortex_Test, population_sums);
+		FRIEND_TEST(Cortex_Test, external_drive);
        		#endif
 
 		/*! \brief Pointers to all Neurons */
@@ -56,6 +89,9 @@ class Cortex
 		/*! \brief Number of total spikes of the current time t */
 		static int spike_sum_;
 
+		/*! \brief Number of spikes of the whole network since the construction, known on rank 0 */
+		static long total_spike_sum_;
+
 		/*! \brief Number of times that observed neurons have called save_to_file in the current timestep */
 		static int spikes_saved_to_file_;
 
@@ -90,7 +126,295 @@ class Cortex
 		 * 	\details This file is an attribute of the Cortex 
 		 */
 		static std::ofstream outputFile;
+
+		/*! \brief Communicator to the other ranks, null when the simulation runs in a single process */
+		static Communicator* communicator_;
+
+		/*! \brief Global index of the first neuron simulated by this rank
+		 *  \details The neurons of neurons_ are the neurons first_local_neuron_ to first_local_neuron_ + neurons_.size() - 1
+		 *  \details and connection indexes are relative to first_local_neuron_.
+		 */
+		static unsigned int first_local_neuron_;
+
+		/*! \brief Number of neurons simulated by this rank */
+		static unsigned int number_of_local_neurons_;
+
+		/*! \brief Local targets of the neurons simulated by other ranks, indexed by global neuron index */
+		static std::vector<std::vector<short unsigned int> > remote_connections_;
+
+		/*! \brief Ranks on which each local neuron has targets, indexed by local neuron index */
+		static std::vector<std::vector<int> > destination_ranks_;
+
+		/*! \brief Spikes of the local neurons during the current epoch, as (global index, time, offset) triples per destination rank */
+		static RankBuffers epoch_spikes_;
+
+		/*! \brief Local spike sums of the time steps of the current epoch, waiting to be gathered on rank 0
+		 *  \details One row per time step, the sum of all neurons followed by the sum of each population.
+		 */
+		static std::vector<unsigned int> epoch_spike_sums_;
+
+		/*! \brief Spikes received from other ranks as (global index, arrival offset) pairs, by time step of delivery modulo the transmission delay
+		 *  \details The arrival offset, in SPIKE_OFFSET_SCALE units, is 0 unless the spike times are precise, see Neuron::schedule_spike().
+		 */
+		static std::vector<std::vector<unsigned int> > remote_spike_queue_;
+
+		/*! \brief Whether a neuron with the given global index is simulated by this rank */
+		static bool is_local(unsigned int neuron);
+
+		/*! \brief Returns the rank simulating the neuron with the given global index */
+		static int rank_of(unsigned int neuron);
+
+		/*! \brief Stores a neuron in the Cortex if it's local, or keeps its local targets otherwise.
+		 * @param[in] index the global index of the neuron
+		 * @param[in] amplitude the amplitude of the spikes the neuron sends
+		 * @param[in] connection_indexes the local targets of the neuron
+		 */
+		static void add_neuron(unsigned int index, double amplitude, std::vector<short unsigned int> const& connection_indexes);
+
+		/*! \brief Delivers the spikes of other ranks which reach their local targets at time t */
+		static void deliver_remote_spikes(int t);
+
+		/*! \brief Exchanges the spikes and spike sums of the current epoch with the other ranks
+		 *  \details Rank 0 writes the gathered spike sums into the output file.
+		 */
+		static void exchange_spikes();
 		
+		/*! \brief Spike waiting to be delivered in a multithreaded simulation */
+		struct Sender
+		{
+			/*! \brief The targets of the spiking neuron */
+			std::vector<short unsigned int> const* connection_indexes;
+
+			/*! \brief The amplitude of the spike */
+			double amplitude;
+		};
+
+		/*! \brief Input delivered to a local neuron in a multithreaded simulation */
+		struct Delivery
+		{
+			unsigned int index;
+			double amplitude;
+		};
+
+		/*! \brief State private to one worker of a multithreaded simulation
+		 *  \details Allocated by the worker itself, so that it lives on the worker's NUMA node.
+		 */
+		struct Worker
+		{
+			/*! \brief Inputs delivered by this worker in the current time step, in one bucket per worker owning their targets
+			 *  \details Filled by this worker, on its node, and read once by the owners, which only touch their own neurons.
+			 */
+			std::vector<std::vector<Delivery> > buckets;
+
+			/*! \brief Input of each neuron of this worker in fixed-point units, summed from the buckets in deterministic simulations */
+			std::vector<long long> fixed_input;
+
+			/*! \brief Spikes sent by the neurons of this worker in the current time step */
+			std::vector<Sender> senders;
+
+			/*! \brief Generator of the background noise of the neurons of this worker */
+			std::default_random_engine generator;
+
+			/*! \brief Distribution of the background noise, see distribution_ */
+			std::poisson_distribution<int> distribution;
+
+			/*! \brief Background input of the neurons of this worker in the current time step */
+			std::vector<double> noise;
+
+			/*! \brief Number of spikes sent by the neurons of this worker in the current time step */
+			int spike_sum;
+
+			/*! \brief Same as spike_sum, for each population */
+			std::vector<unsigned int> population_sums;
+
+			/*! \brief Whether each observed neuron of this worker spiked in the current time step, in neuron order */
+			std::vector<bool> observed_spikes;
+
+			/*! \brief Local neurons of this worker which reached the threshold in the current time step */
+			std::vector<unsigned int> crossed;
+		};
+
+		/*! \brief Number of threads simulating the neurons of this process */
+		static unsigned int number_of_threads_;
+
+		/*! \brief CPUs the worker threads are pinned to, none if empty */
+		static std::vector<int> cpus_;
+
+		/*! \brief Worker threads, null when the simulation runs in a single thread */
+		static WorkerPool* workers_;
+
+		/*! \brief Local index of the first neuron owned by each worker, followed by the number of local neurons */
+		static std::vector<unsigned int> worker_first_neuron_;
+
+		/*! \brief State of each worker */
+		static std::vector<Worker*> worker_states_;
+
+		/*! \brief State of the worker running on the calling thread, null outside of the update phase of a worker */
+		static thread_local Worker* current_worker_;
+
+		/*! \brief Starts the worker threads and hands each of them its range of neurons
+		 *  \details Each worker copies the state and connections of its neurons, so that it touches them first.
+		 */
+		static void start_workers();
+
+		/*! \brief Prints on which CPU and NUMA node each worker and its data ended up */
+		static void report_placement();
+
+		/*! \brief Multithreaded version of the update of the neurons for time t */
+		static void update_in_parallel(int t);
+
+		/*! \brief Update of the neurons of one worker for time t
+		 *  \details The neurons are updated first and their spikes collected in chunks of DELIVERY_CHUNK_SIZE.
+		 *  \details All workers then sort the inputs of the chunks into buckets by the worker owning their targets,
+		 *  \details stealing chunks from the others when they run out, so that a burst of spikes in one range is
+		 *  \details shared by everybody. Finally, each worker adds the inputs of its buckets to the neurons it owns.
+		 */
+		static void update_worker(unsigned int worker, int t);
+
+		/*! \brief Returns the worker owning the local neuron with the given index */
+		static unsigned int worker_of(unsigned int index);
+
+		/*! \brief Sorts the inputs of a chunk of spikes into buckets by the worker owning their targets
+		 * @param[in] task the chunk, from the spikes collected by the worker task.owner
+		 * @param[in,out] buckets the buckets of the worker running the task
+		 */
+		static void deliver_spikes(WorkerTask const& task, std::vector<std::vector<Delivery> >& buckets);
+
+		/*! \brief Whether update() writes the output files */
+		static bool write_files_;
+
+		/*! \brief Number of spikes of the neurons of this process in the last time step */
+		static int step_spike_sum_;
+
+		/*! \brief Whether the results must not depend on the number of threads */
+		static bool deterministic_;
+
+		/*! \brief Seed of the counter-based noise and of the choice of the observed neurons of deterministic simulations */
+		static unsigned long seed_;
+
+		/*! \brief Draws the background noise of deterministic simulations, same mean as distribution_ */
+		static PoissonSampler background_sampler_;
+
+		/*! \brief Monitor of the activity of the network, null if none */
+		static ActivityMonitor* monitor_;
+
+		/*! \brief Statistics of the spike trains of the local neurons, null if none */
+		static SpikeStatistics* statistics_;
+
+		/*! \brief Spectrum of the population rate of the whole network, null if none */
+		static PopulationSpectrum* spectrum_;
+
+		/*! \brief Binary store of the spikes of the local neurons, null if none */
+		static SpikeStoreWriter* spike_store_;
+
+		/*! \brief .npy arrays of the spike sums, the observed neurons and the spikes of the local neurons, null if none */
+		static NpyRecording* npy_recording_;
+
+		/*! \brief Multimeter sampling the potentials of local neurons, null if none */
+		static Multimeter* multimeter_;
+
+		/*! \brief Ring of live telemetry in shared memory, null if none */
+		static TelemetryWriter* telemetry_;
+
+		/*! \brief Time window, subsampling and neurons of the recordings */
+		static RecordingPolicy recording_;
+
+		/*! \brief Time step of the next spike sum, and the sum of the current bin */
+		static int sum_step_;
+		static long binned_sum_;
+
+		/*! \brief Populations of the network, in increasing order of their neurons */
+		static std::vector<Population> populations_;
+
+		/*! \brief Number of spikes of each population in the current time step, like spike_sum_, and in the last one, like step_spike_sum_ */
+		static std::vector<unsigned int> population_sums_, step_population_sums_;
+
+		/*! \brief Spikes of each population of the current bin, and since the construction, known on rank 0 */
+		static std::vector<long> binned_population_sums_, total_population_sums_;
+
+		/*! \brief Whether the sums of the populations follow the sum of each time step in the recordings */
+		static bool write_population_sums_;
+
+		/*! \brief Whether the local neurons which spike are collected, and those which spiked in the last time step */
+		static bool collect_step_spikes_;
+		static std::vector<unsigned int> step_spikes_;
+
+		/*! \brief A subscriber, with the spikes of the time steps of its batch gathered so far */
+		struct SpikeSubscription
+		{
+			SpikeSubscriber* subscriber;
+			int batch_steps;
+			int first_step;
+			std::vector<unsigned int> neurons;
+			std::vector<unsigned int> offsets;
+		};
+
+		/*! \brief Subscribers to the spikes of this process, in the order they were added */
+		static std::vector<SpikeSubscription> subscriptions_;
+
+		/*! \brief Whether the local neurons which spike are collected into step_spikes_, for get_step_spikes() or the subscribers */
+		static bool collects_step_spikes();
+
+		/*! \brief Passes the spikes of a time step to the subscribers, or to their batches */
+		static void publish_step_spikes(int t);
+
+		/*! \brief Passes the spikes gathered in the batch of a subscriber, if any, and starts the next batch */
+		static void flush_subscription(SpikeSubscription& subscription);
+
+		/*! \brief Time step of the next row of the observed neurons, and whether each of them spiked in the current bin */
+		static int observed_step_;
+		static std::vector<bool> observed_bins_;
+
+		/*! \brief Whether the local neurons which reach the threshold are collected, for the other ranks, the recordings or get_step_spikes() */
+		static bool collects_crossings();
+
+		/*! \brief Passes the number of spikes of the whole network in the next time step to the monitor and the spectrum */
+		static void record_activity(int spikes);
+
+		/*! \brief Model of the background input */
+		static BackgroundModel background_model_;
+
+		/*! \brief Fraction of the variance of the background input common to all neurons, 0 unless the model is shared */
+		static double shared_fraction_;
+
+		/*! \brief Standard normal number common to all neurons in the current time step, for the shared model */
+		static double shared_normal_;
+
+		/*! \brief External rates varying in time or between the neurons, nullptr for the constant rate of distribution_ */
+		static ExternalDrive* drive_;
+
+		/*! \brief Background input of the neurons in the current time step, when the simulation runs in a single thread */
+		static std::vector<double> background_noise_;
+
+		/*! \brief Adds the background input of time t to the local neurons first to last - 1 and starts their time step
+		 * @param[in,out] generator, distribution the generator and the distribution of the calling thread
+		 * @param[out] noise buffer receiving the inputs
+		 */
+		static void add_background_noise(unsigned int first, unsigned int last, int t, std::default_random_engine& generator,
+										 std::poisson_distribution<int>& distribution, std::vector<double>& noise);
+
+		/*! \brief Draws the background input of the neurons first to last - 1 at the rates of drive_, see add_background_noise() */
+		static void draw_driven_noise(unsigned int first, unsigned int last, int t, std::default_random_engine& generator, std::vector<double>& noise);
+
+		/*! \brief Updates the local neurons first to last - 1
+		 *  \details The model of the neurons and the propagators are resolved once for the whole range. The range
+		 *  \details is split by population, and the spikes of each part counted in a local variable, which is added
+		 *  \details to the spike sums of the calling thread at the end of the part.
+		 * @param[out] crossed if not null, the neurons which reached the threshold are appended to it
+		 */
+		static void update_neurons(unsigned int first, unsigned int last, int t, std::vector<unsigned int>* crossed);
+
+		/*! \brief Same as update_neurons(), with the propagators resolved */
+		template <typename Propagators>
+		static void update_neurons(unsigned int first, unsigned int last, int t, std::vector<unsigned int>* crossed);
+
+		/*! \brief Same as update_neurons(), with the model resolved */
+		template <typename Model>
+		static void update_neurons_with(unsigned int first, unsigned int last, int t, std::vector<unsigned int>* crossed);
+
+		/*! \brief Records that a local neuron reached the threshold, in the recordings and for the ranks with targets of the neuron */
+		static void record_crossing(unsigned int index, int t);
+
 	public :
 	
 		/*! \brief Timestep used for the simulation */
@@ -155,16 +479,227 @@ class Cortex
 		 */
 		static int get_spike_sum();
 
-		/*! \brief Increments the value of spike_sum_  */
-		static void increment_spike_sum();
-
 	 	/*! \brief this function chooses 50 random neurons from the network.
-		 *  \details These neurons are going to be observed, and their spikes tracked and plotted. */
+		 *  \details These neurons are going to be observed, and their spikes tracked and plotted.
+		 *  \details If the recording policy lists neurons, these are observed instead.
+		 *  \throw runtime_error if a listed neuron isn't simulated by rank 0 */
 		static void choose_50_random_neurons();
 		
 		/*! \brief Returns the excitatory amplitude
 		 */
 		static double get_excitatory_amplitude();
+
+		/*! \brief Distributes the simulation over the ranks of a communicator
+		 *  \details Has to be called before the Cortex is constructed. The Cortex takes ownership of the communicator
+		 *  \details and deletes it in finish().
+		 * @param[in] communicator the communicator to the other ranks, or null to simulate in a single process
+		 */
+		static void set_communicator(Communicator* communicator);
+
+		/*! \brief Sets the number of threads simulating the neurons of this process
+		 *  \details Has to be called before initialize_neurons().
+		 * @param[in] threads the number of threads
+		 * @param[in] cpus the CPUs the threads are pinned to, thread w runs on cpus[w % cpus.size()], none if empty
+		 */
+		static void set_threads(unsigned int threads, std::vector<int> const& cpus);
+
+		/*! \brief Sets whether update() writes the output files, e.g. not when engines are compared
+		 *  \details Has to be called before the Cortex is constructed, which otherwise empties the files.
+		 */
+		static void set_write_files(bool write_files);
+
+		/*! \brief Returns the number of neurons simulated by this process */
+		static unsigned int get_number_of_local_neurons();
+
+		/*! \brief Returns a neuron simulated by this process
+		 * @param[in] index the index of the neuron among the neurons of this process
+		 */
+		static Neuron const& get_local_neuron(unsigned int index);
+
+		/*! \brief Returns the number of spikes of the neurons of this process in the last time step */
+		static int get_step_spike_sum();
+
+		/*! \brief Returns the number of spikes of the whole network written so far, on rank 0 */
+		static long get_total_spike_sum();
+
+		/*! \brief Sets the populations whose spikes are counted apart, by default the inhibitory and the excitatory neurons
+		 *  \details Has to be called after the Cortex is constructed, which sets the default, and before initialize_neurons().
+		 * @param[in] populations the populations, in increasing order of their neurons, which needn't cover all of them
+		 * \throw runtime_error if the populations overlap, are empty or out of order, or a neuron doesn't exist
+		 */
+		static void set_populations(std::vector<Population> const& populations);
+
+		/*! \brief Returns the populations */
+		static std::vector<Population> const& get_populations();
+
+		/*! \brief Returns the number of spikes of each population of the neurons of this process in the last time step */
+		static std::vector<unsigned int> const& get_step_population_sums();
+
+		/*! \brief Returns the number of spikes of each population written so far, on rank 0 */
+		static std::vector<long> const& get_total_population_sums();
+
+		/*! \brief Sets whether the neurons of this process which spike in a time step are collected, see get_step_spikes() */
+		static void set_collect_step_spikes(bool collect);
+
+		/*! \brief Returns the global indexes of the neurons of this process which spiked in the last time step, in increasing order
+		 *  \details Empty unless set_collect_step_spikes(true) was called. The vector is refilled by every update(), so
+		 *  \details that its data stays where it is as long as the number of spikes doesn't grow beyond its capacity.
+		 */
+		static std::vector<unsigned int> const& get_step_spikes();
+
+		/*! \brief Adds a subscriber to the neurons of this process which spike, of which the Cortex takes ownership
+		 *  \details After each batch of time steps, the subscriber receives the spikes of the batch on the thread
+		 *  \details calling update(), which waits for it, unless it is wrapped into an AsyncSpikeSubscriber. A batch of
+		 *  \details a single step is passed without a copy. finish() passes the last, incomplete batch, reset() deletes
+		 *  \details the subscribers. Nothing is collected while there are none.
+		 * @param[in] subscriber the subscriber
+		 * @param[in] batch_steps the number of time steps of a batch, e.g. exchange_epoch() for a batch per spike exchange
+		 */
+		static void add_spike_subscriber(SpikeSubscriber* subscriber, int batch_steps = 1);
+
+		/*! \brief Sets whether the sums of the populations follow the sum of each time step in sum_spikes.txt and sum_spikes.npy
+		 *  \details Has to be called before the .npy recording is created, whose sums then have a column per population.
+		 */
+		static void set_write_population_sums(bool write_population_sums);
+
+		/*! \brief Returns whether the sums of the populations are written */
+		static bool writes_population_sums();
+
+		/*! \brief Returns the number of neurons of the whole network */
+		static unsigned int get_number_of_neurons();
+
+		/*! \brief Returns a hash (FNV-1a) of the potentials, inputs, currents and spike times of the neurons of this process
+		 *  \details Two engines simulating the same network have the same hash after each time step.
+		 */
+		static uint64_t state_hash();
+
+		/*! \brief Makes the results of the simulation independent of the number of threads
+		 *  \details The background noise of a neuron at a time step is drawn from a counter-based generator keyed
+		 *  \details by the neuron and the time step, and the inputs are summed in fixed point, so that the
+		 *  \details order of the additions doesn't matter. The observed neurons are chosen with the seed.
+		 *  \details Has to be called before initialize_neurons().
+		 * @param[in] deterministic whether the simulation is deterministic
+		 * @param[in] seed the seed of the simulation
+		 */
+		static void set_deterministic(bool deterministic, unsigned long seed);
+
+		/*! \brief Sets the monitor fed with the number of spikes of the network at each time step
+		 *  \details The Cortex takes ownership of the monitor and deletes it in reset().
+		 *  \details In a distributed simulation, the monitors of all ranks receive the sums of each epoch at the exchange.
+		 * @param[in] monitor the monitor, or null for none
+		 */
+		static void set_monitor(ActivityMonitor* monitor);
+
+		/*! \brief Returns the monitor of the activity, null if none */
+		static ActivityMonitor const* get_monitor();
+
+		/*! \brief Returns what the monitor found out about the activity, running if there is no monitor */
+		static ActivityStatus get_activity_status();
+
+		/*! \brief Sets the statistics accumulated from the spikes of the local neurons
+		 *  \details The Cortex takes ownership of the statistics, starts them in initialize_neurons() and deletes them in reset().
+		 * @param[in] statistics the statistics, or null for none
+		 */
+		static void set_statistics(SpikeStatistics* statistics);
+
+		/*! \brief Returns the statistics of the spike trains, null if none */
+		static SpikeStatistics const* get_statistics();
+
+		/*! \brief Sets the spectrum fed with the number of spikes of the network at each time step, like the monitor
+		 *  \details The Cortex takes ownership of the spectrum and deletes it in reset().
+		 * @param[in] spectrum the spectrum, or null for none
+		 */
+		static void set_spectrum(PopulationSpectrum* spectrum);
+
+		/*! \brief Returns the spectrum of the population rate, null if none */
+		static PopulationSpectrum const* get_spectrum();
+
+		/*! \brief Sets the binary store the spikes of all local neurons are written into
+		 *  \details The Cortex takes ownership of the store, closes it in finish() and deletes it in reset().
+		 * @param[in] spike_store the store, or null for none
+		 */
+		static void set_spike_store(SpikeStoreWriter* spike_store);
+
+		/*! \brief Returns the spike store, null if none */
+		static SpikeStoreWriter const* get_spike_store();
+
+		/*! \brief Sets the .npy arrays the recordings are written into, besides or instead of the text files
+		 *  \details The Cortex takes ownership of the recording, closes it in finish() and deletes it in reset().
+		 * @param[in] npy_recording the recording, or null for none
+		 */
+		static void set_npy_recording(NpyRecording* npy_recording);
+
+		/*! \brief Returns the .npy recording, null if none */
+		static NpyRecording const* get_npy_recording();
+
+		/*! \brief Sets the multimeter sampling the potentials and the inputs of local neurons after each update
+		 *  \details The Cortex takes ownership of the multimeter, closes it in finish() and deletes it in reset().
+		 *  \details initialize_neurons() throws a runtime_error if a sampled neuron isn't simulated by this rank.
+		 * @param[in] multimeter the multimeter, or null for none
+		 */
+		static void set_multimeter(Multimeter* multimeter);
+
+		/*! \brief Returns the multimeter, null if none */
+		static Multimeter const* get_multimeter();
+
+		/*! \brief Sets the ring the spikes of the network are published into after each time step
+		 *  \details The Cortex takes ownership of the ring, marks it finished in finish() and deletes it in reset().
+		 * @param[in] telemetry the ring, or null for none
+		 */
+		static void set_telemetry(TelemetryWriter* telemetry);
+
+		/*! \brief Returns the telemetry ring, null if none */
+		static TelemetryWriter const* get_telemetry();
+
+		/*! \brief Sets the time window, the subsampling and the neurons of all recordings
+		 *  \details Has to be called before initialize_neurons(), which observes the listed neurons if there are any.
+		 */
+		static void set_recording(RecordingPolicy const& recording);
+
+		/*! \brief Returns the recording policy */
+		static RecordingPolicy const& get_recording();
+
+		/*! \brief Sets the model of the background input
+		 *  \details The number common to all neurons of the shared model is drawn from a counter-based generator
+		 *  \details keyed by the seed of set_deterministic() and the time step, so that all ranks agree on it.
+		 * @param[in] model the model
+		 * @param[in] shared_fraction the fraction of the variance common to all neurons, for the shared model
+		 * \throw runtime_error if shared_fraction isn't between 0 and 1
+		 */
+		static void set_background(BackgroundModel model, double shared_fraction);
+
+		/*! \brief Sets the external rates varying in time or between the neurons, of which the Cortex takes ownership
+		 *  \details Replaces the constant rate of the distribution until reset(), with any model of the background.
+		 */
+		static void set_drive(ExternalDrive* drive);
+
+		/*! \brief Whether this process is rank 0, which writes the output files and the terminal output */
+		static bool is_root();
+
+		/*! \brief Returns the global index of the first neuron simulated by a rank
+		 * @param[in] rank the rank, rank == size gives the total number of neurons
+		 * @param[in] size the number of ranks
+		 */
+		static unsigned int first_neuron_of_rank(int rank, int size);
+
+		/*! \brief Number of time steps between two spike exchanges between ranks
+		 *  \details A spike is sent to its targets at least Neuron::get_send_steps() after it is emitted, the transmission
+		 *  \details delay minus one step, or minus two steps and the crossing offset with precise spike times, so it is
+		 *  \details enough to exchange the spikes once per such epoch.
+		 */
+		static int exchange_epoch();
+
+		/*! \brief Completes the simulation
+		 *  \details Exchanges the spikes of the last, incomplete epoch between the ranks and disconnects from them,
+		 *  \details closes the spike store, the .npy recording and the multimeter, marks the telemetry finished, and
+		 *  \details passes their last spikes to the subscribers before finishing them.
+		 */
+		static void finish();
+
+		/*! \brief Disconnects a rank which failed before finish()
+		 *  \details Aborts the exchanges, so that the other ranks throw instead of waiting for this one forever.
+		 */
+		static void abort_ranks();
 		
 };
 
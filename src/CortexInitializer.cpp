@@ -7,8 +7,13 @@
 #include <fstream>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
+#include <unistd.h>
 #include "Cortex.hpp"
 #include "Neuron.hpp"
+#include "Communicator.hpp"
+#include "Numa.hpp"
+#include "MeanField.hpp"
 
 #define BOLD "\033[1m\033[37m"
 #define RESET "\033[0m"
@@ -19,13 +24,57 @@ static const double VERBOSE(true);
 static const double DEFAULT_RELATIVE_AMPLITUDE(5.0);
 static const double DEFAULT_RATIO(2.0);
 static const double DEFAULT_AMPLITUDE(0.1);
+static const int DEFAULT_RANKS(1);
+static const int DEFAULT_PORT(47000);
+static const int DEFAULT_THREADS(1);
+static const double DEFAULT_SHARED_FRACTION(0.1);
+static const double DEFAULT_RATE_TOLERANCE(0.02);
 
-bool initialize_cortex (int argc, char** argv, double timestep, int max_time){
+#define SPIKE_STORE_FILE "spikes.bin"
+#define MULTIMETER_FILE "multimeter.npy"
+
+/*! Prints the stationary states predicted by the mean field, returns the rate of the lowest stable one or -1
+ *  \details The mean field models delta-synapse LIF neurons under a constant Poisson background. For another
+ *  \details configuration, the states are labelled approximate with what they ignore, and -1 is returned so that
+ *  \details the simulated rate isn't compared to them.
+ * @param[in] ignored the features of the configuration the mean field ignores, separated by ", ", empty if none
+ */
+static double print_prediction(double relative_inhibitory_amplitude, double excitatory_amplitude, double ratio, std::string const& ignored)
+{
+	auto const start = std::chrono::steady_clock::now();
+	MeanField const mean_field(relative_inhibitory_amplitude, excitatory_amplitude, ratio, NUMBER_OF_NEURONS);
+	std::vector<MeanFieldState> const states(mean_field.solve());
+	auto const elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+	std::cout << "Stationary states predicted by the mean field (" << elapsed.count() << " ms)";
+	if (!ignored.empty()) {
+		std::cout << ", " << BOLD << "approximate" << RESET << ": it ignores " << ignored;
+	}
+	std::cout << ":" << std::endl;
+	double rate(-1);
+	for (auto const& state : states) {
+		std::cout << "     " << BOLD << std::setw(8) << state.rate << " Hz" << RESET
+				  << ", CV " << state.cv << ", potential " << state.mean_input << " +- " << state.input_deviation << " mV, "
+				  << (state.mean_input > THRESHOLD_POTENTIAL ? "mean-driven" : "fluctuation-driven")
+				  << (state.stable ? "" : ", unstable") << std::endl;
+		if (state.stable and rate < 0) {
+			rate = state.rate;
+		}
+	}
+	if (states.empty()) {
+		std::cout << "     none" << std::endl;
+	}
+	return ignored.empty() ? rate : -1;
+}
+
+bool initialize_cortex (int argc, char** argv, double& timestep, int max_time, double& predicted_rate, bool exit_on_usage){
 
 	
 
 	try{
 		TCLAP::CmdLine cmd ("Variables");
+		// a program embedding the simulation isn't ended by its flags
+		cmd.setExceptionHandling(exit_on_usage);
 		TCLAP::ValueArg<bool> launchProgram ("r", "Run", "Enables to run the programm", false, false, "bool");
 		cmd.add (launchProgram);
 		TCLAP::ValueArg<double> relAmplitudeArg("g", "Relative_inhibitory_amplitude", "Inhibitory amplitude (default: 5)", false, DEFAULT_RELATIVE_AMPLITUDE, "double");
@@ -34,6 +83,88 @@ bool initialize_cortex (int argc, char** argv, double timestep, int max_time){
 		cmd.add (ratioArg);
 		TCLAP::ValueArg<double> amplitudeArg("j", "Excitatory_amplitude", "Amplitude of the spike of an excitatory neuron (default: 0.1 mV)", false, DEFAULT_AMPLITUDE, "double");
 		cmd.add (amplitudeArg);
+		TCLAP::ValueArg<int> ranksArg("n", "Ranks", "Number of processes the network is distributed over (default: 1)", false, DEFAULT_RANKS, "int");
+		cmd.add (ranksArg);
+		std::vector<std::string> transports = {"shm", "socket"};
+		TCLAP::ValuesConstraint<std::string> transportConstraint(transports);
+		TCLAP::ValueArg<std::string> transportArg("", "Transport", "Transport between the processes, shared memory or TCP sockets (default: shm)", false, "shm", &transportConstraint);
+		cmd.add (transportArg);
+		TCLAP::ValueArg<int> portArg("", "Port", "First TCP port used by the socket transport (default: 47000)", false, DEFAULT_PORT, "int");
+		cmd.add (portArg);
+		TCLAP::ValueArg<int> threadsArg("t", "Threads", "Number of threads simulating the neurons of each process (default: 1)", false, DEFAULT_THREADS, "int");
+		cmd.add (threadsArg);
+		TCLAP::ValueArg<std::string> cpusArg("", "Cpus", "CPUs the threads are pinned to, e.g. 0-7,16-23 (default: not pinned)", false, "", "list");
+		cmd.add (cpusArg);
+		TCLAP::ValueArg<bool> deterministicArg("", "Deterministic", "Makes the results independent of the number of threads (default: false)", false, false, "bool");
+		cmd.add (deterministicArg);
+		TCLAP::ValueArg<unsigned long> seedArg("s", "Seed", "Seed of the random numbers (default: based on time, 0 in deterministic mode)", false, 0, "unsigned long");
+		cmd.add (seedArg);
+		TCLAP::ValueArg<double> timeStepArg("", "Time_step", "Time step of the simulation, the refractory period and the transmission delay have to be multiples of it unless the spike times are precise (default: 0.1 ms)", false, timestep, "double");
+		cmd.add (timeStepArg);
+		std::vector<std::string> synapses {"delta", "exp"};
+		TCLAP::ValuesConstraint<std::string> synapseConstraint(synapses);
+		TCLAP::ValueArg<std::string> synapseArg("", "Synapse", "Synapse model, spikes added to the potential or exponential synaptic currents (default: delta)", false, "delta", &synapseConstraint);
+		cmd.add (synapseArg);
+		std::vector<std::string> models {"lif", "adaptive"};
+		TCLAP::ValuesConstraint<std::string> modelConstraint(models);
+		TCLAP::ValueArg<std::string> modelArg("", "Model", "Neuron model, leaky integrate-and-fire or with a spike-triggered adaptation current, delta synapses only (default: lif)", false, "lif", &modelConstraint);
+		cmd.add (modelArg);
+		TCLAP::ValueArg<double> tauSynArg("", "Tau_syn", "Time constant of the exponential synaptic current (default: 0.5 ms)", false, DEFAULT_TAU_SYN, "double");
+		cmd.add (tauSynArg);
+		TCLAP::ValueArg<bool> preciseArg("", "Precise", "Times the refractory period and the arrival of the spikes from the interpolated threshold crossing within the time step, for coarser time steps, delta synapses only (default: false)", false, false, "bool");
+		cmd.add (preciseArg);
+		std::vector<std::string> backgrounds {"poisson", "gaussian", "shared"};
+		TCLAP::ValuesConstraint<std::string> backgroundConstraint(backgrounds);
+		TCLAP::ValueArg<std::string> backgroundArg("", "Background", "Background input, exact Poisson, Gaussian approximation, or Gaussian partly shared by all neurons (default: poisson)", false, "poisson", &backgroundConstraint);
+		cmd.add (backgroundArg);
+		TCLAP::ValueArg<double> sharedFractionArg("", "Shared_fraction", "Fraction of the variance of the shared background input common to all neurons (default: 0.1)", false, DEFAULT_SHARED_FRACTION, "double");
+		cmd.add (sharedFractionArg);
+		TCLAP::ValueArg<bool> predictArg("", "Predict", "Prints the stationary rate and CV predicted by the mean field, and compares the simulated rate to it (default: false)", false, false, "bool");
+		cmd.add (predictArg);
+		TCLAP::ValueArg<bool> earlyStopArg("", "Early_stop", "Stops the simulation once the activity died out, saturated or its rate converged (default: false)", false, false, "bool");
+		cmd.add (earlyStopArg);
+		TCLAP::ValueArg<double> rateToleranceArg("", "Rate_tolerance", "Relative standard error of the mean rate at which it has converged (default: 0.02)", false, DEFAULT_RATE_TOLERANCE, "double");
+		cmd.add (rateToleranceArg);
+		TCLAP::ValueArg<bool> statisticsArg("", "Statistics", "Accumulates the statistics of the spike trains during the run and writes their summary into statistics.txt (default: false)", false, false, "bool");
+		cmd.add (statisticsArg);
+		TCLAP::ValueArg<double> fanoWindowArg("", "Fano_window", "Length of the windows of the Fano factor of the statistics (default: 100 ms)", false, DEFAULT_FANO_WINDOW, "double");
+		cmd.add (fanoWindowArg);
+		TCLAP::ValueArg<double> synchronyBinArg("", "Synchrony_bin", "Length of the bins of the population synchrony of the statistics (default: 1 ms)", false, DEFAULT_SYNCHRONY_BIN, "double");
+		cmd.add (synchronyBinArg);
+		TCLAP::ValueArg<bool> writeSpikesArg("", "Write_spikes", "Writes the spike sums and the spikes of the observed neurons into sum_spikes.txt and spikes.txt (default: true)", false, true, "bool");
+		cmd.add (writeSpikesArg);
+		TCLAP::ValueArg<bool> spectrumArg("", "Spectrum", "Estimates the power spectrum of the population rate during the run and writes it into spectrum.txt (default: false)", false, false, "bool");
+		cmd.add (spectrumArg);
+		TCLAP::ValueArg<unsigned int> spectrumSegmentArg("", "Spectrum_segment", "Number of time steps of the segments of the spectrum, a power of two (default: 2048)", false, DEFAULT_SPECTRUM_SEGMENT, "unsigned int");
+		cmd.add (spectrumSegmentArg);
+		TCLAP::ValueArg<bool> spikeStoreArg("", "Spike_store", "Writes the spikes of all neurons into the binary, time-indexed spikes.bin, with a single rank only (default: false)", false, false, "bool");
+		cmd.add (spikeStoreArg);
+		TCLAP::ValueArg<double> storeChunkArg("", "Store_chunk", "Time span of the chunks of spikes.bin (default: 100 ms)", false, DEFAULT_STORE_CHUNK, "double");
+		cmd.add (storeChunkArg);
+		TCLAP::ValueArg<bool> npyArg("", "Npy", "Writes the spike sums, the observed spikes and the spikes of all neurons into sum_spikes.npy, spikes.npy and raster.npy, with a single rank only (default: false)", false, false, "bool");
+		cmd.add (npyArg);
+		TCLAP::ValueArg<double> recordFromArg("", "Record_from", "Beginning of the recorded time window (default: 0 ms)", false, 0.0, "double");
+		cmd.add (recordFromArg);
+		TCLAP::ValueArg<double> recordToArg("", "Record_to", "End of the recorded time window, excluded (default: the end of the simulation)", false, max_time, "double");
+		cmd.add (recordToArg);
+		TCLAP::ValueArg<int> recordEveryArg("", "Record_every", "Records the spike sums and the observed neurons every k-th time step (default: 1)", false, 1, "int");
+		cmd.add (recordEveryArg);
+		TCLAP::ValueArg<int> recordBinArg("", "Record_bin", "Records the spike sums and the observed neurons in bins of b time steps (default: 1)", false, 1, "int");
+		cmd.add (recordBinArg);
+		TCLAP::ValueArg<std::string> recordNeuronsArg("", "Record_neurons", "Neurons observed and recorded in the rasters, e.g. \"0-99,12000\" (default: 50 random observed neurons, all in the rasters)", false, "", "list");
+		cmd.add (recordNeuronsArg);
+		TCLAP::ValueArg<double> recordFractionArg("", "Record_fraction", "Fraction of the neurons recorded in the rasters (default: 1)", false, 1.0, "double");
+		cmd.add (recordFractionArg);
+		TCLAP::ValueArg<std::string> multimeterArg("", "Multimeter", "Neurons whose potential and input are written into multimeter.npy, e.g. \"0-99\" (default: none)", false, "", "list");
+		cmd.add (multimeterArg);
+		TCLAP::ValueArg<double> multimeterIntervalArg("", "Multimeter_interval", "Interval between two samples of the multimeter (default: 1 ms)", false, DEFAULT_MULTIMETER_INTERVAL, "double");
+		cmd.add (multimeterIntervalArg);
+		TCLAP::ValueArg<bool> populationSumsArg("", "Population_sums", "Writes the spikes of the inhibitory and of the excitatory neurons after the spike sum of each time step (default: false)", false, false, "bool");
+		cmd.add (populationSumsArg);
+		TCLAP::ValueArg<bool> telemetryArg("", "Telemetry", "Publishes the spikes, the rate and the speed of each time step into a shared memory ring read by TelemetryMonitor (default: false)", false, false, "bool");
+		cmd.add (telemetryArg);
+		TCLAP::ValueArg<std::string> stimulusArg("", "Stimulus", "Time courses of the external rate, ratios like -f, each after the population or the neurons it drives, e.g. \"excitatory:step,100,200,4;0-99:sine,1,10\", see Stimulus.hpp (default: constant)", false, "", "list");
+		cmd.add (stimulusArg);
 		cmd.parse(argc, argv);
 		
 		if (relAmplitudeArg.getValue() < 0){
@@ -57,8 +188,48 @@ bool initialize_cortex (int argc, char** argv, double timestep, int max_time){
 			return false;
 		}
 
+		else if (ranksArg.getValue() < 1 or ranksArg.getValue() > NUMBER_OF_NEURONS){
+			
+			std::cout << "Error, the number of processes must be between 1 and the number of neurons" << std::endl;
+			std::cout << "Try again !" << std::endl;
+			return false;
+		}
+
+		else if (rateToleranceArg.getValue() <= 0){
+			
+			std::cout << "Error, the rate tolerance must be larger than 0" << std::endl;
+			std::cout << "Try again !" << std::endl;
+			return false;
+		}
+
+		else if (threadsArg.getValue() < 1){
+			
+			std::cout << "Error, the number of threads must be at least 1" << std::endl;
+			std::cout << "Try again !" << std::endl;
+			return false;
+		}
+
 				
-		if (!launchProgram.getValue()){
+		predicted_rate = -1;
+		if (predictArg.getValue()) {
+			std::string ignored;
+			auto const ignore = [&ignored](std::string const& feature) { ignored += (ignored.empty() ? "" : ", ") + feature; };
+			if (synapseArg.getValue() != "delta") {
+				ignore("--Synapse " + synapseArg.getValue());
+			}
+			if (modelArg.getValue() != "lif") {
+				ignore("--Model " + modelArg.getValue());
+			}
+			if (backgroundArg.getValue() != "poisson") {
+				ignore("--Background " + backgroundArg.getValue());
+			}
+			if (stimulusArg.isSet()) {
+				ignore("--Stimulus");
+			}
+			predicted_rate = print_prediction(relAmplitudeArg.getValue(), amplitudeArg.getValue(), ratioArg.getValue(), ignored);
+		}
+				
+		if (!launchProgram.getValue() and !predictArg.getValue()){
 			
 			//"-r" flag was not set to true --> don't run program
 			
@@ -72,6 +243,30 @@ bool initialize_cortex (int argc, char** argv, double timestep, int max_time){
 			
 			//"-r" set to true --> run the program
 			
+			timestep = timeStepArg.getValue();
+			NeuronModel model(synapseArg.getValue() == "exp" ? NeuronModel::lif_exponential : NeuronModel::lif_delta);
+			if (modelArg.getValue() == "adaptive") {
+				if (model == NeuronModel::lif_exponential) {
+					throw std::runtime_error("the adaptive model only has delta synapses");
+				}
+				model = NeuronModel::adaptive_lif;
+			}
+			if (earlyStopArg.getValue() and stimulusArg.isSet()) {
+				throw std::runtime_error("--Early_stop can't be used with --Stimulus, whose rates aren't meant to be stationary");
+			}
+			if (spikeStoreArg.getValue() and ranksArg.getValue() > 1) {
+				throw std::runtime_error("--Spike_store can't be used with --Ranks, each rank only knows the spikes of its own neurons");
+			}
+			if (npyArg.getValue() and ranksArg.getValue() > 1) {
+				throw std::runtime_error("--Npy can't be used with --Ranks, each rank only knows the spikes of its own neurons for raster.npy");
+			}
+			Neuron::set_model(model, tauSynArg.getValue());
+			Neuron::set_precise(preciseArg.getValue());
+			Neuron::set_time_step(timestep);
+			if (ranksArg.getValue() > 1 and Cortex::exchange_epoch() < 1) {
+				throw std::runtime_error("the ranks need a transmission delay of at least three time steps to exchange precise spikes");
+			}
+
 			// display parameters
 			std::cout << "The following parameters will be used for the simulation :" << std::endl;
 			std::cout.setf(std::ios::left);
@@ -93,34 +288,230 @@ bool initialize_cortex (int argc, char** argv, double timestep, int max_time){
 			std::cout << std::setw(40) << "     Time Step: ";
 			std::cout.unsetf(std::ios::left);
 			std::cout << std::setw(10) << BOLD << timestep << " ms" << RESET << std::endl;
+
+			if (preciseArg.getValue()) {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Spike times: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << "precise" << RESET << std::endl;
+			}
+
+			if (backgroundArg.getValue() != "poisson") {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Background input: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << backgroundArg.getValue();
+				if (backgroundArg.getValue() == "shared") {
+					std::cout << " (" << sharedFractionArg.getValue() << ")";
+				}
+				std::cout << RESET << std::endl;
+			}
+
+			if (modelArg.getValue() == "adaptive") {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Neuron model: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << "adaptive" << RESET << std::endl;
+			}
+
+			if (synapseArg.getValue() == "exp") {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Synaptic time constant: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << tauSynArg.getValue() << " ms" << RESET << std::endl;
+			}
 			
 			std::cout.setf(std::ios::left);
 			std::cout << std::setw(40) << "     Simulation Time: ";
 			std::cout.unsetf(std::ios::left);
 			std::cout << std::setw(10) << BOLD << max_time << " ms" << RESET << std::endl;
+
+			if (ranksArg.getValue() > 1) {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Processes: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << ranksArg.getValue() << " (" << transportArg.getValue() << ")" << RESET << std::endl;
+			}
+
+			if (threadsArg.getValue() > 1) {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Threads: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << threadsArg.getValue() << RESET << std::endl;
+			}
+
+			if (statisticsArg.getValue()) {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Statistics, Fano window, bin: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << fanoWindowArg.getValue() << " ms, " << synchronyBinArg.getValue() << " ms" << RESET << std::endl;
+			}
+
+			if (spectrumArg.getValue()) {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Spectrum, segment: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << spectrumSegmentArg.getValue() << " steps" << RESET << std::endl;
+			}
+
+			if (spikeStoreArg.getValue()) {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Spike store, chunk: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << storeChunkArg.getValue() << " ms" << RESET << std::endl;
+			}
+
+			if (recordFromArg.isSet() or recordToArg.isSet() or recordEveryArg.isSet() or recordBinArg.isSet()
+				or recordNeuronsArg.isSet() or recordFractionArg.isSet()) {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Recording window, every, bin: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << recordFromArg.getValue() << "-" << recordToArg.getValue() << " ms, "
+						  << recordEveryArg.getValue() << ", " << recordBinArg.getValue() << RESET << std::endl;
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Recorded neurons: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << (recordNeuronsArg.isSet() ? recordNeuronsArg.getValue() : std::to_string(recordFractionArg.getValue())) << RESET << std::endl;
+			}
+
+			if (multimeterArg.isSet()) {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Multimeter, interval: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << multimeterArg.getValue() << ", " << multimeterIntervalArg.getValue() << " ms" << RESET << std::endl;
+			}
+
+			if (telemetryArg.getValue()) {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Telemetry segment: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << telemetry_segment(getpid()) << RESET << std::endl;
+			}
+
+			if (earlyStopArg.getValue()) {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Early stop, rate tolerance: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << rateToleranceArg.getValue() << RESET << std::endl;
+			}
+
+			if (stimulusArg.isSet()) {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Stimulus: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << stimulusArg.getValue() << RESET << std::endl;
+			}
+
+			if (deterministicArg.getValue()) {
+				std::cout.setf(std::ios::left);
+				std::cout << std::setw(40) << "     Deterministic, seed: ";
+				std::cout.unsetf(std::ios::left);
+				std::cout << std::setw(10) << BOLD << seedArg.getValue() << RESET << std::endl;
+			}
 			
 			
 			//---------------------- initialize cortex -------------------------------				
 			
+			// the threads are started once the neurons are initialized, after the processes are forked
+			Cortex::set_threads(threadsArg.getValue(), parse_cpu_list(cpusArg.getValue()));
+
 			//seed based on time
-			unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
+			unsigned long seed = std::chrono::system_clock::now().time_since_epoch().count();
+			if (seedArg.isSet() or deterministicArg.getValue()) {
+				seed = seedArg.getValue();
+			}
+			// the counter-based noise is keyed by the global index of the neuron, the seed is shared by all ranks
+			Cortex::set_deterministic(deterministicArg.getValue(), seed);
+			BackgroundModel background(BackgroundModel::poisson);
+			if (backgroundArg.getValue() == "gaussian") {
+				background = BackgroundModel::gaussian;
+			} else if (backgroundArg.getValue() == "shared") {
+				background = BackgroundModel::shared;
+			}
+			Cortex::set_background(background, sharedFractionArg.getValue());
+
+			RecordingPolicy recording(timestep, recordFromArg.getValue(), recordToArg.getValue(), recordEveryArg.getValue(), recordBinArg.getValue());
+			if (recordNeuronsArg.isSet() and recordFractionArg.isSet()) {
+				throw std::runtime_error("the recorded neurons are given either as a list or as a fraction");
+			} else if (recordNeuronsArg.isSet()) {
+				recording.set_neurons(parse_neuron_list(recordNeuronsArg.getValue(), NUMBER_OF_NEURONS), NUMBER_OF_NEURONS);
+			} else if (recordFractionArg.isSet()) {
+				recording.set_fraction(recordFractionArg.getValue(), NUMBER_OF_NEURONS, seed);
+			}
+			Cortex::set_recording(recording);
+
+			// the listed neurons are written by rank 0, which only knows its own ones
+			std::vector<unsigned int> const sampled(parse_neuron_list(multimeterArg.getValue(), NUMBER_OF_NEURONS));
+			unsigned int const root_neurons(Cortex::first_neuron_of_rank(1, ranksArg.getValue()));
+			if ((!recording.neurons().empty() and recording.neurons().back() >= root_neurons)
+				or (!sampled.empty() and *std::max_element(sampled.begin(), sampled.end()) >= root_neurons)) {
+				throw std::runtime_error("the recorded neurons have to be simulated by rank 0, i.e. smaller than " + std::to_string(root_neurons));
+			}
+
+			if (ranksArg.getValue() > 1) {
+				// a rank sends at most every local spike of an epoch as an (index, time) pair, or an (index, time, offset)
+				// triple with precise spike times, plus the epoch's spike sums
+				std::size_t capacity((Neuron::is_precise() ? 3 : 2) * NUMBER_OF_NEURONS + 2 * Neuron::get_delay_steps() + 2);
+				Communicator* communicator = launch_local_ranks(transportArg.getValue(), ranksArg.getValue(), capacity, portArg.getValue());
+				Cortex::set_communicator(communicator);
+				// every rank draws its own background noise
+				seed += communicator->get_rank();
+			}
 			std::default_random_engine generator(seed);
 			// calculate external input frequency
 			double external_input_frequency = ratioArg.getValue() * timestep * THRESHOLD_POTENTIAL/(amplitudeArg.getValue() * TAU);
 			std::poisson_distribution<int> distribution(external_input_frequency);
 			
+			Cortex::set_write_files(writeSpikesArg.getValue());
+			Cortex::set_write_population_sums(populationSumsArg.getValue());
 			Cortex(relAmplitudeArg.getValue(), amplitudeArg.getValue(), NUMBER_OF_NEURONS, VERBOSE, timestep, distribution, generator);
+			if (stimulusArg.isSet()) {
+				// the mean number of external spikes per time step is proportional to the ratio, see external_input_frequency
+				double const mean_per_ratio(timestep * THRESHOLD_POTENTIAL / (amplitudeArg.getValue() * TAU));
+				ExternalDrive* drive = new ExternalDrive(ratioArg.getValue(), mean_per_ratio, timestep, NUMBER_OF_NEURONS);
+				Cortex::set_drive(drive);
+				add_stimuli(*drive, stimulusArg.getValue(), Cortex::get_populations(), NUMBER_OF_NEURONS);
+			}
+			if (statisticsArg.getValue()) {
+				Cortex::set_statistics(new SpikeStatistics(timestep, fanoWindowArg.getValue(), synchronyBinArg.getValue()));
+			}
+			if (spectrumArg.getValue()) {
+				Cortex::set_spectrum(new PopulationSpectrum(NUMBER_OF_NEURONS, timestep, spectrumSegmentArg.getValue()));
+			}
+			if (npyArg.getValue() and Cortex::is_root()) {
+				unsigned int const observed(recording.neurons().empty() ? NUMBER_OF_CHOSEN_NEURONS : recording.neurons().size());
+				unsigned int const populations(populationSumsArg.getValue() ? Cortex::get_populations().size() : 0);
+				Cortex::set_npy_recording(new NpyRecording("", observed, populations));
+			}
+			if (multimeterArg.isSet() and Cortex::is_root()) {
+				Cortex::set_multimeter(new Multimeter(MULTIMETER_FILE, sampled, timestep, multimeterIntervalArg.getValue()));
+			}
+			if (spikeStoreArg.getValue() and Cortex::is_root()) {
+				// the neurons of the other ranks aren't stored, like in spikes.txt
+				Cortex::set_spike_store(new SpikeStoreWriter(SPIKE_STORE_FILE, NUMBER_OF_NEURONS, timestep, storeChunkArg.getValue()));
+			}
+			if (telemetryArg.getValue() and Cortex::is_root()) {
+				// rank 0 is the process started by the user, whose number names the segment
+				Cortex::set_telemetry(new TelemetryWriter(telemetry_segment(getpid()), NUMBER_OF_NEURONS, timestep, Cortex::get_populations()));
+			}
+			if (earlyStopArg.getValue()) {
+				Cortex::set_monitor(new ActivityMonitor(NUMBER_OF_NEURONS, timestep, rateToleranceArg.getValue()));
+			}
 		}
 		
 		//simulation will only run if this is true
 		return launchProgram.getValue();
 		
 	} catch (TCLAP::ArgException &e) {
+		if (!exit_on_usage) {
+			throw;
+		}
 		std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::flush;
 		return false;
 
 	} catch (std::runtime_error error) {
 		std::cerr << error.what() << std::flush;
+		Cortex::abort_ranks();
 		return false;
 	}
 }
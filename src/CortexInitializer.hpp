@@ -11,6 +11,7 @@
 	 					-g (double) 	to set the inhibitory amplitude 
 	 					-f (double) 	to set the Vext/Vthr ratio (ratio between external frequency and threshold frequency)
 	 					-j (double) 	to set the amplitude of excitatory spikes 
+	 					--Predict 1 	to print the stationary states predicted by the mean field
 	 					-h 				for more details about flags and their usage
  */
 
@@ -20,9 +21,12 @@
 /*! 	\brief Function for the user to start the simulation and set the parameters 
 		 * @param[in] argc the number of arguments written in command line
 		 * @param[in] argv the arguments entered in the command line
-         * @param[in] timestep the time step (in ms) to be used in the simulation
+         * @param[in,out] timestep the default time step (in ms), set to the time step chosen by the user
          * @param[in] max_time the simulation time in ms 
+         * @param[out] predicted_rate the rate of the lowest stable state predicted by the mean field (in Hz), -1 if no prediction was asked for
+         * @param[in] exit_on_usage whether TCLAP exits the process on an invalid flag, --help or --version, else it throws
+         * \throw TCLAP::ArgException on an invalid flag and TCLAP::ExitException after the usage or the version, unless exit_on_usage
 */        
-bool initialize_cortex (int argc, char** argv, double timestep, int max_time);
+bool initialize_cortex (int argc, char** argv, double& timestep, int max_time, double& predicted_rate, bool exit_on_usage = true);
 
 #endif
@@ -0,0 +1,135 @@
+#include "CounterRandom.hpp"
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// multipliers and key increments of Philox4x32
+constexpr uint32_t PHILOX_M0 (0xD2511F53);
+constexpr uint32_t PHILOX_M1 (0xCD9E8D57);
+constexpr uint32_t PHILOX_W0 (0x9E3779B9);
+constexpr uint32_t PHILOX_W1 (0xBB67AE85);
+constexpr int PHILOX_ROUNDS (10);
+
+/*! Means from which on the transformed rejection is faster than the inversion */
+constexpr double REJECTION_THRESHOLD (10.0);
+
+inline void multiply(uint32_t a, uint32_t b, uint32_t& high, uint32_t& low)
+{
+	uint64_t const product(static_cast<uint64_t>(a) * b);
+	high = product >> 32;
+	low = static_cast<uint32_t>(product);
+}
+
+}
+
+CounterRandom::CounterRandom(uint64_t seed, uint32_t stream, uint32_t substream)
+	: used_(4)
+{
+	key_[0] = static_cast<uint32_t>(seed);
+	key_[1] = static_cast<uint32_t>(seed >> 32);
+	counter_[0] = 0;
+	counter_[1] = 0;
+	counter_[2] = substream;
+	counter_[3] = stream;
+}
+
+void CounterRandom::next_block()
+{
+	uint32_t x[4] = {counter_[0], counter_[1], counter_[2], counter_[3]};
+	uint32_t k0(key_[0]), k1(key_[1]);
+
+	for (int round(0); round < PHILOX_ROUNDS; ++round) {
+		uint32_t high0, low0, high1, low1;
+		multiply(PHILOX_M0, x[0], high0, low0);
+		multiply(PHILOX_M1, x[2], high1, low1);
+		uint32_t const y0(high1 ^ x[1] ^ k0);
+		uint32_t const y2(high0 ^ x[3] ^ k1);
+		x[0] = y0;
+		x[1] = low1;
+		x[2] = y2;
+		x[3] = low0;
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+
+	for (int i(0); i < 4; ++i) {
+		block_[i] = x[i];
+	}
+	used_ = 0;
+
+	// the position in the stream is the 64 bit number in the two low words
+	if (++counter_[0] == 0) {
+		++counter_[1];
+	}
+}
+
+uint32_t CounterRandom::next()
+{
+	if (used_ == 4) {
+		next_block();
+	}
+	return block_[used_++];
+}
+
+double CounterRandom::uniform()
+{
+	// 53 random bits, the precision of a double
+	uint64_t const high(next() >> 5);
+	uint64_t const low(next() >> 6);
+	return (high * 67108864.0 + low) * (1.0 / 9007199254740992.0);
+}
+
+PoissonSampler::PoissonSampler(double mean)
+	: mean_(mean), exp_minus_mean_(std::exp(-mean)), log_mean_(0), a_(0), b_(0), inverse_alpha_(0), v_r_(0)
+{
+	assert(mean >= 0);
+	if (mean >= REJECTION_THRESHOLD) {
+		double const square_root(std::sqrt(mean));
+		log_mean_ = std::log(mean);
+		b_ = 0.931 + 2.53 * square_root;
+		a_ = -0.059 + 0.02483 * b_;
+		inverse_alpha_ = 1.1239 + 1.1328 / (b_ - 3.4);
+		v_r_ = 0.9277 - 3.6224 / (b_ - 2);
+	}
+}
+
+double PoissonSampler::mean() const
+{
+	return mean_;
+}
+
+int PoissonSampler::operator()(CounterRandom& random) const
+{
+	if (mean_ < REJECTION_THRESHOLD) {
+		// walk along the cumulative distribution until it exceeds a uniform number
+		double const u(random.uniform());
+		int k(0);
+		double probability(exp_minus_mean_);
+		double cumulative(probability);
+		while (u > cumulative and probability > 0.0) {
+			++k;
+			probability *= mean_ / k;
+			cumulative += probability;
+		}
+		return k;
+	}
+
+	while (true) {
+		double const u(random.uniform() - 0.5);
+		double const v(random.uniform());
+		double const us(0.5 - std::fabs(u));
+		long const k(std::floor((2 * a_ / us + b_) * u + mean_ + 0.43));
+
+		if (us >= 0.07 and v <= v_r_) {
+			return k;
+		}
+		if (k < 0 or (us < 0.013 and v > us)) {
+			continue;
+		}
+		if (std::log(v) + std::log(inverse_alpha_) - std::log(a_ / (us * us) + b_)
+			<= -mean_ + k * log_mean_ - std::lgamma(k + 1.0)) {
+			return k;
+		}
+	}
+}
@@ -0,0 +1,85 @@
+/*! \class CounterRandom
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Counter-based random numbers (Philox4x32-10, Salmon et al. 2011).
+ *  \details The numbers of a stream are a pure function of a key and a counter: the background noise
+ *  \details of a neuron at a time step can be drawn by whichever thread updates it, in any order,
+ *  \details and still be the same in every run with the same seed.
+ */
+
+#ifndef COUNTERRANDOM_H
+#define COUNTERRANDOM_H
+
+#include <cstdint>
+
+class CounterRandom
+{
+	private :
+
+		/*! \brief The key, derived from the seed */
+		uint32_t key_[2];
+
+		/*! \brief The counter: stream identifiers in the high words, position in the stream in the low word */
+		uint32_t counter_[4];
+
+		/*! \brief Output of the last block, consumed one word at a time */
+		uint32_t block_[4];
+
+		/*! \brief Number of words of block_ already consumed */
+		unsigned int used_;
+
+		/*! \brief Computes the block of the current counter and advances the counter */
+		void next_block();
+
+	public :
+
+		/*! \brief Constructor
+		 * @param[in] seed the seed of the simulation
+		 * @param[in] stream first identifier of the stream, e.g. the index of a neuron
+		 * @param[in] substream second identifier of the stream, e.g. the time step
+		 */
+		CounterRandom(uint64_t seed, uint32_t stream, uint32_t substream);
+
+		/*! \brief Returns the next 32 random bits of the stream */
+		uint32_t next();
+
+		/*! \brief Returns the next number of the stream, uniformly distributed in [0, 1) */
+		double uniform();
+};
+
+/*! \class PoissonSampler
+ *  \brief Draws Poisson distributed numbers from a CounterRandom stream.
+ *  \details Small means use the inversion of the cumulative distribution, large ones the transformed
+ *  \details rejection of Hörmann (1993). The constants depending on the mean are computed once.
+ */
+class PoissonSampler
+{
+	private :
+
+		/*! \brief Mean of the distribution */
+		double mean_;
+
+		/*! \brief Probability of 0, for the inversion */
+		double exp_minus_mean_;
+
+		/*! \brief Constants of the transformed rejection */
+		double log_mean_, a_, b_, inverse_alpha_, v_r_;
+
+	public :
+
+		/*! \brief Constructor
+		 * @param[in] mean the mean of the distribution, positive or 0
+		 */
+		explicit PoissonSampler(double mean = 1.0);
+
+		/*! \brief Returns the mean of the distribution */
+		double mean() const;
+
+		/*! \brief Draws a number from the stream */
+		int operator()(CounterRandom& random) const;
+};
+
+#endif /* CounterRandom_hpp */
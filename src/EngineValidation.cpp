@@ -0,0 +1,246 @@
+#include "EngineValidation.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include "Cortex.hpp"
+#include "Neuron.hpp"
+
+namespace {
+
+/*! Mean and standard deviation of counts */
+void moments(std::vector<int> const& counts, double& mean, double& deviation)
+{
+	mean = 0;
+	deviation = 0;
+	if (counts.empty()) {
+		return;
+	}
+	for (int const count : counts) {
+		mean += count;
+	}
+	mean /= counts.size();
+	for (int const count : counts) {
+		deviation += (count - mean) * (count - mean);
+	}
+	deviation = std::sqrt(deviation / counts.size());
+}
+
+/*! Largest distance between the empirical distribution functions of two samples */
+double ks_distance(std::vector<int> first, std::vector<int> second)
+{
+	std::sort(first.begin(), first.end());
+	std::sort(second.begin(), second.end());
+	double distance(0);
+	size_t i(0), j(0);
+	while (i < first.size() and j < second.size()) {
+		int const value(std::min(first[i], second[j]));
+		while (i < first.size() and first[i] == value) {
+			++i;
+		}
+		while (j < second.size() and second[j] == value) {
+			++j;
+		}
+		distance = std::max(distance, std::fabs(double(i) / first.size() - double(j) / second.size()));
+	}
+	return distance;
+}
+
+bool within(double reference, double candidate, double tolerance)
+{
+	return std::fabs(candidate - reference) <= tolerance * std::fabs(reference);
+}
+
+}
+
+EngineSpec parse_engine(std::string const& name)
+{
+	EngineSpec engine {name, 1, false};
+	if (name == "sequential") {
+		return engine;
+	}
+
+	size_t const colon(name.find(':'));
+	std::string const kind(name.substr(0, colon));
+	if (colon == std::string::npos or (kind != "parallel" and kind != "deterministic")) {
+		throw std::runtime_error("unknown engine " + name + ", expected sequential, parallel:<threads> or deterministic:<threads>");
+	}
+	char* end(nullptr);
+	long const threads(std::strtol(name.c_str() + colon + 1, &end, 10));
+	if (end == name.c_str() + colon + 1 or *end != '\0' or threads < 1) {
+		throw std::runtime_error("invalid number of threads in engine " + name);
+	}
+	engine.threads = threads;
+	engine.deterministic = (kind == "deterministic");
+	return engine;
+}
+
+bool can_be_identical(EngineSpec const& reference, EngineSpec const& candidate)
+{
+	if (reference.deterministic or candidate.deterministic) {
+		return reference.deterministic and candidate.deterministic;
+	}
+	// the workers of the parallel engine add the inputs in the order in which they steal the deliveries
+	return reference.name == "sequential" and candidate.name == "sequential";
+}
+
+EngineValidation::EngineValidation(NetworkParameters const& parameters, EngineSpec const& reference, EngineSpec const& candidate)
+	: parameters_(parameters), reference_(reference), candidate_(candidate)
+{}
+
+void EngineValidation::start(EngineSpec const& engine) const
+{
+	Cortex::reset();
+	Cortex::set_write_files(false);
+	Cortex::set_threads(engine.threads, std::vector<int>());
+	Cortex::set_deterministic(engine.deterministic, parameters_.seed);
+
+	std::default_random_engine generator(parameters_.seed);
+	double const external_input_frequency(parameters_.ratio * parameters_.time_step * THRESHOLD_POTENTIAL
+										  / (parameters_.excitatory_amplitude * TAU));
+	std::poisson_distribution<int> distribution(external_input_frequency);
+	Cortex(parameters_.relative_inhibitory_amplitude, parameters_.excitatory_amplitude, parameters_.number_of_neurons,
+		   false, parameters_.time_step, distribution, generator);
+	Cortex::initialize_neurons();
+}
+
+std::vector<EngineValidation::NeuronState> EngineValidation::snapshot()
+{
+	std::vector<NeuronState> states;
+	for (unsigned int i(0); i < Cortex::get_number_of_local_neurons(); ++i) {
+		Neuron const& neuron(Cortex::get_local_neuron(i));
+		states.push_back({neuron.get_potential(), neuron.get_current_input(), neuron.get_next_input(),
+						  neuron.get_synaptic_current(), neuron.get_adaptation(), neuron.get_last_spike()});
+	}
+	return states;
+}
+
+void EngineValidation::trace(EngineSpec const& engine, int steps, std::vector<uint64_t>& hashes, std::vector<int>& spikes) const
+{
+	start(engine);
+	hashes.clear();
+	spikes.clear();
+	for (int t(0); t < steps; ++t) {
+		Cortex::update(t);
+		hashes.push_back(Cortex::state_hash());
+		spikes.push_back(Cortex::get_step_spike_sum());
+	}
+}
+
+void EngineValidation::count_spikes(EngineSpec const& engine, int steps, int burn_in, std::vector<int>& population, std::vector<int>& neurons) const
+{
+	start(engine);
+	population.clear();
+	neurons.assign(Cortex::get_number_of_local_neurons(), 0);
+	for (int t(0); t < steps; ++t) {
+		Cortex::update(t);
+		if (t < burn_in) {
+			continue;
+		}
+		population.push_back(Cortex::get_step_spike_sum());
+		for (size_t i(0); i < neurons.size(); ++i) {
+			if (Cortex::get_local_neuron(i).get_last_spike() == t) {
+				++neurons[i];
+			}
+		}
+	}
+}
+
+ExactReport EngineValidation::compare_exact(int steps) const
+{
+	ExactReport report {true, -1, -1, "", 0, 0, 0, 0};
+
+	std::vector<uint64_t> hashes;
+	std::vector<int> spikes;
+	trace(reference_, steps, hashes, spikes);
+
+	start(candidate_);
+	for (int t(0); t < steps; ++t) {
+		Cortex::update(t);
+		int const candidate_spikes(Cortex::get_step_spike_sum());
+		if (Cortex::state_hash() == hashes[t] and candidate_spikes == spikes[t]) {
+			continue;
+		}
+
+		report.equivalent = false;
+		report.step = t;
+		report.reference_spikes = spikes[t];
+		report.candidate_spikes = candidate_spikes;
+
+		// run the reference up to the same step again to find out which neuron differs
+		std::vector<NeuronState> const candidate_states(snapshot());
+		start(reference_);
+		for (int s(0); s <= t; ++s) {
+			Cortex::update(s);
+		}
+		std::vector<NeuronState> const reference_states(snapshot());
+
+		for (size_t i(0); i < reference_states.size() and report.neuron < 0; ++i) {
+			NeuronState const& reference(reference_states[i]);
+			NeuronState const& candidate(candidate_states[i]);
+			if (reference.potential != candidate.potential) {
+				report.variable = "potential";
+				report.reference_value = reference.potential;
+				report.candidate_value = candidate.potential;
+			} else if (reference.current_input != candidate.current_input) {
+				report.variable = "current input";
+				report.reference_value = reference.current_input;
+				report.candidate_value = candidate.current_input;
+			} else if (reference.next_input != candidate.next_input) {
+				report.variable = "next input";
+				report.reference_value = reference.next_input;
+				report.candidate_value = candidate.next_input;
+			} else if (reference.synaptic_current != candidate.synaptic_current) {
+				report.variable = "synaptic current";
+				report.reference_value = reference.synaptic_current;
+				report.candidate_value = candidate.synaptic_current;
+			} else if (reference.adaptation != candidate.adaptation) {
+				report.variable = "adaptation";
+				report.reference_value = reference.adaptation;
+				report.candidate_value = candidate.adaptation;
+			} else if (reference.last_spike != candidate.last_spike) {
+				report.variable = "last spike";
+				report.reference_value = reference.last_spike;
+				report.candidate_value = candidate.last_spike;
+			} else {
+				continue;
+			}
+			report.neuron = i;
+		}
+		break;
+	}
+
+	Cortex::reset();
+	return report;
+}
+
+StatisticalReport EngineValidation::compare_statistics(int steps, int burn_in, double tolerance) const
+{
+	if (burn_in >= steps) {
+		throw std::runtime_error("the burn-in has to be shorter than the simulation");
+	}
+
+	std::vector<int> reference_population, reference_neurons, candidate_population, candidate_neurons;
+	count_spikes(reference_, steps, burn_in, reference_population, reference_neurons);
+	count_spikes(candidate_, steps, burn_in, candidate_population, candidate_neurons);
+	Cortex::reset();
+
+	StatisticalReport report;
+	double reference_mean, candidate_mean;
+	moments(reference_population, reference_mean, report.reference_deviation);
+	moments(candidate_population, candidate_mean, report.candidate_deviation);
+
+	// spikes per neuron and per step -> Hz
+	double const to_rate(1000.0 / (parameters_.number_of_neurons * parameters_.time_step));
+	report.reference_rate = reference_mean * to_rate;
+	report.candidate_rate = candidate_mean * to_rate;
+
+	report.ks_distance = ks_distance(reference_neurons, candidate_neurons);
+	report.ks_critical = KS_CRITICAL_COEFFICIENT * std::sqrt(2.0 / parameters_.number_of_neurons);
+
+	report.equivalent = within(report.reference_rate, report.candidate_rate, tolerance)
+						and within(report.reference_deviation, report.candidate_deviation, tolerance)
+						and report.ks_distance <= report.ks_critical;
+	return report;
+}
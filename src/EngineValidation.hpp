@@ -0,0 +1,136 @@
+/*! \class EngineValidation
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Compares a candidate engine with the reference engine on the same network and seed.
+ *  \details An engine is a way of running the Cortex: "sequential" is the original single-threaded code,
+ *  \details "parallel:<threads>" the worker pool and "deterministic:<threads>" the worker pool with
+ *  \details counter-based noise and fixed-point inputs.
+ *  \details The exact comparison checks a hash of the state of all neurons and the population spike
+ *  \details count after every time step, and reports the first diverging step and neuron.
+ *  \details The statistical comparison is for engines which aren't meant to be bitwise identical:
+ *  \details it compares the mean rate, the fluctuations of the population activity and the
+ *  \details distribution of the rates of the single neurons.
+ *  \details The engines run one after the other, as the Cortex only exists once per process.
+ */
+
+#ifndef ENGINEVALIDATION_H
+#define ENGINEVALIDATION_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*! Critical value of the two-sample Kolmogorov-Smirnov test at the 0.1% level, times sqrt(2 / n) */
+constexpr double KS_CRITICAL_COEFFICIENT (1.95);
+
+/*! \brief An engine, as named on the command line */
+struct EngineSpec
+{
+	std::string name;
+	unsigned int threads;
+	bool deterministic;
+};
+
+/*! \brief Parses "sequential", "parallel:<threads>" or "deterministic:<threads>"
+ *  \throw runtime_error if the name isn't one of those
+ */
+EngineSpec parse_engine(std::string const& name);
+
+/*! \brief Returns whether two engines can go through bitwise identical states
+ *  \details Only the deterministic engines, whatever their numbers of threads, and two sequential engines draw the
+ *  \details same noise and add the inputs in the same order. The other pairs differ from the first step on and
+ *  \details are compared statistically.
+ */
+bool can_be_identical(EngineSpec const& reference, EngineSpec const& candidate);
+
+/*! \brief The network both engines simulate */
+struct NetworkParameters
+{
+	double relative_inhibitory_amplitude;
+	double excitatory_amplitude;
+	/*! Ratio between the external frequency and the threshold frequency */
+	double ratio;
+	unsigned int number_of_neurons;
+	/*! [ms] */
+	double time_step;
+	unsigned long seed;
+};
+
+/*! \brief Outcome of an exact comparison */
+struct ExactReport
+{
+	bool equivalent;
+	/*! First step after which the engines differ, -1 if they don't */
+	int step;
+	/*! First neuron whose state differs after step, -1 if only the spike counts differ */
+	int neuron;
+	/*! The first differing variable of neuron */
+	std::string variable;
+	double reference_value, candidate_value;
+	int reference_spikes, candidate_spikes;
+};
+
+/*! \brief Outcome of a statistical comparison */
+struct StatisticalReport
+{
+	bool equivalent;
+	/*! Mean firing rates [Hz] */
+	double reference_rate, candidate_rate;
+	/*! Standard deviations of the number of spikes per time step */
+	double reference_deviation, candidate_deviation;
+	/*! Kolmogorov-Smirnov distance between the rates of the single neurons, and its critical value */
+	double ks_distance, ks_critical;
+};
+
+class EngineValidation
+{
+	private :
+
+		/*! \brief State of a neuron, in the order in which the variables are compared */
+		struct NeuronState
+		{
+			double potential, current_input, next_input, synaptic_current, adaptation;
+			int last_spike;
+		};
+
+		NetworkParameters const parameters_;
+		EngineSpec const reference_, candidate_;
+
+		/*! \brief Builds the network and prepares the Cortex to run it with engine */
+		void start(EngineSpec const& engine) const;
+
+		/*! \brief Returns the states of all neurons of the running engine */
+		static std::vector<NeuronState> snapshot();
+
+		/*! \brief Runs engine for steps time steps, recording the hash and the spike count after each of them */
+		void trace(EngineSpec const& engine, int steps, std::vector<uint64_t>& hashes, std::vector<int>& spikes) const;
+
+		/*! \brief Runs engine for steps time steps, recording the spike counts of the population and of each neuron after burn_in steps */
+		void count_spikes(EngineSpec const& engine, int steps, int burn_in, std::vector<int>& population, std::vector<int>& neurons) const;
+
+	public :
+
+		/*! \brief Constructor
+		 * @param[in] parameters the network
+		 * @param[in] reference the engine taken as the truth
+		 * @param[in] candidate the engine to validate
+		 */
+		EngineValidation(NetworkParameters const& parameters, EngineSpec const& reference, EngineSpec const& candidate);
+
+		/*! \brief Checks that both engines go through the same states
+		 * @param[in] steps the number of time steps to compare
+		 */
+		ExactReport compare_exact(int steps) const;
+
+		/*! \brief Checks that both engines produce the same activity up to statistical noise
+		 * @param[in] steps the number of time steps to simulate
+		 * @param[in] burn_in the number of initial time steps left out of the statistics
+		 * @param[in] tolerance the accepted relative difference of the rates and of the fluctuations
+		 */
+		StatisticalReport compare_statistics(int steps, int burn_in, double tolerance) const;
+};
+
+#endif /* EngineValidation_hpp */
@@ -0,0 +1,188 @@
+#include "MeanField.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include "Neuron.hpp"
+#include "Cortex.hpp"
+
+namespace {
+
+constexpr double PI (3.141592653589793);
+
+/*! Number of intervals of the Simpson integration of Siegert's formula */
+constexpr int SIEGERT_INTERVALS (2000);
+
+/*! Step of the integration of the coefficient of variation */
+constexpr double CV_STEP (1e-3);
+
+/*! Lower bound of the inner integral of the coefficient of variation, whose integrand vanishes below */
+constexpr double CV_CUTOFF (-10.0);
+
+/*! Distance of the threshold to the mean in standard deviations from which the spikes are taken as Poisson */
+constexpr double POISSON_LIMIT (15.0);
+
+/*! Lowest positive rate and number of rates of the grid bracketing the stationary states [Hz] */
+constexpr double LOWEST_RATE (0.01);
+constexpr int GRID_POINTS (400);
+
+constexpr int BISECTIONS (60);
+
+/*! exp(x^2) erfc(x), without overflow for large x */
+double erfcx(double x)
+{
+	if (x < 25.0) {
+		return std::exp(x * x) * std::erfc(x);
+	}
+	// asymptotic expansion
+	double const inverse_square(1.0 / (x * x));
+	return (1.0 - 0.5 * inverse_square + 0.75 * inverse_square * inverse_square) / (x * std::sqrt(PI));
+}
+
+/*! exp(y^2) (1 + erf(y))^2 */
+double cv_integrand(double y)
+{
+	if (y < 0) {
+		double const scaled(erfcx(-y));
+		return scaled * scaled * std::exp(-y * y);
+	}
+	double const sum(1.0 + std::erf(y));
+	return std::exp(y * y) * sum * sum;
+}
+
+}
+
+MeanField::MeanField(double relative_inhibitory_amplitude, double excitatory_amplitude, double ratio, unsigned int number_of_neurons)
+	: relative_inhibitory_amplitude_(relative_inhibitory_amplitude), excitatory_amplitude_(excitatory_amplitude),
+	  excitatory_inputs_(CONNECTION_PROBABILITY * number_of_neurons * (1.0 - INHIBITORY_PROPORTION)),
+	  inhibitory_inputs_(CONNECTION_PROBABILITY * number_of_neurons * INHIBITORY_PROPORTION),
+	  background_rate_(excitatory_amplitude > 0 ? ratio * THRESHOLD_POTENTIAL / (excitatory_amplitude * TAU) : 0),
+	  refractory_time_(REFRACTORY_PERIOD * DEFAULT_TIME_STEP)
+{
+	if (excitatory_amplitude <= 0 or ratio < 0 or relative_inhibitory_amplitude < 0) {
+		throw std::runtime_error("the mean field needs a positive excitatory amplitude, and a positive or zero ratio and relative amplitude");
+	}
+}
+
+void MeanField::input(double rate, double& mean, double& deviation) const
+{
+	double const network_rate(rate / 1000.0);
+	double const g(relative_inhibitory_amplitude_);
+	mean = excitatory_amplitude_ * TAU
+		   * ((excitatory_inputs_ - g * inhibitory_inputs_) * network_rate + background_rate_);
+	deviation = excitatory_amplitude_
+				* std::sqrt(TAU * ((excitatory_inputs_ + g * g * inhibitory_inputs_) * network_rate + background_rate_));
+}
+
+double MeanField::siegert(double mean, double deviation) const
+{
+	if (deviation == 0.0) {
+		// deterministic integrate-and-fire
+		if (mean <= THRESHOLD_POTENTIAL) {
+			return 0.0;
+		}
+		return 1000.0 / (refractory_time_ + TAU * std::log((mean - RESET_POTENTIAL) / (mean - THRESHOLD_POTENTIAL)));
+	}
+
+	// 1 / rate = refractory time + tau sqrt(pi) integral of exp(u^2) (1 + erf(u)) from (V_r - mu) / sigma to (theta - mu) / sigma
+	double const lower((RESET_POTENTIAL - mean) / deviation);
+	double const upper((THRESHOLD_POTENTIAL - mean) / deviation);
+	double const step((upper - lower) / SIEGERT_INTERVALS);
+	double integral(erfcx(-lower) + erfcx(-upper));
+	for (int i(1); i < SIEGERT_INTERVALS; ++i) {
+		integral += (i % 2 == 0 ? 2.0 : 4.0) * erfcx(-(lower + i * step));
+	}
+	integral *= step / 3.0;
+	return 1000.0 / (refractory_time_ + TAU * std::sqrt(PI) * integral);
+}
+
+double MeanField::transfer(double rate) const
+{
+	double mean, deviation;
+	input(rate, mean, deviation);
+	return siegert(mean, deviation);
+}
+
+double MeanField::cv(double rate) const
+{
+	double mean, deviation;
+	input(rate, mean, deviation);
+	if (deviation == 0.0) {
+		return 0.0;
+	}
+	double const lower((RESET_POTENTIAL - mean) / deviation);
+	double const upper((THRESHOLD_POTENTIAL - mean) / deviation);
+	if (upper > POISSON_LIMIT) {
+		return 1.0;
+	}
+
+	// CV^2 = 2 pi (rate tau)^2 integral from lower to upper of exp(x^2) integral from -inf to x of exp(y^2) (1 + erf(y))^2
+	double inner(0.0);
+	double const start(std::min(lower, CV_CUTOFF));
+	int const inner_steps(std::ceil((lower - start) / CV_STEP));
+	double const inner_step(inner_steps > 0 ? (lower - start) / inner_steps : 0.0);
+	for (int i(0); i < inner_steps; ++i) {
+		double const y(start + i * inner_step);
+		inner += 0.5 * inner_step * (cv_integrand(y) + cv_integrand(y + inner_step));
+	}
+
+	int const outer_steps(std::max(1.0, std::ceil((upper - lower) / CV_STEP)));
+	double const outer_step((upper - lower) / outer_steps);
+	double outer(0.0);
+	double previous(std::exp(lower * lower) * inner);
+	for (int i(0); i < outer_steps; ++i) {
+		double const x(lower + i * outer_step);
+		inner += 0.5 * outer_step * (cv_integrand(x) + cv_integrand(x + outer_step));
+		double const current(std::exp((x + outer_step) * (x + outer_step)) * inner);
+		outer += 0.5 * outer_step * (previous + current);
+		previous = current;
+	}
+
+	double const rate_tau(transfer(rate) / 1000.0 * TAU);
+	return std::sqrt(2.0 * PI * rate_tau * rate_tau * outer);
+}
+
+std::vector<MeanFieldState> MeanField::solve() const
+{
+	// rates from 0 to just below the inverse of the refractory period
+	double const highest_rate(1000.0 / refractory_time_ * (1.0 - 1e-9));
+	std::vector<double> rates {0.0};
+	for (int i(0); i < GRID_POINTS; ++i) {
+		rates.push_back(LOWEST_RATE * std::pow(highest_rate / LOWEST_RATE, double(i) / (GRID_POINTS - 1)));
+	}
+
+	std::vector<MeanFieldState> states;
+	double left(rates[0]);
+	double left_excess(transfer(left) - left);
+	for (size_t i(1); i < rates.size(); ++i) {
+		double right(rates[i]);
+		double const right_excess(transfer(right) - right);
+		if ((left_excess > 0) == (right_excess > 0)) {
+			left = right;
+			left_excess = right_excess;
+			continue;
+		}
+
+		// the state is stable if the transfer falls below the rate when the rate increases
+		bool const stable(left_excess > 0);
+		double low(left), high(right);
+		for (int j(0); j < BISECTIONS; ++j) {
+			double const middle(0.5 * (low + high));
+			if ((transfer(middle) - middle > 0) == (left_excess > 0)) {
+				low = middle;
+			} else {
+				high = middle;
+			}
+		}
+
+		MeanFieldState state;
+		state.rate = 0.5 * (low + high);
+		state.cv = cv(state.rate);
+		input(state.rate, state.mean_input, state.input_deviation);
+		state.stable = stable;
+		states.push_back(state);
+
+		left = right;
+		left_excess = right_excess;
+	}
+	return states;
+}
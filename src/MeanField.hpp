@@ -0,0 +1,81 @@
+/*! \class MeanField
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Predicts the stationary activity of the network from its parameters (Brunel 2000).
+ *  \details In the diffusion approximation, a neuron receiving K_E excitatory and K_I inhibitory inputs
+ *  \details at the rate nu of the network, plus the background input, sees a Gaussian input of mean mu(nu)
+ *  \details and standard deviation sigma(nu). Its firing rate is then given by Siegert's formula
+ *  \details phi(mu, sigma), and the rates of the asynchronous states are the solutions of nu = phi(mu(nu), sigma(nu)).
+ *  \details Such a state is stable against slow changes of the rate if phi crosses nu from above.
+ *  \details The synchronous regimes of the network are instabilities of these states against oscillations,
+ *  \details which this stationary analysis doesn't see.
+ */
+
+#ifndef MEANFIELD_H
+#define MEANFIELD_H
+
+#include <vector>
+
+/*! \brief A stationary state of the network */
+struct MeanFieldState
+{
+	/*! Firing rate of the neurons [Hz] */
+	double rate;
+	/*! Coefficient of variation of the interspike intervals */
+	double cv;
+	/*! Mean and standard deviation of the free membrane potential [mV] */
+	double mean_input, input_deviation;
+	/*! Whether the state is stable against slow changes of the rate */
+	bool stable;
+};
+
+class MeanField
+{
+	private :
+
+		double const relative_inhibitory_amplitude_;
+		double const excitatory_amplitude_;
+
+		/*! \brief Mean numbers of excitatory and inhibitory inputs of a neuron */
+		double const excitatory_inputs_, inhibitory_inputs_;
+
+		/*! \brief Rate of the background spikes of a neuron [1/ms] */
+		double const background_rate_;
+
+		/*! \brief Refractory period [ms] */
+		double const refractory_time_;
+
+		/*! \brief Rate given by Siegert's formula for a Gaussian input [Hz]
+		 * @param[in] mean, deviation the mean and the standard deviation of the free potential [mV]
+		 */
+		double siegert(double mean, double deviation) const;
+
+	public :
+
+		/*! \brief Constructor
+		 * @param[in] relative_inhibitory_amplitude the relative amplitude of the inhibitory spikes, g
+		 * @param[in] excitatory_amplitude the amplitude of the excitatory spikes, J [mV]
+		 * @param[in] ratio the ratio between the background frequency and the threshold frequency
+		 * @param[in] number_of_neurons the number of neurons of the network
+		 */
+		MeanField(double relative_inhibitory_amplitude, double excitatory_amplitude, double ratio, unsigned int number_of_neurons);
+
+		/*! \brief Mean and standard deviation of the free potential of a neuron when the network fires at rate [Hz] */
+		void input(double rate, double& mean, double& deviation) const;
+
+		/*! \brief Firing rate of a neuron when the network fires at rate [Hz] */
+		double transfer(double rate) const;
+
+		/*! \brief Coefficient of variation of the interspike intervals of a neuron when the network fires at rate [Hz] */
+		double cv(double rate) const;
+
+		/*! \brief Returns the stationary states of the network, by increasing rate
+		 *  \details The solutions of transfer(nu) = nu are bracketed on a logarithmic grid of rates and bisected.
+		 */
+		std::vector<MeanFieldState> solve() const;
+};
+
+#endif /* MeanField_hpp */
@@ -0,0 +1,72 @@
+#include "Multimeter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "Neuron.hpp"
+
+namespace {
+
+/*! Sorts the neurons and removes the duplicates */
+std::vector<unsigned int> sorted(std::vector<unsigned int> neurons)
+{
+	std::sort(neurons.begin(), neurons.end());
+	neurons.erase(std::unique(neurons.begin(), neurons.end()), neurons.end());
+	if (neurons.empty()) {
+		throw std::runtime_error("the multimeter has to sample at least one neuron");
+	}
+	return neurons;
+}
+
+/*! Number of time steps between two samples */
+int interval_steps(double interval, double time_step)
+{
+	int const steps(std::lround(interval / time_step));
+	if (steps < 1) {
+		throw std::runtime_error("the interval of the multimeter has to be at least one time step long");
+	}
+	return steps;
+}
+
+}
+
+Multimeter::Multimeter(std::string const& file_name, std::vector<unsigned int> const& neurons, double time_step, double interval)
+	: neurons_(sorted(neurons)), time_step_(time_step), interval_steps_(interval_steps(interval, time_step)),
+	  row_(1 + 2 * neurons_.size()), file_(file_name, "f4", sizeof(float), 1 + 2 * neurons_.size())
+{}
+
+bool Multimeter::samples(int step) const
+{
+	return step % interval_steps_ == 0;
+}
+
+void Multimeter::sample(int step, std::vector<Neuron*> const& neurons)
+{
+	size_t const count(neurons_.size());
+	row_[0] = step * time_step_;
+	for (size_t i(0); i < count; ++i) {
+		Neuron const& neuron(*neurons[neurons_[i]]);
+		row_[1 + i] = neuron.get_potential();
+		row_[1 + count + i] = neuron.get_current_input();
+	}
+	file_.append(row_.data());
+}
+
+void Multimeter::close()
+{
+	file_.close();
+}
+
+std::vector<unsigned int> const& Multimeter::neurons() const
+{
+	return neurons_;
+}
+
+std::uint64_t Multimeter::rows() const
+{
+	return file_.rows();
+}
+
+std::string const& Multimeter::file_name() const
+{
+	return file_.file_name();
+}
@@ -0,0 +1,72 @@
+/*! \class Multimeter
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Records the membrane potential and the input of a subset of the neurons at a fixed interval.
+ *  \details At each sampled time step, the potentials and the inputs of the neurons are gathered into one row of
+ *  \details single precision numbers: the time [ms], the potentials [mV], then the inputs received in the time step [mV].
+ *  \details The rows are appended to a .npy array, which writes them in batches of NPY_BUFFER_SIZE bytes, so that
+ *  \details hundreds of neurons can be sampled at every time step for the cost of a copy.
+ */
+
+#ifndef MULTIMETER_H
+#define MULTIMETER_H
+
+#include <vector>
+#include <string>
+#include "NpyExport.hpp"
+
+class Neuron;
+
+/*! Default interval between two samples [ms] */
+constexpr double DEFAULT_MULTIMETER_INTERVAL (1.0);
+
+class Multimeter
+{
+	private :
+
+		/*! \brief Sampled neurons, in increasing order */
+		std::vector<unsigned int> neurons_;
+
+		double const time_step_;
+		int const interval_steps_;
+
+		/*! \brief The row being gathered */
+		std::vector<float> row_;
+
+		NpyWriter file_;
+
+	public :
+
+		/*! \brief Constructor, creates the file
+		 * @param[in] file_name the name of the .npy file
+		 * @param[in] neurons the indexes of the sampled neurons
+		 * @param[in] time_step the time step of the simulation [ms]
+		 * @param[in] interval the interval between two samples [ms]
+		 * \throw runtime_error if there is no neuron, the interval is shorter than the time step or the file can't be opened
+		 */
+		Multimeter(std::string const& file_name, std::vector<unsigned int> const& neurons, double time_step, double interval);
+
+		/*! \brief Returns whether a time step is sampled */
+		bool samples(int step) const;
+
+		/*! \brief Appends the row of a time step, once the neurons have been updated
+		 * @param[in] step the time step
+		 * @param[in] neurons the neurons of the network, at least up to the largest sampled index
+		 */
+		void sample(int step, std::vector<Neuron*> const& neurons);
+
+		/*! \brief Writes the last rows and the final header of the file */
+		void close();
+
+		std::vector<unsigned int> const& neurons() const;
+
+		/*! \brief Returns the number of rows written */
+		std::uint64_t rows() const;
+
+		std::string const& file_name() const;
+};
+
+#endif /* Multimeter_hpp */
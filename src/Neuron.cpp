@@ -5,20 +5,78 @@
 #include <cmath>
 #include "Cortex.hpp"
 
-double Neuron::exponential_const;
+double Neuron::exponential_const(exp(-DEFAULT_TIME_STEP / TAU));
+NeuronModel Neuron::model_(NeuronModel::lif_delta);
+double Neuron::tau_syn_(DEFAULT_TAU_SYN);
+bool Neuron::default_propagators_(true);
+int Neuron::refractory_steps_(REFRACTORY_PERIOD);
+int Neuron::delay_steps_(TRANSMISSION_DELAY);
+bool Neuron::precise_(false);
+double Neuron::step_over_tau_(DEFAULT_TIME_STEP / TAU);
+double Neuron::refractory_(REFRACTORY_PERIOD);
+double Neuron::delay_(TRANSMISSION_DELAY);
 
-Neuron::Neuron(double amplitude, std::vector<unsigned short int> const& connections)
+constexpr double DefaultPropagators::membrane;
+constexpr double DefaultPropagators::current;
+constexpr double DefaultPropagators::inverse_tau_syn;
+constexpr double DefaultPropagators::current_to_potential;
+constexpr double DefaultPropagators::adaptation;
+constexpr double DefaultPropagators::adaptation_to_potential;
+
+double RuntimePropagators::membrane(DefaultPropagators::membrane);
+double RuntimePropagators::current(DefaultPropagators::current);
+double RuntimePropagators::inverse_tau_syn(DefaultPropagators::inverse_tau_syn);
+double RuntimePropagators::current_to_potential(DefaultPropagators::current_to_potential);
+double RuntimePropagators::adaptation(DefaultPropagators::adaptation);
+double RuntimePropagators::adaptation_to_potential(DefaultPropagators::adaptation_to_potential);
+
+namespace {
+
+/*! Number of time steps of a period given in time steps of DEFAULT_TIME_STEP, rounded if it is about a whole number */
+double exact_steps_of(double default_steps, double timestep)
+{
+	double const steps(default_steps * DEFAULT_TIME_STEP / timestep);
+	double const rounded(std::round(steps));
+	return std::fabs(steps - rounded) > 1e-6 ? steps : rounded;
+}
+
+/*! Number of time steps of a period given in time steps of DEFAULT_TIME_STEP, -1 if it isn't a whole number */
+int steps_of(double default_steps, double timestep)
+{
+	double const steps(exact_steps_of(default_steps, timestep));
+	return steps == std::round(steps) ? static_cast<int>(steps) : -1;
+}
+
+/*! Updates a neuron with the model of all neurons and the given propagators */
+template <typename Propagators>
+bool update_with_model(Neuron& neuron, int t)
+{
+	switch (Neuron::get_model()) {
+		case NeuronModel::lif_delta :
+			return neuron.update_with<LifDelta<Propagators> >(t);
+		case NeuronModel::lif_exponential :
+			return neuron.update_with<LifExponential<Propagators> >(t);
+		case NeuronModel::adaptive_lif :
+			return neuron.update_with<AdaptiveLif<Propagators> >(t);
+	}
+	return false;
+}
+
+}
+
+Neuron::Neuron(double amplitude, std::vector<unsigned short int> const& connections, bool distributed)
 	: potential_(RESTING_POTENTIAL), current_input_(0), next_input_(0), connection_indexes_(connections), 
-	  amplitude_(amplitude), last_spike_(-100), is_observed_(false)
+	  amplitude_(amplitude), last_spike_(-100), synaptic_current_(0), adaptation_(0), spike_offset_(0), send_step_(-1),
+	  arrival_offset_(0), is_observed_(false)
 {
-	assert(!connections.empty());
-	exponential_const = exp(-Cortex::timestep_/(TAU));
+	assert(distributed or !connections.empty());
 }
 
 Neuron::Neuron (Neuron const& neuron)
 	:potential_(neuron.potential_), current_input_(neuron.current_input_), next_input_(neuron.next_input_), 
 	connection_indexes_(neuron.connection_indexes_), amplitude_(neuron.amplitude_), last_spike_(neuron.last_spike_), 
-	is_observed_(neuron.is_observed_)
+	synaptic_current_(neuron.synaptic_current_), adaptation_(neuron.adaptation_), spike_offset_(neuron.spike_offset_),
+	send_step_(neuron.send_step_), arrival_offset_(neuron.arrival_offset_), is_observed_(neuron.is_observed_)
 	
 {}
 
@@ -31,41 +89,27 @@ void Neuron::reset_input() {
 	next_input_ = 0;
 }
 
-void Neuron::update (int t)
+bool Neuron::update (int t)
 {
-	assert(t >= 0);
-
-	bool sent_spike(false);
-
-	// It is time for the neuron to actually send (in the code) its spike to its connected neurons
-	if (t == (last_spike_ + TRANSMISSION_DELAY - 1)) {
-		// due to the management of incoming spikes using next_input and current_input 
-		// (spikes sent in the previous timestep are received in the current timestep),
-		// the spike won't be received until the next timestep, so we subtract the transmission delay by 1
-		send_spike();
-		sent_spike = true;
+	if (default_propagators_) {
+		return update_with_model<DefaultPropagators>(*this, t);
 	}
-
-	// Neuron is not in the refractory period
-	if (t >= (last_spike_ + REFRACTORY_PERIOD)) {
-		if (is_activated()) {
-			// reached threshold potential in the previous timestep
-			reset(t);
-		} else {
-			// didn't reach threshold potential --> update potential normally
-			update_potential();
-		}
-	}
-	
-	// If the neuron is one of the 50 observed neurons, it will notify the Cortex whether it sent a spike or not
-	notify_cortex(sent_spike);
+	return update_with_model<RuntimePropagators>(*this, t);
 }
 
 void Neuron::update_potential() {
-	// multiply by exp(-timestep/TAU)
-	potential_ *= exponential_const; 
-	// add incoming inputs (both background and cortical)
-	potential_ += current_input_ ;
+	// the model integrates the inputs of the time step (background and cortical)
+	switch (model_) {
+		case NeuronModel::lif_delta :
+			LifDelta<RuntimePropagators>::integrate(potential_, synaptic_current_, adaptation_, current_input_);
+			break;
+		case NeuronModel::lif_exponential :
+			LifExponential<RuntimePropagators>::integrate(potential_, synaptic_current_, adaptation_, current_input_);
+			break;
+		case NeuronModel::adaptive_lif :
+			AdaptiveLif<RuntimePropagators>::integrate(potential_, synaptic_current_, adaptation_, current_input_);
+			break;
+	}
 }
 
 bool Neuron::is_activated () const
@@ -92,9 +136,14 @@ double Neuron::get_amplitude() const
 
 void Neuron::send_spike()
 {
-	Cortex::send_spike(connection_indexes_, amplitude_);
-	// notify the cortex that a spike was sent
-	Cortex::increment_spike_sum();
+	// the spike is counted by the Cortex, which updates the neurons population by population
+	Cortex::send_spike(connection_indexes_, precise_ ? amplitude_ * offset_decay(arrival_offset_) : amplitude_);
+}
+
+void Neuron::cross_threshold(int t, double offset)
+{
+	spike_offset_ = offset;
+	schedule_spike(t + 1, offset, send_step_, arrival_offset_);
 }
 
 void Neuron::sum_input (double input_from_cortex)
@@ -112,6 +161,135 @@ void Neuron::notify_cortex(bool spike_send)
 	}
 }
 
+int Neuron::get_last_spike() const
+{
+	return last_spike_;
+}
+
+double Neuron::get_potential() const
+{
+	return potential_;
+}
+
+double Neuron::get_current_input() const
+{
+	return current_input_;
+}
+
+double Neuron::get_next_input() const
+{
+	return next_input_;
+}
+
+double Neuron::get_synaptic_current() const
+{
+	return synaptic_current_;
+}
+
+double Neuron::get_adaptation() const
+{
+	return adaptation_;
+}
+
+void Neuron::set_model(NeuronModel model, double tau_syn)
+{
+	if (tau_syn <= 0) {
+		throw std::runtime_error("the time constant of the synaptic current has to be positive");
+	}
+	model_ = model;
+	tau_syn_ = tau_syn;
+}
+
+NeuronModel Neuron::get_model()
+{
+	return model_;
+}
+
+bool Neuron::has_default_propagators()
+{
+	return default_propagators_;
+}
+
+void Neuron::set_time_step(double timestep)
+{
+	assert(timestep > 0);
+	double const refractory(exact_steps_of(REFRACTORY_PERIOD, timestep));
+	double const delay(exact_steps_of(TRANSMISSION_DELAY, timestep));
+	if (precise_) {
+		// the spikes are timed between the grid points
+		if (refractory < 1 or delay < 1) {
+			throw std::runtime_error("the refractory period and the transmission delay have to last at least one time step");
+		}
+	} else {
+		if (steps_of(REFRACTORY_PERIOD, timestep) < 0 or steps_of(TRANSMISSION_DELAY, timestep) < 0) {
+			throw std::runtime_error("the refractory period and the transmission delay have to be multiples of the time step, unless the spike times are precise");
+		}
+		if (delay < 2) {
+			throw std::runtime_error("the transmission delay has to last at least two time steps");
+		}
+	}
+	refractory_ = refractory;
+	delay_ = delay;
+	refractory_steps_ = std::ceil(refractory);
+	delay_steps_ = std::ceil(delay);
+
+	exponential_const = exp(-timestep / TAU);
+	step_over_tau_ = timestep / TAU;
+
+	RuntimePropagators::membrane = exponential_const;
+	RuntimePropagators::current = exp(-timestep / tau_syn_);
+	RuntimePropagators::inverse_tau_syn = 1.0 / tau_syn_;
+	RuntimePropagators::current_to_potential = current_to_potential(timestep, TAU, tau_syn_, RuntimePropagators::membrane,
+																	RuntimePropagators::current);
+	RuntimePropagators::adaptation = exp(-timestep / ADAPTATION_TAU);
+	RuntimePropagators::adaptation_to_potential = current_to_potential(timestep, TAU, ADAPTATION_TAU, RuntimePropagators::membrane,
+																	   RuntimePropagators::adaptation);
+	default_propagators_ = (timestep == DEFAULT_TIME_STEP and tau_syn_ == DEFAULT_TAU_SYN);
+}
+
+int Neuron::get_delay_steps()
+{
+	return delay_steps_;
+}
+
+int Neuron::get_send_steps()
+{
+	// a precise spike arrives up to one step before delay_ steps after the reset, and is sent two steps before it arrives
+	return precise_ ? static_cast<int>(std::floor(delay_)) - 2 : delay_steps_ - 1;
+}
+
+double Neuron::get_spike_offset() const
+{
+	return spike_offset_;
+}
+
+void Neuron::set_precise(bool precise)
+{
+	if (precise and model_ == NeuronModel::lif_exponential) {
+		throw std::runtime_error("precise spike times are only available with delta synapses");
+	}
+	precise_ = precise;
+}
+
+bool Neuron::is_precise()
+{
+	return precise_;
+}
+
+double Neuron::offset_decay(double offset)
+{
+	return exp(-offset * step_over_tau_);
+}
+
+void Neuron::schedule_spike(int last_spike, double offset, int& send_step, double& arrival_offset)
+{
+	// the inputs of a step arrive by its end, and are received in the step before
+	double const arrival(last_spike - offset + delay_);
+	double const arrival_step(std::ceil(arrival));
+	send_step = static_cast<int>(arrival_step) - 2;
+	arrival_offset = arrival_step - arrival;
+}
+
 bool Neuron::is_observed() const {
 	return is_observed_;
 }
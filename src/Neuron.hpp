@@ -16,6 +16,8 @@
 #define NEURON_H
 
 #include <vector>
+#include <cassert>
+#include "NeuronModel.hpp"
 #ifdef TEST
 #include <gtest/gtest.h>
 #endif
@@ -27,11 +29,9 @@ constexpr double THRESHOLD_POTENTIAL (20);
 constexpr double RESET_POTENTIAL (10);
 /*! Vr [V] */
 constexpr double RESTING_POTENTIAL (0);
-/*! tau = membrane resistance * capacitor [ms] */
-constexpr double TAU (20.0);
-/*! Refractory period [ms] */
+/*! Refractory period [time steps of DEFAULT_TIME_STEP] */
 constexpr double REFRACTORY_PERIOD(20);
-/*! Transmission delay [ms] */
+/*! Transmission delay [time steps of DEFAULT_TIME_STEP] */
 constexpr double TRANSMISSION_DELAY(15);
 
 class Neuron
@@ -48,6 +48,11 @@ class Neuron
 		FRIEND_TEST (Cortex_Test, update);
 		FRIEND_TEST (Cortex_Test, send_spike);
 		FRIEND_TEST (Cortex_Test, initialize_neuron_types);
+		FRIEND_TEST (Cortex_Test, update_in_parallel);
+		FRIEND_TEST (Cortex_Test, deterministic_update);
+		FRIEND_TEST (Cortex_Test, population_sums);
+		FRIEND_TEST (Neuron_Test, neuron_models);
+		FRIEND_TEST (Neuron_Test, precise_spike_time);
                 #endif
 
 		/*!  \brief The potential in the neuron's membrane */
@@ -72,6 +77,45 @@ class Neuron
 		/*! Constant used to update potential, = exp(-timestep/tau) where tau = membrane resistance * capacitor
 		 */
 		static double exponential_const;
+
+		/*! \brief The synaptic current of the lif_exponential model [mV/ms] */
+		double synaptic_current_;
+
+		/*! \brief The adaptation current of the adaptive_lif model [mV/ms] */
+		double adaptation_;
+
+		/*! \brief The model of all neurons */
+		static NeuronModel model_;
+
+		/*! \brief Time constant of the synaptic current [ms] */
+		static double tau_syn_;
+
+		/*! \brief Whether the time step and the parameters are the defaults, whose propagators are compile-time constants */
+		static bool default_propagators_;
+
+		/*! \brief Refractory period and transmission delay in time steps of the simulation */
+		static int refractory_steps_, delay_steps_;
+
+		/*! \brief Whether the spikes are timed by the interpolated time the threshold was crossed */
+		static bool precise_;
+
+		/*! \brief Time step divided by TAU */
+		static double step_over_tau_;
+
+		/*! \brief Refractory period and transmission delay in time steps, not necessarily whole, for precise spike times */
+		static double refractory_, delay_;
+
+		/*! \brief How long before last_spike_ the threshold was crossed [time steps], in [0, 1)
+		 *  \details Linear interpolation of the potential over the step in which it crossed the threshold.
+		 *  \details Always 0 unless the spike times are precise.
+		 */
+		double spike_offset_;
+
+		/*! \brief Time step in which the last spike is sent, and how long before the end of the step after it it arrives [time steps]
+		 *  \details Only used with precise spike times.
+		 */
+		int send_step_;
+		double arrival_offset_;
 		
 		/*! Tells if this instance is a neuron that is going to be observed. */
 		bool is_observed_;
@@ -97,14 +141,26 @@ class Neuron
 		 */
 		void update_potential() ;
 
+		/*! \brief Same as update_with(), with precise spike times
+		 *  \details The refractory period ends between two grid points, refractory_ steps after the crossing, and the
+		 *  \details neuron integrates the rest of that step, as a fraction of its input. The spike is sent so as to reach
+		 *  \details its targets delay_ steps after the crossing, in the step it actually arrives in.
+		 */
+		template <typename Model>
+		bool update_precise_with(int t);
+
+		/*! \brief Records that the threshold was crossed offset steps before the grid point t + 1, and when to send the spike */
+		void cross_threshold(int t, double offset);
+
 
 	public :
 
 		/*! \brief Constructor
 		 *  \details Initializes a Neuron.
-		 * 			 The connections vector should not be empty.
+		 * 			 The connections vector is empty only if all targets are simulated by other ranks.
+		 * @param[in] distributed whether the targets may all be simulated by other ranks, leaving the connections empty
 		 */
-		Neuron(double amplitude, std::vector<unsigned short int> const& connections);
+		Neuron(double amplitude, std::vector<unsigned short int> const& connections, bool distributed = false);
 
 		/*! \brief Constructor of copy
 		 *  \details It copies the value of \a potential_ and \a connexion_number_ but not the value of \a input_ nor \a last_spike_.
@@ -124,9 +180,17 @@ class Neuron
 		 * 			 	If the Neuron reaches the threshold potential, it sets the potential to \a RESTING_POTENTIAL.
 		 * 			 	If it cannot be activated, it recalculcates its potential
 		 *  @param[in] t the current time
+		 *  @return whether the neuron sent a spike, which the caller counts
 		 *  \throw invalid_argument detects an error if the time is negative.
 		 */
-		void update(int t);
+		bool update(int t);
+
+		/*! \brief Same as update(), with the model resolved at compile time
+		 *  \details Model is one of the policies of NeuronModel.hpp, matching get_model().
+		 *  @param[in] t the current time
+		 */
+		template <typename Model>
+		bool update_with(int t);
 
 		/*! \brief Sums the inputs from the Cortex */
 		void sum_input(double input_from_cortex);
@@ -142,6 +206,79 @@ class Neuron
 		 */
 		void reset_input();
 		
+		/*! \brief Returns the time at which the Neuron last reached the threshold potential */
+		int get_last_spike() const;
+
+		/*! \brief Returns the membrane potential \a potential_ */
+		double get_potential() const;
+
+		/*! \brief Returns the input \a current_input_ of the current time step */
+		double get_current_input() const;
+
+		/*! \brief Returns the input \a next_input_ received for the next time step */
+		double get_next_input() const;
+
+		/*! \brief Returns the synaptic current of the lif_exponential model */
+		double get_synaptic_current() const;
+
+		/*! \brief Returns the adaptation current of the adaptive_lif model */
+		double get_adaptation() const;
+
+		/*! \brief Sets the model of all neurons
+		 *  \details Has to be called before set_time_step(), which computes the propagators.
+		 * @param[in] model the model
+		 * @param[in] tau_syn the time constant of the synaptic current [ms], only used by lif_exponential
+		 *  \throw runtime_error if tau_syn isn't positive
+		 */
+		static void set_model(NeuronModel model, double tau_syn);
+
+		/*! \brief Returns the model of all neurons */
+		static NeuronModel get_model();
+
+		/*! \brief Whether the propagators are those of DefaultPropagators */
+		static bool has_default_propagators();
+
+		/*! \brief Sets the time step of all neurons
+		 *  \details Computes the propagators and converts the refractory period and the transmission delay into time steps.
+		 * @param[in] timestep the time step [ms]
+		 *  \throw runtime_error if the refractory period and the transmission delay aren't multiples of the time step,
+		 *  \throw or if the transmission delay is shorter than two time steps. With precise spike times, they only have
+		 *  \throw to last at least one time step.
+		 */
+		static void set_time_step(double timestep);
+
+		/*! \brief Returns the transmission delay in time steps of the simulation, rounded up with precise spike times */
+		static int get_delay_steps();
+
+		/*! \brief Returns the least number of time steps between the reset of a neuron, at get_last_spike(), and the step in which it sends its spike */
+		static int get_send_steps();
+
+		/*! \brief Returns how long before get_last_spike() the threshold was crossed [time steps] */
+		double get_spike_offset() const;
+
+		/*! \brief Sets whether the spikes of all neurons are timed by when the threshold was crossed within the time step
+		 *  \details The neuron is still reset and recorded on the grid, at get_last_spike(), but its refractory period
+		 *  \details and the arrival of its spike are counted from the crossing. The refractory period and the delay then
+		 *  \details don't have to be multiples of the time step. The inputs of a step are added at its end, so that a spike
+		 *  \details arriving arrival_offset steps earlier is scaled by offset_decay(arrival_offset).
+		 *  \details Has to be called after set_model() and before set_time_step().
+		 *  \throw runtime_error with exponential synapses, whose early inputs also charge the membrane before the grid point
+		 */
+		static void set_precise(bool precise);
+
+		/*! \brief Returns whether the spikes are timed by the time at which the threshold was crossed */
+		static bool is_precise();
+
+		/*! \brief Returns the factor exp(-offset timestep / TAU) by which a spike arriving offset steps before the end of a step is scaled */
+		static double offset_decay(double offset);
+
+		/*! \brief Computes when a spike with precise time is sent, and how early in the following step it arrives
+		 * @param[in] last_spike, offset the step in which the neuron was reset, and how long before it the threshold was crossed
+		 * @param[out] send_step the time step in which the spike is sent, whose inputs the targets integrate in the next one
+		 * @param[out] arrival_offset how long before the end of the step the spike is integrated in it arrives [time steps]
+		 */
+		static void schedule_spike(int last_spike, double offset, int& send_step, double& arrival_offset);
+
 		/*! \brief Getter for whether the neuron is observed */
 		bool is_observed() const;
 	
@@ -149,5 +286,86 @@ class Neuron
 		void set_observed(bool is_observed);
 };
 
+template <typename Model>
+inline bool Neuron::update_with(int t)
+{
+	assert(t >= 0);
+	if (precise_) {
+		return update_precise_with<Model>(t);
+	}
+
+	bool sent_spike(false);
+
+	// It is time for the neuron to actually send (in the code) its spike to its connected neurons
+	if (t == (last_spike_ + delay_steps_ - 1)) {
+		// the spike is received in the next timestep, so we subtract the transmission delay by 1
+		send_spike();
+		sent_spike = true;
+	}
+
+	// Neuron is not in the refractory period
+	if (t >= (last_spike_ + refractory_steps_)) {
+		if (is_activated()) {
+			// reached threshold potential in the previous timestep
+			reset(t);
+			Model::on_spike(adaptation_);
+			Model::integrate_refractory(synaptic_current_, adaptation_, current_input_);
+		} else {
+			Model::integrate(potential_, synaptic_current_, adaptation_, current_input_);
+		}
+	} else {
+		Model::integrate_refractory(synaptic_current_, adaptation_, current_input_);
+	}
+
+	// If the neuron is one of the 50 observed neurons, it will notify the Cortex whether it sent a spike or not
+	notify_cortex(sent_spike);
+	return sent_spike;
+}
+
+template <typename Model>
+inline bool Neuron::update_precise_with(int t)
+{
+	bool sent_spike(false);
+	if (t == send_step_) {
+		send_spike();
+		sent_spike = true;
+	}
+
+	if (is_activated()) {
+		// crossed the threshold in the previous step
+		reset(t);
+		Model::on_spike(adaptation_);
+	}
+
+	// the step integrates the time from t to t + 1, in steps, the refractory period ends refractory_ steps after the crossing
+	double const refractory_end(last_spike_ - spike_offset_ + refractory_);
+	if (t + 1 <= refractory_end) {
+		Model::integrate_refractory(synaptic_current_, adaptation_, current_input_);
+	} else {
+		double const previous_potential(potential_);
+		double fraction(1.0);
+		if (t < refractory_end) {
+			// free from the end of the refractory period on, with the share of the input of the step arriving by then
+			fraction = t + 1 - refractory_end;
+			Model::integrate_refractory(synaptic_current_, adaptation_, current_input_);
+			potential_ = potential_ * offset_decay(fraction) + fraction * current_input_;
+		} else {
+			Model::integrate(potential_, synaptic_current_, adaptation_, current_input_);
+		}
+		if (potential_ >= THRESHOLD_POTENTIAL) {
+			// the many inputs of a step make the potential rise about linearly over the step
+			cross_threshold(t, fraction * (potential_ - THRESHOLD_POTENTIAL) / (potential_ - previous_potential));
+			if (t == send_step_) {
+				// the delay is shorter than two steps, the spike reaches its targets in the next one
+				send_spike();
+				sent_spike = true;
+			}
+		}
+	}
+
+	notify_cortex(sent_spike);
+	return sent_spike;
+}
+
 
 #endif /* Neuron_hpp */
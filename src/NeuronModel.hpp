@@ -0,0 +1,142 @@
+/*! \file NeuronModel.hpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Neuron models as policies of the update loop, resolved at compile time.
+ *  \details A model integrates the state of a neuron over one time step below the threshold
+ *  \details (integrate), during the refractory period (integrate_refractory), and reacts to a spike (on_spike).
+ *  \details The models are templates over the source of their propagators: DefaultPropagators holds
+ *  \details compile-time constants for the default time step and parameters, RuntimePropagators the values
+ *  \details computed by Neuron::set_time_step() for any other. The Cortex picks the model and the
+ *  \details propagators once per time step and runs a loop specialized for them, so that there is
+ *  \details neither a virtual call nor a branch on the model per neuron.
+ */
+
+#ifndef NEURONMODEL_H
+#define NEURONMODEL_H
+
+/*! Default time step of the simulation [ms] */
+constexpr double DEFAULT_TIME_STEP (0.1);
+/*! tau = membrane resistance * capacitor [ms] */
+constexpr double TAU (20.0);
+/*! Default time constant of the exponential synaptic current [ms] */
+constexpr double DEFAULT_TAU_SYN (0.5);
+/*! Time constant of the adaptation current of the adaptive model [ms] */
+constexpr double ADAPTATION_TAU (100.0);
+/*! Increase of the adaptation current at each spike of the adaptive model [mV/ms] */
+constexpr double ADAPTATION_JUMP (0.02);
+
+/*! The models of the neurons */
+enum class NeuronModel
+{
+	/*! Leaky integrate-and-fire, the amplitude of a spike is added to the potential at once */
+	lif_delta,
+	/*! Leaky integrate-and-fire, a spike starts a synaptic current decaying exponentially */
+	lif_exponential,
+	/*! lif_delta with a current, increased by each spike, which decays slowly and hyperpolarizes the neuron */
+	adaptive_lif
+};
+
+/*! \brief Factor by which a current decaying with tau_current adds itself to a potential decaying with tau over a step
+ *  \details tau tau_current / (tau - tau_current) (exp(-step/tau) - exp(-step/tau_current)), step exp(-step/tau) if both are equal
+ */
+constexpr double current_to_potential(double step, double tau, double tau_current, double membrane_decay, double current_decay)
+{
+	return (tau == tau_current) ? step * membrane_decay
+								: tau * tau_current / (tau - tau_current) * (membrane_decay - current_decay);
+}
+
+/*! \brief Propagators of the default time step and parameters, known at compile time
+ *  \details The decays are exp(-step / tau) as std::exp() rounds them, written out to the last bit, so that
+ *  \details they are the same as the runtime propagators of the default time step: a series evaluated
+ *  \details in a constant expression can be off by one bit.
+ */
+struct DefaultPropagators
+{
+	/*! exp(-0.1 / 20) */
+	static constexpr double membrane = 0.99501247919268232;
+	/*! exp(-0.1 / 0.5) */
+	static constexpr double current = 0.81873075307798182;
+	static constexpr double inverse_tau_syn = 1.0 / DEFAULT_TAU_SYN;
+	static constexpr double current_to_potential = ::current_to_potential(DEFAULT_TIME_STEP, TAU, DEFAULT_TAU_SYN,
+																		   membrane, current);
+	/*! exp(-0.1 / 100) */
+	static constexpr double adaptation = 0.99900049983337502;
+	static constexpr double adaptation_to_potential = ::current_to_potential(DEFAULT_TIME_STEP, TAU, ADAPTATION_TAU,
+																			  membrane, adaptation);
+};
+
+/*! \brief Propagators of the time step and parameters chosen at run time, set by Neuron::set_time_step() */
+struct RuntimePropagators
+{
+	static double membrane;
+	static double current;
+	static double inverse_tau_syn;
+	static double current_to_potential;
+	static double adaptation;
+	static double adaptation_to_potential;
+};
+
+/*! \brief Leaky integrate-and-fire neuron with delta synapses */
+template <typename Propagators>
+struct LifDelta
+{
+	static void integrate(double& potential, double&, double&, double input)
+	{
+		potential = potential * Propagators::membrane + input;
+	}
+
+	static void integrate_refractory(double&, double&, double) {}
+
+	static void on_spike(double&) {}
+};
+
+/*! \brief Leaky integrate-and-fire neuron with exponential synaptic currents, integrated exactly (Rotter and Diesmann 1999)
+ *  \details A spike of amplitude J increases the current by J / tau_syn. The current also flows while the potential is clamped.
+ */
+template <typename Propagators>
+struct LifExponential
+{
+	static void integrate(double& potential, double& current, double&, double input)
+	{
+		current += input * Propagators::inverse_tau_syn;
+		potential = potential * Propagators::membrane + current * Propagators::current_to_potential;
+		current *= Propagators::current;
+	}
+
+	static void integrate_refractory(double& current, double&, double input)
+	{
+		current += input * Propagators::inverse_tau_syn;
+		current *= Propagators::current;
+	}
+
+	static void on_spike(double&) {}
+};
+
+/*! \brief Leaky integrate-and-fire neuron with delta synapses and a spike-triggered adaptation current
+ *  \details The adaptation current w decays with ADAPTATION_TAU, grows by ADAPTATION_JUMP at each spike,
+ *  \details and is subtracted from the derivative of the potential.
+ */
+template <typename Propagators>
+struct AdaptiveLif
+{
+	static void integrate(double& potential, double&, double& adaptation, double input)
+	{
+		potential = potential * Propagators::membrane - adaptation * Propagators::adaptation_to_potential + input;
+		adaptation *= Propagators::adaptation;
+	}
+
+	static void integrate_refractory(double&, double& adaptation, double)
+	{
+		adaptation *= Propagators::adaptation;
+	}
+
+	static void on_spike(double& adaptation)
+	{
+		adaptation += ADAPTATION_JUMP;
+	}
+};
+
+#endif /* NeuronModel_hpp */
@@ -0,0 +1,253 @@
+#include "neurosim.h"
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <tclap/ArgException.h>
+#include "Cortex.hpp"
+#include "CortexInitializer.hpp"
+
+static_assert(std::is_same<unsigned int, std::uint32_t>::value, "the spikes of a step are handed out as uint32_t");
+
+struct neurosim
+{
+	bool configured;
+	/*! Whether the simulation was stopped early, no step follows */
+	bool stopped;
+	int steps;
+	double time_step;
+	std::string error;
+};
+
+namespace {
+
+/*! The simulation of the process, the Cortex being static */
+neurosim* current(nullptr);
+
+/*! Sends the output of the simulation for the terminal into strings while it lives, the program has its own */
+class CapturedOutput
+{
+	private :
+
+		std::ostringstream out_, err_;
+		std::streambuf* const cout_;
+		std::streambuf* const cerr_;
+
+	public :
+
+		CapturedOutput()
+			: cout_(std::cout.rdbuf(out_.rdbuf())), cerr_(std::cerr.rdbuf(err_.rdbuf()))
+		{}
+
+		~CapturedOutput()
+		{
+			std::cout.rdbuf(cout_);
+			std::cerr.rdbuf(cerr_);
+		}
+
+		/*! \brief Returns what was written to std::cerr, else the lines of std::cout starting with "Error" */
+		std::string errors() const
+		{
+			if (!err_.str().empty()) {
+				return err_.str();
+			}
+			// the checks of the values of the flags print their errors among the parameters
+			std::istringstream lines(out_.str());
+			std::string line, errors;
+			while (std::getline(lines, line)) {
+				if (line.compare(0, 5, "Error") == 0) {
+					errors += line;
+				}
+			}
+			return errors;
+		}
+};
+
+bool has_flag(std::vector<std::string> const& flags, std::string const& short_name, std::string const& long_name)
+{
+	for (auto const& flag : flags) {
+		if ((!short_name.empty() and flag == short_name) or flag == long_name) {
+			return true;
+		}
+	}
+	return false;
+}
+
+}
+
+extern "C" {
+
+int neurosim_api_version(void)
+{
+	return NEUROSIM_API_VERSION;
+}
+
+neurosim* neurosim_create(void)
+{
+	if (current != nullptr) {
+		return nullptr;
+	}
+	current = new neurosim {false, false, 0, 0.0, ""};
+	return current;
+}
+
+int neurosim_configure(neurosim* simulation, int argc, char const* const* argv, double duration)
+{
+	if (simulation->configured) {
+		simulation->error = "the simulation is already configured";
+		return NEUROSIM_ERROR;
+	}
+	std::vector<std::string> flags {"neurosim"};
+	flags.insert(flags.end(), argv, argv + argc);
+	for (size_t i(1); i + 1 < flags.size(); ++i) {
+		// the other ranks would be forks of the program
+		if ((flags[i] == "-n" or flags[i] == "--Ranks") and flags[i + 1] != "1") {
+			simulation->error = "a simulation of the library runs in a single process, without --Ranks";
+			return NEUROSIM_ERROR;
+		}
+	}
+	if (has_flag(flags, "-r", "--Run")) {
+		simulation->error = "-r is implied";
+		return NEUROSIM_ERROR;
+	}
+	flags.insert(flags.end(), {"-r", "1"});
+	if (!has_flag(flags, "", "--Write_spikes")) {
+		flags.insert(flags.end(), {"--Write_spikes", "0"});
+	}
+	std::vector<char*> arguments;
+	for (auto& flag : flags) {
+		arguments.push_back(&flag[0]);
+	}
+
+	CapturedOutput const output;
+	try {
+		double time_step(0.1);
+		double predicted_rate(-1);
+		if (!initialize_cortex(arguments.size(), arguments.data(), time_step, std::lround(duration), predicted_rate, false)) {
+			simulation->error = output.errors().empty() ? "the flags were rejected" : output.errors();
+			Cortex::reset();
+			return NEUROSIM_ERROR;
+		}
+		Cortex::set_collect_step_spikes(true);
+		Cortex::initialize_neurons();
+		simulation->time_step = time_step;
+	} catch (TCLAP::ArgException const& error) {
+		simulation->error = "error: " + error.error() + " for arg " + error.argId();
+		Cortex::reset();
+		return NEUROSIM_ERROR;
+	} catch (TCLAP::ExitException const&) {
+		// --help or --version, printed into the captured output
+		simulation->error = "the flags ask for the usage or the version, which the library doesn't print";
+		Cortex::reset();
+		return NEUROSIM_ERROR;
+	} catch (std::exception const& error) {
+		simulation->error = error.what();
+		Cortex::reset();
+		return NEUROSIM_ERROR;
+	}
+	simulation->configured = true;
+	return NEUROSIM_OK;
+}
+
+int neurosim_step(neurosim* simulation)
+{
+	if (!simulation->configured) {
+		simulation->error = "the simulation isn't configured";
+		return NEUROSIM_ERROR;
+	}
+	if (simulation->stopped) {
+		return NEUROSIM_STOPPED;
+	}
+	try {
+		Cortex::update(simulation->steps);
+	} catch (std::exception const& error) {
+		simulation->error = error.what();
+		return NEUROSIM_ERROR;
+	}
+	++simulation->steps;
+	simulation->stopped = Cortex::get_activity_status() != ActivityStatus::running;
+	return simulation->stopped ? NEUROSIM_STOPPED : NEUROSIM_OK;
+}
+
+int neurosim_run_until(neurosim* simulation, double time)
+{
+	if (!simulation->configured) {
+		simulation->error = "the simulation isn't configured";
+		return NEUROSIM_ERROR;
+	}
+	long const end(std::lround(time / simulation->time_step));
+	int result(simulation->stopped ? NEUROSIM_STOPPED : NEUROSIM_OK);
+	while (result == NEUROSIM_OK and simulation->steps < end) {
+		result = neurosim_step(simulation);
+	}
+	return result;
+}
+
+int neurosim_get_spikes(neurosim const* simulation, uint32_t const** neurons, size_t* count)
+{
+	if (!simulation->configured) {
+		*neurons = nullptr;
+		*count = 0;
+		return NEUROSIM_ERROR;
+	}
+	std::vector<unsigned int> const& spikes(Cortex::get_step_spikes());
+	*neurons = spikes.data();
+	*count = spikes.size();
+	return NEUROSIM_OK;
+}
+
+int64_t neurosim_steps(neurosim const* simulation)
+{
+	return simulation->steps;
+}
+
+double neurosim_time(neurosim const* simulation)
+{
+	return simulation->steps * simulation->time_step;
+}
+
+double neurosim_time_step(neurosim const* simulation)
+{
+	return simulation->time_step;
+}
+
+uint32_t neurosim_number_of_neurons(neurosim const* simulation)
+{
+	return simulation->configured ? Cortex::get_number_of_neurons() : 0;
+}
+
+int64_t neurosim_total_spikes(neurosim const* simulation)
+{
+	return simulation->configured ? Cortex::get_total_spike_sum() : 0;
+}
+
+char const* neurosim_last_error(neurosim const* simulation)
+{
+	return simulation->error.c_str();
+}
+
+void neurosim_destroy(neurosim* simulation)
+{
+	if (simulation == nullptr) {
+		return;
+	}
+	if (simulation->configured) {
+		try {
+			Cortex::finish();
+		} catch (std::exception const&) {
+			// the recordings are closed as far as they can be, the network is freed anyway
+		}
+		Cortex::reset();
+		Cortex::set_collect_step_spikes(false);
+	}
+	if (simulation == current) {
+		current = nullptr;
+	}
+	delete simulation;
+}
+
+}
@@ -0,0 +1,153 @@
+#include "NpyExport.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+/*! Magic string and version 1.0 of the format */
+constexpr char NPY_MAGIC[8] = {'\x93', 'N', 'U', 'M', 'P', 'Y', 1, 0};
+
+/*! Byte order of the machine in the notation of NumPy, '|' standing for single bytes */
+char byte_order()
+{
+	std::uint16_t const one(1);
+	char first;
+	std::memcpy(&first, &one, 1);
+	return first == 1 ? '<' : '>';
+}
+
+}
+
+NpyWriter::NpyWriter(std::string const& file_name, std::string const& type, unsigned int element_size, unsigned int columns)
+	: file_name_(file_name), file_(file_name, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc),
+	  descr_((element_size == 1 ? '|' : byte_order()) + type), columns_(columns), row_size_(element_size * (columns > 0 ? columns : 1)),
+	  rows_(0), closed_(false)
+{
+	if (file_.fail()) {
+		throw std::runtime_error("file " + file_name + " couldn't be opened");
+	}
+	buffer_.reserve(NPY_BUFFER_SIZE + row_size_);
+	write_header();
+}
+
+NpyWriter::~NpyWriter()
+{
+	close();
+}
+
+void NpyWriter::write_header()
+{
+	std::string dictionary("{'descr': '" + descr_ + "', 'fortran_order': False, 'shape': (" + std::to_string(rows_) + ",");
+	if (columns_ > 0) {
+		dictionary += " " + std::to_string(columns_);
+	}
+	dictionary += "), }";
+
+	// magic, version and length of the dictionary, then the dictionary padded with spaces and ended by a newline
+	std::uint16_t const length(NPY_HEADER_SIZE - sizeof(NPY_MAGIC) - sizeof(std::uint16_t));
+	assert(dictionary.size() < length);
+	dictionary.resize(length - 1, ' ');
+	dictionary += '\n';
+
+	std::uint8_t const length_bytes[2] = {static_cast<std::uint8_t>(length & 0xFF), static_cast<std::uint8_t>(length >> 8)};
+	file_.seekp(0);
+	file_.write(NPY_MAGIC, sizeof(NPY_MAGIC));
+	file_.write(reinterpret_cast<char const*>(length_bytes), sizeof(length_bytes));
+	file_.write(dictionary.data(), dictionary.size());
+	file_.seekp(0, std::ofstream::end);
+}
+
+void NpyWriter::append(void const* row)
+{
+	assert(!closed_);
+	char const* const bytes(static_cast<char const*>(row));
+	buffer_.insert(buffer_.end(), bytes, bytes + row_size_);
+	++rows_;
+	if (buffer_.size() >= NPY_BUFFER_SIZE) {
+		file_.write(buffer_.data(), buffer_.size());
+		buffer_.clear();
+		write_header();
+		file_.flush();
+	}
+}
+
+void NpyWriter::close()
+{
+	if (closed_) {
+		return;
+	}
+	file_.write(buffer_.data(), buffer_.size());
+	buffer_.clear();
+	write_header();
+	file_.close();
+	closed_ = true;
+}
+
+std::uint64_t NpyWriter::rows() const
+{
+	return rows_;
+}
+
+std::string const& NpyWriter::file_name() const
+{
+	return file_name_;
+}
+
+NpyRecording::NpyRecording(std::string const& prefix, unsigned int observed_neurons, unsigned int populations)
+	: sums_(prefix + "sum_spikes.npy", "u4", sizeof(std::uint32_t), populations > 0 ? 1 + populations : 0),
+	  observed_(prefix + "spikes.npy", "u1", sizeof(std::uint8_t), (observed_neurons + 7) / 8),
+	  raster_(prefix + "raster.npy", "i4", sizeof(std::int32_t), 2),
+	  populations_(populations), sum_row_(1 + populations, 0), observed_neurons_(observed_neurons), observed_row_((observed_neurons + 7) / 8, 0), observed_count_(0)
+{}
+
+void NpyRecording::record_sum(long spikes, std::vector<long> const& population_spikes)
+{
+	assert(population_spikes.size() == populations_);
+	sum_row_[0] = spikes;
+	std::copy(population_spikes.begin(), population_spikes.end(), sum_row_.begin() + 1);
+	sums_.append(sum_row_.data());
+}
+
+void NpyRecording::record_observed(bool spiked)
+{
+	// the first neuron is the most significant bit of the first byte, like numpy.packbits
+	if (spiked) {
+		observed_row_[observed_count_ / 8] |= 0x80 >> (observed_count_ % 8);
+	}
+	++observed_count_;
+	if (observed_count_ == observed_neurons_) {
+		observed_.append(observed_row_.data());
+		std::fill(observed_row_.begin(), observed_row_.end(), 0);
+		observed_count_ = 0;
+	}
+}
+
+void NpyRecording::record_spike(unsigned int neuron, int step)
+{
+	std::int32_t const row[2] = {static_cast<std::int32_t>(neuron), step};
+	raster_.append(row);
+}
+
+void NpyRecording::close()
+{
+	sums_.close();
+	observed_.close();
+	raster_.close();
+}
+
+NpyWriter const& NpyRecording::sums() const
+{
+	return sums_;
+}
+
+NpyWriter const& NpyRecording::observed() const
+{
+	return observed_;
+}
+
+NpyWriter const& NpyRecording::raster() const
+{
+	return raster_;
+}
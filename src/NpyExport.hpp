@@ -0,0 +1,122 @@
+/*! \file NpyExport.hpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Recordings of the simulation written as NumPy .npy arrays, which analysis tools map into memory without parsing.
+ *  \details The header of an array is padded to NPY_HEADER_SIZE bytes, so that the data always starts at the same
+ *  \details offset and the header can be rewritten in place with the number of rows written so far. It is rewritten
+ *  \details whenever the buffered rows are written, so that the file of a running simulation can already be read.
+ */
+
+#ifndef NPYEXPORT_H
+#define NPYEXPORT_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+/*! Size of the header of the arrays, a multiple of 64 bytes as NumPy recommends */
+constexpr unsigned int NPY_HEADER_SIZE (128);
+
+/*! Number of bytes buffered before they are written */
+constexpr unsigned int NPY_BUFFER_SIZE (1 << 16);
+
+class NpyWriter
+{
+	private :
+
+		std::string const file_name_;
+		std::ofstream file_;
+
+		/*! \brief Type of the elements in the notation of NumPy, e.g. "<u4" */
+		std::string const descr_;
+
+		/*! \brief Number of columns, 0 for a one-dimensional array, and bytes of a row */
+		unsigned int const columns_, row_size_;
+
+		std::uint64_t rows_;
+		std::vector<char> buffer_;
+		bool closed_;
+
+		/*! \brief Writes the header for the rows written so far at the beginning of the file */
+		void write_header();
+
+	public :
+
+		/*! \brief Constructor, creates the file and writes the header of an empty array
+		 * @param[in] file_name the name of the file
+		 * @param[in] type the type of the elements, without the byte order, e.g. "u4" or "u1"
+		 * @param[in] element_size the number of bytes of an element
+		 * @param[in] columns the number of columns, 0 for a one-dimensional array
+		 * \throw runtime_error if the file can't be opened
+		 */
+		NpyWriter(std::string const& file_name, std::string const& type, unsigned int element_size, unsigned int columns);
+
+		/*! \brief Destructor, closes the file */
+		~NpyWriter();
+
+		/*! \brief Appends a row, row_size bytes in the byte order of the machine */
+		void append(void const* row);
+
+		/*! \brief Writes the buffered rows and the final header, nothing can be appended afterwards */
+		void close();
+
+		std::uint64_t rows() const;
+
+		std::string const& file_name() const;
+};
+
+/*! \brief The recordings of a simulation as .npy arrays
+ *  \details The spike sums as a uint32 array with one element per time step, or one row of the sum followed by the
+ *  \details sums of the populations if these are recorded, the observed neurons as a uint8
+ *  \details array with one row of bits per time step, packed as numpy.packbits does, and the spikes of all local
+ *  \details neurons as an int32 array with one (neuron, time step) row per spike.
+ */
+class NpyRecording
+{
+	private :
+
+		NpyWriter sums_, observed_, raster_;
+
+		/*! \brief Number of populations whose sums follow the sum of a time step, 0 if none */
+		unsigned int const populations_;
+		std::vector<std::uint32_t> sum_row_;
+
+		/*! \brief Number of observed neurons, and the bits of the current time step */
+		unsigned int const observed_neurons_;
+		std::vector<std::uint8_t> observed_row_;
+		unsigned int observed_count_;
+
+	public :
+
+		/*! \brief Constructor, creates the three files
+		 * @param[in] prefix the beginning of the names of the files, followed by "sum_spikes.npy", "spikes.npy" and "raster.npy"
+		 * @param[in] observed_neurons the number of observed neurons
+		 * @param[in] populations the number of populations whose sums are recorded, 0 for a one-dimensional array of sums
+		 * \throw runtime_error if a file can't be opened
+		 */
+		NpyRecording(std::string const& prefix, unsigned int observed_neurons, unsigned int populations = 0);
+
+		/*! \brief Records the number of spikes of the network in the next time step
+		 * @param[in] population_spikes the numbers of spikes of the populations, as many as given to the constructor
+		 */
+		void record_sum(long spikes, std::vector<long> const& population_spikes = std::vector<long>());
+
+		/*! \brief Records whether the next observed neuron spiked, in the order of the neurons, time step after time step */
+		void record_observed(bool spiked);
+
+		/*! \brief Records a spike of a neuron */
+		void record_spike(unsigned int neuron, int step);
+
+		/*! \brief Writes the buffered rows and the final headers of the three files */
+		void close();
+
+		NpyWriter const& sums() const;
+		NpyWriter const& observed() const;
+		NpyWriter const& raster() const;
+};
+
+#endif /* NpyExport_hpp */
@@ -0,0 +1,87 @@
+#include "Numa.hpp"
+#include <cstdlib>
+#include <stdexcept>
+#include <sstream>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+// flags of get_mempolicy(2), see <linux/mempolicy.h>
+#define NUMA_MPOL_F_NODE (1 << 0)
+#define NUMA_MPOL_F_ADDR (1 << 1)
+
+std::vector<int> parse_cpu_list(std::string const& cpu_list)
+{
+	std::vector<int> cpus;
+	std::stringstream list(cpu_list);
+	std::string item;
+
+	while (std::getline(list, item, ',')) {
+		if (item.empty()) {
+			throw std::runtime_error("empty entry in CPU list " + cpu_list);
+		}
+		char* end(nullptr);
+		long first = std::strtol(item.c_str(), &end, 10);
+		long last(first);
+		if (*end == '-') {
+			char const* range_end(end + 1);
+			last = std::strtol(range_end, &end, 10);
+			if (end == range_end) {
+				throw std::runtime_error("invalid range " + item + " in CPU list " + cpu_list);
+			}
+		}
+		if (end == item.c_str() or *end != '\0' or first < 0 or last < first) {
+			throw std::runtime_error("invalid entry " + item + " in CPU list " + cpu_list);
+		}
+		for (long cpu(first); cpu <= last; ++cpu) {
+			cpus.push_back(cpu);
+		}
+	}
+	return cpus;
+}
+
+bool pin_current_thread(int cpu)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+int current_cpu()
+{
+	return sched_getcpu();
+}
+
+int node_of_cpu(int cpu)
+{
+	if (cpu < 0) {
+		return -1;
+	}
+	// the node of a CPU appears as a nodeN entry in its sysfs directory
+	std::string path("/sys/devices/system/cpu/cpu" + std::to_string(cpu));
+	DIR* directory = opendir(path.c_str());
+	if (directory == nullptr) {
+		return -1;
+	}
+	int node(-1);
+	while (dirent* entry = readdir(directory)) {
+		std::string name(entry->d_name);
+		if (name.size() > 4 and name.compare(0, 4, "node") == 0) {
+			node = std::atoi(name.c_str() + 4);
+			break;
+		}
+	}
+	closedir(directory);
+	// machines without NUMA support have a single node
+	return node < 0 ? 0 : node;
+}
+
+int node_of_address(void const* address)
+{
+	int node(-1);
+	long result = syscall(SYS_get_mempolicy, &node, nullptr, 0, const_cast<void*>(address), NUMA_MPOL_F_NODE | NUMA_MPOL_F_ADDR);
+	return result == 0 ? node : -1;
+}
@@ -0,0 +1,40 @@
+/*! \file Numa.hpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Helpers to pin threads to cores and to find out on which NUMA node memory lives.
+ *  \details On Linux, memory is placed on the node of the thread which first writes it (first touch).
+ *  \details Worker threads therefore allocate and initialize the data they own themselves,
+ *  \details and these helpers let the simulation check and report where it ended up.
+ */
+
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <string>
+#include <vector>
+
+/*! \brief Parses a CPU list such as "0-3,8,10-11".
+ * @param[in] cpu_list comma separated CPU numbers or ranges, may be empty
+ * \return the CPU numbers in the order given
+ * \throw runtime_error if the list is malformed
+ */
+std::vector<int> parse_cpu_list(std::string const& cpu_list);
+
+/*! \brief Pins the calling thread to one CPU.
+ * \return true on success
+ */
+bool pin_current_thread(int cpu);
+
+/*! \brief Returns the CPU the calling thread is running on, -1 if unknown */
+int current_cpu();
+
+/*! \brief Returns the NUMA node of a CPU, -1 if unknown */
+int node_of_cpu(int cpu);
+
+/*! \brief Returns the NUMA node holding the page of an address, -1 if unknown or not yet touched */
+int node_of_address(void const* address);
+
+#endif /* Numa_hpp */
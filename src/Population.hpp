@@ -0,0 +1,24 @@
+/*! \file Population.hpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief A population of the network, a range of neurons whose spikes are also counted apart from the others.
+ *  \details By default the network has two populations, the inhibitory neurons, which come first, and the
+ *  \details excitatory ones.
+ */
+
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include <string>
+
+struct Population
+{
+	std::string name;
+	/*! Global index of the first neuron and of the one after the last */
+	unsigned int first, end;
+};
+
+#endif /* Population_hpp */
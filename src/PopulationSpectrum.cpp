@@ -0,0 +1,137 @@
+#include "PopulationSpectrum.hpp"
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr double PI (3.141592653589793);
+
+}
+
+void fft(std::vector<std::complex<double> >& data, std::vector<std::complex<double> > const& twiddles)
+{
+	size_t const n(data.size());
+
+	// bit-reversal permutation
+	for (size_t i(1), j(0); i < n; ++i) {
+		size_t bit(n >> 1);
+		for (; j & bit; bit >>= 1) {
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j) {
+			std::swap(data[i], data[j]);
+		}
+	}
+
+	// butterflies of growing length
+	for (size_t length(2); length <= n; length <<= 1) {
+		size_t const stride(n / length);
+		for (size_t start(0); start < n; start += length) {
+			for (size_t k(0); k < length / 2; ++k) {
+				std::complex<double> const odd(data[start + k + length / 2] * twiddles[k * stride]);
+				data[start + k + length / 2] = data[start + k] - odd;
+				data[start + k] += odd;
+			}
+		}
+	}
+}
+
+PopulationSpectrum::PopulationSpectrum(unsigned int number_of_neurons, double time_step, unsigned int segment)
+	: segment_(segment), number_of_neurons_(number_of_neurons), time_step_(time_step),
+	  to_rate_(1000.0 / (number_of_neurons * time_step)),
+	  rates_(segment, 0.0), recorded_(0), rate_sum_(0), window_(segment), window_norm_(0),
+	  power_sum_(segment / 2 + 1, 0.0), segments_(0), buffer_(segment), twiddles_(segment / 2)
+{
+	if (segment < 4 or (segment & (segment - 1)) != 0) {
+		throw std::runtime_error("the segments of the spectrum have to be a power of two of time steps, at least 4");
+	}
+	for (unsigned int i(0); i < segment; ++i) {
+		window_[i] = 0.5 * (1.0 - std::cos(2.0 * PI * i / segment));
+		window_norm_ += window_[i] * window_[i];
+	}
+	for (unsigned int k(0); k < segment / 2; ++k) {
+		twiddles_[k] = std::polar(1.0, -2.0 * PI * k / segment);
+	}
+}
+
+void PopulationSpectrum::record(int spikes)
+{
+	rates_[recorded_ % segment_] = spikes * to_rate_;
+	rate_sum_ += spikes * to_rate_;
+	++recorded_;
+	// a segment ends every half segment, once the first one is full
+	if (recorded_ >= segment_ and (recorded_ - segment_) % (segment_ / 2) == 0) {
+		add_segment();
+	}
+}
+
+void PopulationSpectrum::add_segment()
+{
+	// the oldest rate of the ring comes first
+	unsigned int const first(recorded_ % segment_);
+	double mean(0.0);
+	for (double const rate : rates_) {
+		mean += rate;
+	}
+	mean /= segment_;
+	for (unsigned int i(0); i < segment_; ++i) {
+		buffer_[i] = window_[i] * (rates_[(first + i) % segment_] - mean);
+	}
+
+	fft(buffer_, twiddles_);
+
+	// one-sided power density: the negative frequencies are folded onto the positive ones
+	for (unsigned int k(0); k <= segment_ / 2; ++k) {
+		double const fold((k == 0 or k == segment_ / 2) ? 1.0 : 2.0);
+		power_sum_[k] += fold * std::norm(buffer_[k]);
+	}
+	++segments_;
+}
+
+double PopulationSpectrum::power(unsigned int k) const
+{
+	if (segments_ == 0) {
+		return 0.0;
+	}
+	// |X|^2 dt / sum(w^2), with the time step in seconds
+	return power_sum_[k] * (time_step_ / 1000.0) / (window_norm_ * segments_);
+}
+
+double PopulationSpectrum::frequency(unsigned int k) const
+{
+	return k * 1000.0 / (segment_ * time_step_);
+}
+
+SpectrumSummary PopulationSpectrum::summarize() const
+{
+	SpectrumSummary summary {segments_, frequency(1), 0, 0, 0, 0, 0};
+	if (segments_ == 0) {
+		return summary;
+	}
+	unsigned int peak(1);
+	for (unsigned int k(1); k <= segment_ / 2; ++k) {
+		summary.total_power += power(k) * summary.resolution;
+		if (power(k) > power(peak)) {
+			peak = k;
+		}
+	}
+	summary.peak_frequency = frequency(peak);
+	summary.peak_power = power(peak);
+	summary.mean_rate = rate_sum_ / recorded_;
+	summary.poisson_power = 2.0 * summary.mean_rate / number_of_neurons_;
+	return summary;
+}
+
+void PopulationSpectrum::write(std::string const& file_name) const
+{
+	std::ofstream file(file_name);
+	if (file.fail()) {
+		throw std::runtime_error("file " + file_name + " couldn't be opened");
+	}
+	for (unsigned int k(0); k <= segment_ / 2; ++k) {
+		file << frequency(k) << " " << power(k) << std::endl;
+	}
+}
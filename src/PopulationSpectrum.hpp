@@ -0,0 +1,111 @@
+/*! \class PopulationSpectrum
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Power spectrum of the population rate, estimated while the simulation runs (Welch 1967).
+ *  \details The population rate is cut into segments of a power of two of time steps, overlapping by half.
+ *  \details Each segment is detrended by its mean, multiplied by a Hann window and transformed by an FFT,
+ *  \details and the periodograms are averaged. Only the last segment of the rate and the averaged periodogram
+ *  \details are kept, so that the memory doesn't grow with the length of the simulation.
+ *  \details The oscillations of the synchronous regimes of the network appear as a peak of the spectrum
+ *  \details far above the flat spectrum of independent Poisson neurons, which doesn't depend on the time step.
+ */
+
+#ifndef POPULATIONSPECTRUM_H
+#define POPULATIONSPECTRUM_H
+
+#include <vector>
+#include <complex>
+#include <string>
+
+/*! Default number of time steps of a segment */
+constexpr unsigned int DEFAULT_SPECTRUM_SEGMENT (2048);
+
+/*! \brief Summary of the spectrum */
+struct SpectrumSummary
+{
+	/*! Number of segments averaged */
+	unsigned int segments;
+	/*! Frequency resolution [Hz] */
+	double resolution;
+	/*! Frequency of the highest power, the constant component left out [Hz] */
+	double peak_frequency;
+	/*! Power density at the peak [Hz^2 / Hz] */
+	double peak_power;
+	/*! Power density of N independent Poisson neurons firing at the mean rate nu, 2 nu / N [Hz^2 / Hz] */
+	double poisson_power;
+	/*! Variance of the population rate, the integral of the spectrum [Hz^2] */
+	double total_power;
+	/*! Mean population rate [Hz] */
+	double mean_rate;
+};
+
+class PopulationSpectrum
+{
+	private :
+
+		unsigned int const segment_;
+		unsigned int const number_of_neurons_;
+		double const time_step_;
+
+		/*! \brief Factor from a spike count of a time step to the population rate [Hz] */
+		double const to_rate_;
+
+		/*! \brief The last segment_ rates, as a ring */
+		std::vector<double> rates_;
+
+		/*! \brief Number of rates recorded and their sum */
+		long recorded_;
+		double rate_sum_;
+
+		/*! \brief Hann window and the sum of its squares */
+		std::vector<double> window_;
+		double window_norm_;
+
+		/*! \brief Sum of the periodograms, from 0 to the Nyquist frequency */
+		std::vector<double> power_sum_;
+		unsigned int segments_;
+
+		/*! \brief Buffer of the FFT and its twiddle factors */
+		std::vector<std::complex<double> > buffer_, twiddles_;
+
+		/*! \brief Adds the periodogram of the last segment */
+		void add_segment();
+
+	public :
+
+		/*! \brief Constructor
+		 * @param[in] number_of_neurons the number of neurons whose spikes are counted
+		 * @param[in] time_step the time step of the simulation [ms]
+		 * @param[in] segment the number of time steps of a segment, a power of two
+		 * \throw runtime_error if segment isn't a power of two larger than 2
+		 */
+		PopulationSpectrum(unsigned int number_of_neurons, double time_step, unsigned int segment);
+
+		/*! \brief Records the number of spikes of the population in the next time step */
+		void record(int spikes);
+
+		/*! \brief Returns the averaged power density of frequency index k [Hz^2 / Hz], for k from 0 to segment / 2 */
+		double power(unsigned int k) const;
+
+		/*! \brief Returns the frequency of index k [Hz] */
+		double frequency(unsigned int k) const;
+
+		/*! \brief Returns the summary of the spectrum */
+		SpectrumSummary summarize() const;
+
+		/*! \brief Writes the averaged spectrum into a file, one "frequency power" line per frequency
+		 * \throw runtime_error if the file can't be opened
+		 */
+		void write(std::string const& file_name) const;
+};
+
+/*! \brief In-place radix-2 FFT
+ * @param[in,out] data the sequence, whose length is a power of two
+ * @param[in] twiddles exp(-2 pi i k / n) for k from 0 to n / 2 - 1
+ */
+void fft(std::vector<std::complex<double> >& data, std::vector<std::complex<double> > const& twiddles);
+
+#endif /* PopulationSpectrum_hpp */
@@ -0,0 +1,334 @@
+#include "RasterPlot.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::uint8_t PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+/*! Largest stored deflate block */
+constexpr size_t DEFLATE_BLOCK (65535);
+
+/*! Gray levels of the pixels with the fewest and the most spikes, and of the background */
+constexpr unsigned int LIGHTEST_SPIKE (208);
+constexpr unsigned int DARKEST_SPIKE (0);
+constexpr std::uint8_t BACKGROUND (255);
+
+/*! Margins of the SVG around the plots, for the labels of the axes */
+constexpr unsigned int SVG_LEFT (70), SVG_TOP (10), SVG_RIGHT (20), SVG_BOTTOM (40), SVG_GAP (10);
+
+/*! Mask of the gray levels of the SVG */
+constexpr std::uint8_t SVG_SHADES (0xF0);
+
+/*! Number of intervals between the labels of an axis */
+constexpr unsigned int AXIS_TICKS (4);
+
+std::uint32_t crc32(std::uint32_t crc, std::uint8_t const* data, size_t size)
+{
+	static std::uint32_t table[256] = {0};
+	if (table[1] == 0) {
+		for (std::uint32_t n(0); n < 256; ++n) {
+			std::uint32_t c(n);
+			for (int bit(0); bit < 8; ++bit) {
+				c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			}
+			table[n] = c;
+		}
+	}
+	crc = ~crc;
+	for (size_t i(0); i < size; ++i) {
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	}
+	return ~crc;
+}
+
+void append_big_endian(std::vector<std::uint8_t>& bytes, std::uint32_t value)
+{
+	for (int shift(24); shift >= 0; shift -= 8) {
+		bytes.push_back(static_cast<std::uint8_t>(value >> shift));
+	}
+}
+
+/*! Writes a chunk of a PNG: its length, its type and data and their CRC */
+void write_png_chunk(std::ofstream& file, char const type[4], std::vector<std::uint8_t> const& data)
+{
+	std::vector<std::uint8_t> chunk;
+	chunk.reserve(data.size() + 12);
+	append_big_endian(chunk, data.size());
+	chunk.insert(chunk.end(), type, type + 4);
+	chunk.insert(chunk.end(), data.begin(), data.end());
+	append_big_endian(chunk, crc32(0, chunk.data() + 4, chunk.size() - 4));
+	file.write(reinterpret_cast<char const*>(chunk.data()), chunk.size());
+}
+
+/*! Returns the zlib stream of the data in stored deflate blocks */
+std::vector<std::uint8_t> zlib_stored(std::vector<std::uint8_t> const& data)
+{
+	std::vector<std::uint8_t> stream {0x78, 0x01};
+	stream.reserve(data.size() + data.size() / DEFLATE_BLOCK * 5 + 11);
+	std::uint32_t a(1), b(0);
+	size_t position(0);
+	do {
+		size_t const size(std::min(DEFLATE_BLOCK, data.size() - position));
+		bool const last(position + size == data.size());
+		stream.push_back(last ? 1 : 0);
+		stream.push_back(size & 0xFF);
+		stream.push_back(size >> 8);
+		stream.push_back(~size & 0xFF);
+		stream.push_back((~size >> 8) & 0xFF);
+		stream.insert(stream.end(), data.begin() + position, data.begin() + position + size);
+		// Adler-32 of the data, the sums reduced often enough not to overflow
+		for (size_t i(position); i < position + size; ++i) {
+			a += data[i];
+			b += a;
+			if ((i & 0x7FF) == 0x7FF) {
+				a %= 65521;
+				b %= 65521;
+			}
+		}
+		a %= 65521;
+		b %= 65521;
+		position += size;
+	} while (position < data.size());
+	append_big_endian(stream, (b << 16) | a);
+	return stream;
+}
+
+/*! Returns a number of an axis with the digits needed */
+std::string axis_label(double value)
+{
+	std::ostringstream label;
+	label.precision(std::fabs(value) >= 1.0 or value == 0.0 ? 6 : 3);
+	label << value;
+	return label.str();
+}
+
+}
+
+RasterPlot::RasterPlot(int first_step, int end_step, unsigned int first_neuron, unsigned int end_neuron, unsigned int width, unsigned int height)
+	: first_step_(first_step), end_step_(end_step), first_neuron_(first_neuron), end_neuron_(end_neuron), width_(width), height_(height),
+	  spikes_(0), current_step_(first_step), current_column_(0)
+{
+	if (first_step >= end_step or first_neuron >= end_neuron) {
+		throw std::runtime_error("the plot needs at least one time step and one neuron");
+	}
+	if (width == 0 or height == 0) {
+		throw std::runtime_error("the plot needs at least one pixel");
+	}
+	counts_.assign(static_cast<size_t>(width) * height, 0);
+	column_spikes_.assign(width, 0);
+	rows_.resize(end_neuron - first_neuron);
+	for (unsigned int neuron(0); neuron < rows_.size(); ++neuron) {
+		rows_[neuron] = static_cast<std::uint64_t>(neuron) * height / rows_.size();
+	}
+}
+
+void RasterPlot::add(SpikeEvent const* begin, SpikeEvent const* end)
+{
+	std::uint32_t const steps(end_step_ - first_step_);
+	for (SpikeEvent const* spike(begin); spike != end; ++spike) {
+		// the spikes come in the order of the time steps, so the column only changes with the step
+		if (spike->step != current_step_) {
+			current_step_ = spike->step;
+			std::uint32_t const offset(current_step_ - first_step_);
+			current_column_ = offset < steps ? static_cast<std::uint64_t>(offset) * width_ / steps : width_;
+		}
+		std::uint32_t const neuron(spike->neuron - first_neuron_);
+		if (current_column_ < width_ and neuron < rows_.size()) {
+			++counts_[static_cast<size_t>(rows_[neuron]) * width_ + current_column_];
+			++column_spikes_[current_column_];
+			++spikes_;
+		}
+	}
+}
+
+void RasterPlot::add(unsigned int neuron, int step)
+{
+	SpikeEvent const spike = {neuron, step};
+	add(&spike, &spike + 1);
+}
+
+std::uint32_t RasterPlot::count(unsigned int x, unsigned int y) const
+{
+	assert(x < width_ and y < height_);
+	return counts_[static_cast<size_t>(y) * width_ + x];
+}
+
+std::uint64_t RasterPlot::column_spikes(unsigned int x) const
+{
+	assert(x < width_);
+	return column_spikes_[x];
+}
+
+int RasterPlot::column_steps(unsigned int x) const
+{
+	// step s is in column x if x * steps <= (s - first_step) * width < (x + 1) * steps
+	std::uint64_t const steps(end_step_ - first_step_);
+	return static_cast<int>(((x + 1) * steps + width_ - 1) / width_ - (x * steps + width_ - 1) / width_);
+}
+
+double RasterPlot::column_rate(unsigned int x, double time_step) const
+{
+	int const steps(column_steps(x));
+	return steps == 0 ? 0.0 : column_spikes(x) * 1000.0 / (static_cast<double>(end_neuron_ - first_neuron_) * steps * time_step);
+}
+
+std::uint64_t RasterPlot::spikes() const
+{
+	return spikes_;
+}
+
+std::vector<std::uint8_t> RasterPlot::render(double time_step, unsigned int rate_height) const
+{
+	size_t const rows(height_ + (rate_height > 0 ? 1 + rate_height : 0));
+	std::vector<std::uint8_t> image(rows * width_, BACKGROUND);
+
+	std::uint32_t const fullest(*std::max_element(counts_.begin(), counts_.end()));
+	for (unsigned int y(0); y < height_; ++y) {
+		std::uint8_t* const row(image.data() + static_cast<size_t>(height_ - 1 - y) * width_);
+		for (unsigned int x(0); x < width_; ++x) {
+			std::uint32_t const spikes(count(x, y));
+			if (spikes > 0) {
+				row[x] = static_cast<std::uint8_t>(std::lround(LIGHTEST_SPIKE - (LIGHTEST_SPIKE - DARKEST_SPIKE) * std::sqrt(static_cast<double>(spikes) / fullest)));
+			}
+		}
+	}
+
+	if (rate_height > 0) {
+		std::fill_n(image.begin() + static_cast<size_t>(height_) * width_, width_, 0);
+		double highest(0.0);
+		for (unsigned int x(0); x < width_; ++x) {
+			highest = std::max(highest, column_rate(x, time_step));
+		}
+		for (unsigned int x(0); x < width_; ++x) {
+			unsigned int const bar(highest > 0.0 ? std::lround(column_rate(x, time_step) / highest * rate_height) : 0);
+			for (unsigned int y(rate_height - bar); y < rate_height; ++y) {
+				image[(height_ + 1 + static_cast<size_t>(y)) * width_ + x] = 0;
+			}
+		}
+	}
+	return image;
+}
+
+void RasterPlot::write_png(std::string const& file_name, double time_step, unsigned int rate_height) const
+{
+	std::ofstream file(file_name, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+	if (file.fail()) {
+		throw std::runtime_error("file " + file_name + " couldn't be opened");
+	}
+	std::vector<std::uint8_t> const image(render(time_step, rate_height));
+	std::uint32_t const rows(image.size() / width_);
+
+	// width, height, bit depth 8, grayscale, deflate, adaptive filtering, no interlace
+	std::vector<std::uint8_t> header;
+	append_big_endian(header, width_);
+	append_big_endian(header, rows);
+	header.insert(header.end(), {8, 0, 0, 0, 0});
+
+	// every row starts with filter type 0, the bytes as they are
+	std::vector<std::uint8_t> scanlines;
+	scanlines.reserve(image.size() + rows);
+	for (std::uint32_t row(0); row < rows; ++row) {
+		scanlines.push_back(0);
+		scanlines.insert(scanlines.end(), image.begin() + static_cast<size_t>(row) * width_, image.begin() + static_cast<size_t>(row + 1) * width_);
+	}
+
+	file.write(reinterpret_cast<char const*>(PNG_SIGNATURE), sizeof(PNG_SIGNATURE));
+	write_png_chunk(file, "IHDR", header);
+	write_png_chunk(file, "IDAT", zlib_stored(scanlines));
+	write_png_chunk(file, "IEND", std::vector<std::uint8_t>());
+	if (file.fail()) {
+		throw std::runtime_error("file " + file_name + " couldn't be written");
+	}
+}
+
+void RasterPlot::write_svg(std::string const& file_name, double time_step, unsigned int rate_height) const
+{
+	std::ofstream file(file_name);
+	if (file.fail()) {
+		throw std::runtime_error("file " + file_name + " couldn't be opened");
+	}
+	std::vector<std::uint8_t> const image(render(time_step, 0));
+	unsigned int const rate_top(SVG_TOP + height_ + SVG_GAP);
+	unsigned int const plots_bottom(rate_height > 0 ? rate_top + rate_height : SVG_TOP + height_);
+
+	file << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << SVG_LEFT + width_ + SVG_RIGHT << "\" height=\"" << plots_bottom + SVG_BOTTOM
+		 << "\" font-family=\"sans-serif\" font-size=\"12\">\n";
+	file << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+
+	// the runs of equal pixels of each row of the raster, the levels rounded down to 16 so that dense rasters have runs too
+	auto const shade = [](std::uint8_t level) { return level == BACKGROUND ? BACKGROUND : static_cast<std::uint8_t>(level & SVG_SHADES); };
+	file << "<g transform=\"translate(" << SVG_LEFT << "," << SVG_TOP << ")\" shape-rendering=\"crispEdges\">\n";
+	for (unsigned int y(0); y < height_; ++y) {
+		std::uint8_t const* const row(image.data() + static_cast<size_t>(y) * width_);
+		for (unsigned int x(0); x < width_;) {
+			std::uint8_t const level(shade(row[x]));
+			unsigned int end(x + 1);
+			while (end < width_ and shade(row[end]) == level) {
+				++end;
+			}
+			if (level != BACKGROUND) {
+				file << "<rect x=\"" << x << "\" y=\"" << y << "\" width=\"" << end - x << "\" height=\"1\" fill=\"rgb("
+					 << +level << "," << +level << "," << +level << ")\"/>\n";
+			}
+			x = end;
+		}
+	}
+	file << "</g>\n";
+	file << "<rect x=\"" << SVG_LEFT << "\" y=\"" << SVG_TOP << "\" width=\"" << width_ << "\" height=\"" << height_ << "\" fill=\"none\" stroke=\"black\"/>\n";
+	for (unsigned int tick(0); tick <= AXIS_TICKS; ++tick) {
+		double const y(SVG_TOP + height_ - static_cast<double>(height_) * tick / AXIS_TICKS);
+		file << "<text x=\"" << SVG_LEFT - 5 << "\" y=\"" << y << "\" text-anchor=\"end\" dominant-baseline=\"middle\">"
+			 << axis_label(first_neuron_ + std::floor(static_cast<double>(end_neuron_ - first_neuron_) * tick / AXIS_TICKS)) << "</text>\n";
+	}
+	file << "<text transform=\"translate(15," << SVG_TOP + height_ / 2 << ") rotate(-90)\" text-anchor=\"middle\">neuron</text>\n";
+
+	// the rate of each column as a step line
+	if (rate_height > 0) {
+		double highest(0.0);
+		for (unsigned int x(0); x < width_; ++x) {
+			highest = std::max(highest, column_rate(x, time_step));
+		}
+		file << "<path fill=\"none\" stroke=\"black\" d=\"M" << SVG_LEFT << " " << rate_top + rate_height;
+		for (unsigned int x(0); x < width_; ++x) {
+			double const rate(column_rate(x, time_step));
+			file << " V" << rate_top + rate_height - (highest > 0.0 ? rate / highest * rate_height : 0.0) << " H" << SVG_LEFT + x + 1;
+		}
+		file << "\"/>\n";
+		file << "<rect x=\"" << SVG_LEFT << "\" y=\"" << rate_top << "\" width=\"" << width_ << "\" height=\"" << rate_height << "\" fill=\"none\" stroke=\"black\"/>\n";
+		for (unsigned int tick(0); tick <= AXIS_TICKS; tick += AXIS_TICKS) {
+			file << "<text x=\"" << SVG_LEFT - 5 << "\" y=\"" << rate_top + rate_height - static_cast<double>(rate_height) * tick / AXIS_TICKS
+				 << "\" text-anchor=\"end\" dominant-baseline=\"middle\">" << axis_label(highest * tick / AXIS_TICKS) << "</text>\n";
+		}
+		file << "<text transform=\"translate(15," << rate_top + rate_height / 2 << ") rotate(-90)\" text-anchor=\"middle\">rate [Hz]</text>\n";
+	}
+
+	for (unsigned int tick(0); tick <= AXIS_TICKS; ++tick) {
+		double const x(SVG_LEFT + static_cast<double>(width_) * tick / AXIS_TICKS);
+		file << "<text x=\"" << x << "\" y=\"" << plots_bottom + 15 << "\" text-anchor=\"middle\">"
+			 << axis_label((first_step_ + static_cast<double>(end_step_ - first_step_) * tick / AXIS_TICKS) * time_step) << "</text>\n";
+	}
+	file << "<text x=\"" << SVG_LEFT + width_ / 2 << "\" y=\"" << plots_bottom + 33 << "\" text-anchor=\"middle\">time [ms]</text>\n";
+	file << "</svg>\n";
+	if (file.fail()) {
+		throw std::runtime_error("file " + file_name + " couldn't be written");
+	}
+}
+
+void RasterPlot::write(std::string const& file_name, double time_step, unsigned int rate_height) const
+{
+	auto const ends_with = [&file_name](std::string const& extension) {
+		return file_name.size() >= extension.size() and file_name.compare(file_name.size() - extension.size(), extension.size(), extension) == 0;
+	};
+	if (ends_with(".png")) {
+		write_png(file_name, time_step, rate_height);
+	} else if (ends_with(".svg")) {
+		write_svg(file_name, time_step, rate_height);
+	} else {
+		throw std::runtime_error("file " + file_name + " is neither a .png nor a .svg");
+	}
+}
@@ -0,0 +1,108 @@
+/*! \file RasterPlot.hpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Raster and population-rate plot of the spikes of a simulation, rendered to PNG or SVG.
+ *  \details The plot is decimated while the spikes are added: each spike only increments the count of its pixel,
+ *  \details a bin of neurons and time steps, and of its column, so that a single streaming pass over the spikes
+ *  \details builds the plot in memory proportional to the pixels, however many spikes there are. The pixels are
+ *  \details shaded by the square root of their count relative to the fullest one, so that isolated spikes stay
+ *  \details visible next to synchronous bursts, and the rate of each column is drawn below the raster.
+ *  \details The PNG is written in 8-bit grayscale with uncompressed deflate blocks, and the SVG merges the runs of
+ *  \details equal pixels of a row into a single rectangle and adds the axes, so that neither needs a library.
+ */
+
+#ifndef RASTERPLOT_H
+#define RASTERPLOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SpikeStore.hpp"
+
+/*! Default size of the raster in pixels, the rate plot comes below it */
+constexpr unsigned int DEFAULT_PLOT_WIDTH (1600);
+constexpr unsigned int DEFAULT_PLOT_HEIGHT (800);
+constexpr unsigned int DEFAULT_RATE_HEIGHT (200);
+
+class RasterPlot
+{
+	private :
+
+		/*! \brief Time steps and neurons plotted, the ends excluded */
+		int const first_step_, end_step_;
+		unsigned int const first_neuron_, end_neuron_;
+
+		unsigned int const width_, height_;
+
+		/*! \brief Number of spikes of each pixel, row by row from the first neurons on */
+		std::vector<std::uint32_t> counts_;
+		/*! \brief Number of spikes of each column */
+		std::vector<std::uint64_t> column_spikes_;
+		std::uint64_t spikes_;
+
+		/*! \brief Row of each neuron plotted */
+		std::vector<std::uint32_t> rows_;
+		/*! \brief Time step of the last spike added and its column, width_ if outside the plot */
+		int current_step_;
+		std::uint32_t current_column_;
+
+		/*! \brief Returns the gray levels of the image, the raster from the last neurons on, a line and the rate plot */
+		std::vector<std::uint8_t> render(double time_step, unsigned int rate_height) const;
+
+		/*! \brief Returns the time steps of a column */
+		int column_steps(unsigned int x) const;
+
+	public :
+
+		/*! \brief Constructor
+		 * @param[in] first_step the first time step plotted
+		 * @param[in] end_step the time step after the last one plotted
+		 * @param[in] first_neuron the first neuron plotted
+		 * @param[in] end_neuron the neuron after the last one plotted
+		 * @param[in] width the number of columns of the raster
+		 * @param[in] height the number of rows of the raster
+		 * \throw runtime_error if the time steps, the neurons or the size are empty
+		 */
+		RasterPlot(int first_step, int end_step, unsigned int first_neuron, unsigned int end_neuron,
+				   unsigned int width = DEFAULT_PLOT_WIDTH, unsigned int height = DEFAULT_PLOT_HEIGHT);
+
+		/*! \brief Adds spikes, those outside the time steps or the neurons plotted are left out */
+		void add(SpikeEvent const* begin, SpikeEvent const* end);
+
+		/*! \brief Adds a spike */
+		void add(unsigned int neuron, int step);
+
+		/*! \brief Returns the number of spikes of a pixel, row 0 holding the first neurons */
+		std::uint32_t count(unsigned int x, unsigned int y) const;
+
+		/*! \brief Returns the number of spikes of a column */
+		std::uint64_t column_spikes(unsigned int x) const;
+
+		/*! \brief Returns the population rate of a column [Hz], 0 if it holds no time step */
+		double column_rate(unsigned int x, double time_step) const;
+
+		/*! \brief Returns the number of spikes added */
+		std::uint64_t spikes() const;
+
+		/*! \brief Writes the plot as an 8-bit grayscale PNG
+		 * @param[in] rate_height the number of rows of the rate plot, none if 0
+		 * \throw runtime_error if the file can't be written
+		 */
+		void write_png(std::string const& file_name, double time_step, unsigned int rate_height = DEFAULT_RATE_HEIGHT) const;
+
+		/*! \brief Writes the plot as an SVG with the axes in ms, neurons and Hz
+		 * @param[in] rate_height the number of rows of the rate plot, none if 0
+		 * \throw runtime_error if the file can't be written
+		 */
+		void write_svg(std::string const& file_name, double time_step, unsigned int rate_height = DEFAULT_RATE_HEIGHT) const;
+
+		/*! \brief Writes the plot as a PNG or an SVG, according to the extension of the file
+		 * \throw runtime_error if the extension is neither .png nor .svg, or the file can't be written
+		 */
+		void write(std::string const& file_name, double time_step, unsigned int rate_height = DEFAULT_RATE_HEIGHT) const;
+};
+
+#endif /* RasterPlot_hpp */
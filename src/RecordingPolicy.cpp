@@ -0,0 +1,118 @@
+#include "RecordingPolicy.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include "CounterRandom.hpp"
+
+namespace {
+
+/*! Substream of the draws of the recorded fraction, beyond any time step of the background noise */
+constexpr uint32_t RECORDING_SUBSTREAM (0xFFFFFFFE);
+
+}
+
+RecordingPolicy::RecordingPolicy()
+	: first_step_(0), end_step_(INT_MAX), every_(1), bin_(1)
+{}
+
+RecordingPolicy::RecordingPolicy(double time_step, double start, double stop, int every, int bin)
+	: first_step_(std::lround(start / time_step)), end_step_(std::lround(stop / time_step)), every_(every), bin_(bin)
+{
+	if (first_step_ < 0 or end_step_ <= first_step_) {
+		throw std::runtime_error("the recording window has to last at least one time step, from 0 on");
+	}
+	if (every < 1 or bin < 1 or (every > 1 and bin > 1)) {
+		throw std::runtime_error("the recorded time steps are either every k-th one or bins of b steps, k and b at least 1");
+	}
+}
+
+void RecordingPolicy::set_neurons(std::vector<unsigned int> const& neurons, unsigned int number_of_neurons)
+{
+	if (neurons.empty()) {
+		throw std::runtime_error("the list of recorded neurons is empty");
+	}
+	neurons_ = neurons;
+	std::sort(neurons_.begin(), neurons_.end());
+	neurons_.erase(std::unique(neurons_.begin(), neurons_.end()), neurons_.end());
+	if (neurons_.back() >= number_of_neurons) {
+		throw std::runtime_error("the recorded neuron " + std::to_string(neurons_.back()) + " doesn't exist");
+	}
+	recorded_.assign(number_of_neurons, false);
+	for (auto const neuron : neurons_) {
+		recorded_[neuron] = true;
+	}
+}
+
+void RecordingPolicy::set_fraction(double fraction, unsigned int number_of_neurons, unsigned long seed)
+{
+	if (fraction < 0 or fraction > 1) {
+		throw std::runtime_error("the fraction of recorded neurons has to be between 0 and 1");
+	}
+	neurons_.clear();
+	recorded_.assign(number_of_neurons, false);
+	for (unsigned int neuron(0); neuron < number_of_neurons; ++neuron) {
+		CounterRandom random(seed, neuron, RECORDING_SUBSTREAM);
+		recorded_[neuron] = random.uniform() < fraction;
+	}
+}
+
+RecordingAction RecordingPolicy::action(int step) const
+{
+	if (step < first_step_ or step >= end_step_) {
+		return RecordingAction::skip;
+	}
+	int const position(step - first_step_);
+	if (bin_ > 1) {
+		if (position % bin_ != bin_ - 1) {
+			return RecordingAction::accumulate;
+		}
+		// an incomplete last bin is never written
+		return position < (end_step_ - first_step_) / bin_ * bin_ ? RecordingAction::write : RecordingAction::skip;
+	}
+	return position % every_ == 0 ? RecordingAction::write : RecordingAction::skip;
+}
+
+bool RecordingPolicy::records_spike(unsigned int neuron, int step) const
+{
+	return step >= first_step_ and step < end_step_ and (recorded_.empty() or (neuron < recorded_.size() and recorded_[neuron]));
+}
+
+std::vector<unsigned int> const& RecordingPolicy::neurons() const
+{
+	return neurons_;
+}
+
+std::vector<unsigned int> parse_neuron_list(std::string const& neuron_list, unsigned int number_of_neurons)
+{
+	std::vector<unsigned int> neurons;
+	std::stringstream list(neuron_list);
+	std::string item;
+
+	while (std::getline(list, item, ',')) {
+		char* end(nullptr);
+		long const first(std::strtol(item.c_str(), &end, 10));
+		long last(first);
+		if (*end == '-') {
+			char const* range_end(end + 1);
+			last = std::strtol(range_end, &end, 10);
+			if (end == range_end) {
+				throw std::runtime_error("invalid range " + item + " in neuron list " + neuron_list);
+			}
+		}
+		if (item.empty() or end == item.c_str() or *end != '\0' or first < 0 or last < first) {
+			throw std::runtime_error("invalid entry " + item + " in neuron list " + neuron_list);
+		}
+		// before expanding the range, which could be of billions of neurons
+		if (last >= static_cast<long>(number_of_neurons)) {
+			throw std::runtime_error("the entry " + item + " of the neuron list " + neuron_list + " isn't in the network of "
+									 + std::to_string(number_of_neurons) + " neurons");
+		}
+		for (long neuron(first); neuron <= last; ++neuron) {
+			neurons.push_back(neuron);
+		}
+	}
+	return neurons;
+}
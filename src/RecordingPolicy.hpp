@@ -0,0 +1,89 @@
+/*! \class RecordingPolicy
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief What the recorders of the simulation write: a time window, a subsampling of the time steps and a subset of the neurons.
+ *  \details The spike sums and the rows of the observed neurons are written for the time steps of the window, either
+ *  \details every k-th step or once per bin of b steps, as the sum of the spikes of the bin, respectively whether
+ *  \details the neuron spiked in the bin. An incomplete last bin isn't written. The spikes of the raster recorders
+ *  \details (spikes.bin, raster.npy) are written for the window and the subset of the neurons, given as a list of
+ *  \details neurons, which are then also the observed ones, or as a fraction of the neurons drawn with the seed.
+ */
+
+#ifndef RECORDINGPOLICY_H
+#define RECORDINGPOLICY_H
+
+#include <vector>
+#include <string>
+
+/*! What a recorder does with a time step */
+enum class RecordingAction
+{
+	/*! Nothing, the step isn't recorded */
+	skip,
+	/*! Adds the step to the current bin */
+	accumulate,
+	/*! Adds the step to the current bin and writes the bin */
+	write
+};
+
+class RecordingPolicy
+{
+	private :
+
+		/*! \brief First time step recorded and the one after the last */
+		int first_step_, end_step_;
+
+		/*! \brief Stride of the recorded steps and number of steps of a bin, one of them 1 */
+		int every_, bin_;
+
+		/*! \brief Listed neurons, in increasing order, empty if none */
+		std::vector<unsigned int> neurons_;
+
+		/*! \brief Whether each neuron is recorded, empty if all are */
+		std::vector<bool> recorded_;
+
+	public :
+
+		/*! \brief Constructor of the policy recording everything */
+		RecordingPolicy();
+
+		/*! \brief Constructor
+		 * @param[in] time_step the time step of the simulation [ms]
+		 * @param[in] start the beginning of the window [ms]
+		 * @param[in] stop the end of the window, excluded [ms]
+		 * @param[in] every the stride of the recorded time steps
+		 * @param[in] bin the number of time steps of a bin
+		 * \throw runtime_error if the window is empty, every or bin is smaller than 1, or both are larger than 1
+		 */
+		RecordingPolicy(double time_step, double start, double stop, int every, int bin);
+
+		/*! \brief Records only a list of neurons, which are also the observed ones
+		 * \throw runtime_error if a neuron doesn't exist or the list is empty
+		 */
+		void set_neurons(std::vector<unsigned int> const& neurons, unsigned int number_of_neurons);
+
+		/*! \brief Records only a fraction of the neurons, each drawn with that probability from the seed
+		 * \throw runtime_error if the fraction isn't between 0 and 1
+		 */
+		void set_fraction(double fraction, unsigned int number_of_neurons, unsigned long seed);
+
+		/*! \brief Returns what the sums and the observed neurons do with a time step */
+		RecordingAction action(int step) const;
+
+		/*! \brief Returns whether a spike of a neuron at a time step is written by the raster recorders */
+		bool records_spike(unsigned int neuron, int step) const;
+
+		/*! \brief Returns the listed neurons, empty if none */
+		std::vector<unsigned int> const& neurons() const;
+};
+
+/*! \brief Parses a list of neurons such as "0-99,12000"
+ * @param[in] number_of_neurons the number of neurons of the network, which the neurons have to be below
+ * \throw runtime_error if the list is malformed or has a neuron outside the network
+ */
+std::vector<unsigned int> parse_neuron_list(std::string const& neuron_list, unsigned int number_of_neurons);
+
+#endif /* RecordingPolicy_hpp */
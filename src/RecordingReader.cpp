@@ -0,0 +1,290 @@
+#include "RecordingReader.hpp"
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+/*! Magic string of the .npy format, followed by the version */
+constexpr char NPY_MAGIC[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+
+/*! Byte order of the machine in the notation of NumPy */
+char byte_order()
+{
+	std::uint16_t const one(1);
+	char first;
+	std::memcpy(&first, &one, 1);
+	return first == 1 ? '<' : '>';
+}
+
+/*! Returns the value of a key of the dictionary of a .npy header, up to the character which ends it */
+std::string dictionary_value(std::string const& dictionary, std::string const& key, char end)
+{
+	size_t const position(dictionary.find("'" + key + "':"));
+	if (position == std::string::npos) {
+		return "";
+	}
+	size_t const begin(dictionary.find_first_not_of(" '(", position + key.size() + 3));
+	size_t const last(dictionary.find(end, begin));
+	return begin == std::string::npos or last == std::string::npos ? "" : dictionary.substr(begin, last - begin);
+}
+
+}
+
+RecordingReader::iterator::iterator(RecordingReader* reader)
+	: reader_(reader)
+{}
+
+std::vector<long> const& RecordingReader::iterator::operator*() const
+{
+	assert(reader_ != nullptr);
+	return reader_->row();
+}
+
+std::vector<long> const* RecordingReader::iterator::operator->() const
+{
+	return &**this;
+}
+
+RecordingReader::iterator& RecordingReader::iterator::operator++()
+{
+	assert(reader_ != nullptr);
+	if (!reader_->next()) {
+		reader_ = nullptr;
+	}
+	return *this;
+}
+
+bool RecordingReader::iterator::operator==(iterator const& other) const
+{
+	return reader_ == other.reader_;
+}
+
+bool RecordingReader::iterator::operator!=(iterator const& other) const
+{
+	return reader_ != other.reader_;
+}
+
+RecordingReader::RecordingReader(std::string const& file_name)
+	: file_name_(file_name), data_(nullptr), size_(0), columns_(0), rows_read_(0)
+{
+	int const fd(open(file_name.c_str(), O_RDONLY));
+	if (fd < 0) {
+		throw std::runtime_error("file " + file_name + " couldn't be opened: " + strerror(errno));
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0) {
+		::close(fd);
+		throw std::runtime_error("file " + file_name + " couldn't be read: " + strerror(errno));
+	}
+	size_ = status.st_size;
+	// an empty file can't be mapped, and has no row anyway
+	if (size_ > 0) {
+		void* const data(mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0));
+		if (data == MAP_FAILED) {
+			::close(fd);
+			throw std::runtime_error("file " + file_name + " couldn't be mapped: " + strerror(errno));
+		}
+		data_ = static_cast<char const*>(data);
+		madvise(const_cast<char*>(data_), size_, MADV_SEQUENTIAL);
+	}
+	::close(fd);
+}
+
+RecordingReader::~RecordingReader()
+{
+	if (data_ != nullptr) {
+		munmap(const_cast<char*>(data_), size_);
+	}
+}
+
+bool RecordingReader::next()
+{
+	if (!read_row()) {
+		return false;
+	}
+	if (columns_ == 0) {
+		columns_ = row_.size();
+	} else if (row_.size() != columns_) {
+		throw std::runtime_error("row " + std::to_string(rows_read_ + 1) + " of " + file_name_ + " has " + std::to_string(row_.size())
+								 + " columns instead of " + std::to_string(columns_));
+	}
+	++rows_read_;
+	return true;
+}
+
+std::vector<long> const& RecordingReader::row() const
+{
+	return row_;
+}
+
+unsigned int RecordingReader::columns() const
+{
+	return columns_;
+}
+
+std::uint64_t RecordingReader::rows_read() const
+{
+	return rows_read_;
+}
+
+std::string const& RecordingReader::file_name() const
+{
+	return file_name_;
+}
+
+RecordingReader::iterator RecordingReader::begin()
+{
+	return iterator(next() ? this : nullptr);
+}
+
+RecordingReader::iterator RecordingReader::end()
+{
+	return iterator(nullptr);
+}
+
+TextRecordingReader::TextRecordingReader(std::string const& file_name)
+	: RecordingReader(file_name), position_(0), line_(1)
+{}
+
+bool TextRecordingReader::read_row()
+{
+	row_.clear();
+	while (position_ < size_) {
+		char character(data_[position_]);
+		if (character >= '0' and character <= '9') {
+			long value(0);
+			do {
+				value = value * 10 + (character - '0');
+				++position_;
+			} while (position_ < size_ and (character = data_[position_]) >= '0' and character <= '9');
+			row_.push_back(value);
+			continue;
+		}
+		++position_;
+		if (character == '\n') {
+			++line_;
+			if (!row_.empty()) {
+				return true;
+			}
+		} else if (character != ' ' and character != '\t' and character != '\r') {
+			throw std::runtime_error("line " + std::to_string(line_) + " of " + file_name_ + " isn't a row of unsigned integers");
+		}
+	}
+	// the last row may lack its newline
+	return !row_.empty();
+}
+
+NpyRecordingReader::NpyRecordingReader(std::string const& file_name, unsigned int bits)
+	: RecordingReader(file_name), data_offset_(0), rows_(0), elements_(1), element_size_(0), unpack_bits_(bits > 0)
+{
+	// magic, version, length of the dictionary in 2 bytes for version 1 and 4 bytes for versions 2 and 3
+	if (size_ < sizeof(NPY_MAGIC) + 4 or std::memcmp(data_, NPY_MAGIC, sizeof(NPY_MAGIC)) != 0) {
+		throw std::runtime_error("file " + file_name + " isn't a .npy array");
+	}
+	std::uint8_t const* const bytes(reinterpret_cast<std::uint8_t const*>(data_));
+	size_t length(bytes[8] | bytes[9] << 8);
+	data_offset_ = 10 + length;
+	if (bytes[6] >= 2) {
+		length = size_ < 12 ? 0 : length | static_cast<size_t>(bytes[10]) << 16 | static_cast<size_t>(bytes[11]) << 24;
+		data_offset_ = 12 + length;
+	}
+	if (data_offset_ > size_) {
+		throw std::runtime_error("file " + file_name + " isn't a .npy array");
+	}
+	std::string const dictionary(data_ + data_offset_ - length, length);
+
+	descr_ = dictionary_value(dictionary, "descr", '\'');
+	if (descr_ == "|u1") {
+		element_size_ = 1;
+	} else if (descr_ == byte_order() + std::string("u4") or descr_ == byte_order() + std::string("i4")) {
+		element_size_ = 4;
+	} else {
+		throw std::runtime_error("file " + file_name + " holds " + descr_ + " elements, only uint8, uint32 and int32 are read");
+	}
+	if (dictionary_value(dictionary, "fortran_order", ',') != "False") {
+		throw std::runtime_error("file " + file_name + " isn't in C order");
+	}
+	std::string const shape(dictionary_value(dictionary, "shape", ')'));
+	char* end(nullptr);
+	rows_ = std::strtoull(shape.c_str(), &end, 10);
+	if (end == shape.c_str()) {
+		throw std::runtime_error("file " + file_name + " hasn't the shape of a one- or two-dimensional array");
+	}
+	size_t const comma(shape.find(','));
+	if (comma != std::string::npos and shape.find_first_not_of(" ,", comma) != std::string::npos) {
+		elements_ = std::strtoul(shape.c_str() + comma + 1, &end, 10);
+		if (shape.find(',', comma + 1) != std::string::npos) {
+			throw std::runtime_error("file " + file_name + " has more than two dimensions");
+		}
+	}
+	if (size_ < data_offset_ + rows_ * elements_ * element_size_) {
+		throw std::runtime_error("file " + file_name + " is shorter than its " + std::to_string(rows_) + " rows");
+	}
+
+	if (unpack_bits_) {
+		if (element_size_ != 1 or bits > 8 * elements_) {
+			throw std::runtime_error("file " + file_name + " hasn't " + std::to_string(bits) + " bits per row");
+		}
+		columns_ = bits;
+	} else {
+		columns_ = elements_;
+	}
+	row_.reserve(columns_);
+}
+
+bool NpyRecordingReader::read_row()
+{
+	if (rows_read_ >= rows_) {
+		return false;
+	}
+	char const* const row(data_ + data_offset_ + rows_read_ * elements_ * element_size_);
+	row_.clear();
+	if (unpack_bits_) {
+		// the first column is the most significant bit of the first byte, like numpy.unpackbits
+		for (unsigned int bit(0); bit < columns_; ++bit) {
+			row_.push_back((static_cast<std::uint8_t>(row[bit / 8]) >> (7 - bit % 8)) & 1);
+		}
+	} else if (element_size_ == 1) {
+		for (unsigned int element(0); element < elements_; ++element) {
+			row_.push_back(static_cast<std::uint8_t>(row[element]));
+		}
+	} else if (descr_[1] == 'u') {
+		for (unsigned int element(0); element < elements_; ++element) {
+			std::uint32_t value;
+			std::memcpy(&value, row + element * sizeof(value), sizeof(value));
+			row_.push_back(value);
+		}
+	} else {
+		for (unsigned int element(0); element < elements_; ++element) {
+			std::int32_t value;
+			std::memcpy(&value, row + element * sizeof(value), sizeof(value));
+			row_.push_back(value);
+		}
+	}
+	return true;
+}
+
+std::uint64_t NpyRecordingReader::rows() const
+{
+	return rows_;
+}
+
+std::string const& NpyRecordingReader::descr() const
+{
+	return descr_;
+}
+
+std::unique_ptr<RecordingReader> open_recording(std::string const& file_name, unsigned int bits)
+{
+	std::string const extension(".npy");
+	if (file_name.size() >= extension.size() and file_name.compare(file_name.size() - extension.size(), extension.size(), extension) == 0) {
+		return std::unique_ptr<RecordingReader>(new NpyRecordingReader(file_name, bits));
+	}
+	return std::unique_ptr<RecordingReader>(new TextRecordingReader(file_name));
+}
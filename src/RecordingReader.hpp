@@ -0,0 +1,157 @@
+/*! \file RecordingReader.hpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Streaming readers of the recordings of a simulation, row by row, whether text or .npy.
+ *  \details A recording is read as rows of integers: the spike sums of sum_spikes.txt or sum_spikes.npy, one row
+ *  \details per time step or bin with the sums of the populations if they were written, the observed neurons of
+ *  \details spikes.txt or spikes.npy, one 0 or 1 per neuron, and the (neuron, time step) rows of raster.npy. The
+ *  \details file is mapped into memory and parsed as the rows are iterated, so that archives of any size are
+ *  \details streamed in a single pass in constant memory. The text files are parsed by hand rather than with
+ *  \details iostreams, which the legacy files of long simulations made the bottleneck of every analysis.
+ */
+
+#ifndef RECORDINGREADER_H
+#define RECORDINGREADER_H
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+class RecordingReader
+{
+	protected :
+
+		std::string const file_name_;
+
+		/*! \brief The file mapped into memory and its size in bytes */
+		char const* data_;
+		size_t size_;
+
+		/*! \brief Number of columns of the rows, 0 until it is known */
+		unsigned int columns_;
+
+		/*! \brief The current row and the number of rows read */
+		std::vector<long> row_;
+		std::uint64_t rows_read_;
+
+		/*! \brief Reads the next row into row_, returns false at the end of the file */
+		virtual bool read_row() = 0;
+
+	public :
+
+		/*! \brief Input iterator over the rows, which are read as it is incremented */
+		class iterator : public std::iterator<std::input_iterator_tag, std::vector<long> const>
+		{
+			private :
+
+				/*! \brief The reader, nullptr at the end */
+				RecordingReader* reader_;
+
+			public :
+
+				iterator(RecordingReader* reader);
+				std::vector<long> const& operator*() const;
+				std::vector<long> const* operator->() const;
+				iterator& operator++();
+				bool operator==(iterator const& other) const;
+				bool operator!=(iterator const& other) const;
+		};
+
+		/*! \brief Constructor, maps the file into memory
+		 * \throw runtime_error if the file can't be opened or mapped
+		 */
+		RecordingReader(std::string const& file_name);
+
+		/*! \brief Destructor, unmaps the file */
+		virtual ~RecordingReader();
+
+		RecordingReader(RecordingReader const&) = delete;
+		RecordingReader& operator=(RecordingReader const&) = delete;
+
+		/*! \brief Reads the next row, returns false at the end of the file
+		 * \throw runtime_error if the row is malformed or hasn't the number of columns of the previous ones
+		 */
+		bool next();
+
+		/*! \brief Returns the row read last */
+		std::vector<long> const& row() const;
+
+		/*! \brief Returns the number of columns, for a text file 0 until the first row is read */
+		unsigned int columns() const;
+
+		std::uint64_t rows_read() const;
+
+		std::string const& file_name() const;
+
+		/*! \brief Reads the first row not read yet and returns an iterator on it, the rows can only be iterated once */
+		iterator begin();
+		iterator end();
+};
+
+/*! \brief Reader of the legacy text files, rows of unsigned integers separated by spaces, blank lines skipped */
+class TextRecordingReader : public RecordingReader
+{
+	private :
+
+		size_t position_;
+		std::uint64_t line_;
+
+		bool read_row() override;
+
+	public :
+
+		/*! \brief Constructor, maps the file into memory
+		 * \throw runtime_error if the file can't be opened or mapped
+		 */
+		TextRecordingReader(std::string const& file_name);
+};
+
+/*! \brief Reader of the .npy arrays of integers written by the simulation, in the byte order of the machine
+ *  \details Reads arrays of uint8, uint32 and int32 of one or two dimensions, a one-dimensional one as rows of a
+ *  \details single column. The rows of bits packed as numpy.packbits does, e.g. those of spikes.npy, can be unpacked
+ *  \details into one column per bit.
+ */
+class NpyRecordingReader : public RecordingReader
+{
+	private :
+
+		/*! \brief Type of the elements in the notation of NumPy, e.g. "<u4" */
+		std::string descr_;
+
+		/*! \brief Offset of the data, number of rows and of elements of a row, and bytes of an element */
+		size_t data_offset_;
+		std::uint64_t rows_;
+		unsigned int elements_;
+		unsigned int element_size_;
+		bool unpack_bits_;
+
+		bool read_row() override;
+
+	public :
+
+		/*! \brief Constructor, maps the file into memory and parses its header
+		 * @param[in] bits the number of bits of a row to unpack from an array of uint8, 0 to read its bytes
+		 * \throw runtime_error if the file can't be mapped, isn't a C-ordered array of the types read, is shorter
+		 * \throw than its header tells, or has fewer bits per row
+		 */
+		NpyRecordingReader(std::string const& file_name, unsigned int bits = 0);
+
+		/*! \brief Returns the number of rows of the array */
+		std::uint64_t rows() const;
+
+		/*! \brief Returns the type of the elements in the notation of NumPy, e.g. "<u4" */
+		std::string const& descr() const;
+};
+
+/*! \brief Opens a reader according to the extension of the file, .npy or else text
+ * @param[in] bits the number of bits of a row to unpack from a .npy array of uint8, 0 to read its bytes
+ * \throw runtime_error if the file can't be read
+ */
+std::unique_ptr<RecordingReader> open_recording(std::string const& file_name, unsigned int bits = 0);
+
+#endif /* RecordingReader_hpp */
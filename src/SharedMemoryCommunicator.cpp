@@ -0,0 +1,188 @@
+#include "SharedMemoryCommunicator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+static_assert(sizeof(std::atomic<int>) == sizeof(int), "the futex word has to be a plain int");
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "the words shared by the processes have to be lock-free");
+
+/*! Number of times a rank checks the sense word before sleeping */
+constexpr unsigned int BARRIER_SPINS (4096);
+
+/*! Longest sleep of a rank in the barrier before it checks whether the exchange was aborted [ns] */
+constexpr long BARRIER_SLEEP (10000000);
+
+/*! Layout of the beginning of the segment, the mailboxes follow
+ *  \details A sense-reversing barrier: the last rank in flips the sense and wakes the others.
+ *  \details A rank which fails sets aborted, so that the others leave the barrier instead of waiting forever.
+ */
+struct SegmentHeader
+{
+	std::atomic<int> sense;
+	std::atomic<int> remaining;
+	std::atomic<int> aborted;
+};
+
+/*! Mailboxes start on their own cache line after the header */
+constexpr std::size_t MAILBOX_OFFSET ((sizeof(SegmentHeader) + 63) / 64 * 64);
+
+SegmentHeader* header_of(void* segment)
+{
+	return static_cast<SegmentHeader*>(segment);
+}
+
+inline void relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield" ::: "memory");
+#endif
+}
+
+void futex_wait(std::atomic<int>* word, int value)
+{
+	// not private: the word is shared by processes. Returns after BARRIER_SLEEP at the latest
+	timespec const timeout = {0, BARRIER_SLEEP};
+	syscall(SYS_futex, reinterpret_cast<int*>(word), FUTEX_WAIT, value, &timeout, nullptr, 0);
+}
+
+void futex_wake_all(std::atomic<int>* word)
+{
+	syscall(SYS_futex, reinterpret_cast<int*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+}
+
+SharedMemoryCommunicator::SharedMemoryCommunicator(int size, std::size_t capacity)
+	: Communicator(0, size), segment_(nullptr), segment_size_(0), capacity_(capacity)
+{
+	// one mailbox of (capacity + 1) words per pair of ranks
+	segment_size_ = MAILBOX_OFFSET + size * size * (capacity + 1) * sizeof(unsigned int);
+
+	std::string name("/neurosim_" + std::to_string(getpid()));
+	int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0) {
+		throw std::runtime_error("shared memory " + name + " couldn't be created: " + strerror(errno));
+	}
+	if (ftruncate(fd, segment_size_) != 0) {
+		close(fd);
+		shm_unlink(name.c_str());
+		throw std::runtime_error("shared memory " + name + " couldn't be resized: " + strerror(errno));
+	}
+	segment_ = mmap(nullptr, segment_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	// the mapping survives the name, and forked ranks inherit the mapping
+	shm_unlink(name.c_str());
+	if (segment_ == MAP_FAILED) {
+		segment_ = nullptr;
+		throw std::runtime_error("shared memory " + name + " couldn't be mapped: " + strerror(errno));
+	}
+
+	// the segment is zero-filled, the atomics only need to be constructed
+	SegmentHeader* header(new (segment_) SegmentHeader);
+	header->sense.store(0);
+	header->remaining.store(size);
+	header->aborted.store(0);
+}
+
+SharedMemoryCommunicator::~SharedMemoryCommunicator()
+{
+	if (segment_ == nullptr) {
+		return;
+	}
+	if (rank_ == 0) {
+		// the other ranks may still be inside the last barrier
+		wait_for_children();
+	}
+	munmap(segment_, segment_size_);
+}
+
+void SharedMemoryCommunicator::set_rank(int rank)
+{
+	assert(rank >= 0 and rank < size_);
+	rank_ = rank;
+}
+
+unsigned int* SharedMemoryCommunicator::mailbox(int from, int to) const
+{
+	char* start(static_cast<char*>(segment_) + MAILBOX_OFFSET);
+	return reinterpret_cast<unsigned int*>(start) + (from * size_ + to) * (capacity_ + 1);
+}
+
+void SharedMemoryCommunicator::exchange(RankBuffers const& outgoing, RankBuffers& incoming)
+{
+	assert(outgoing.size() == static_cast<std::size_t>(size_));
+
+	for (int to(0); to < size_; ++to) {
+		if (outgoing[to].size() > capacity_) {
+			abort();
+			throw std::runtime_error("rank " + std::to_string(rank_) + " sends " + std::to_string(outgoing[to].size())
+									 + " words to rank " + std::to_string(to) + ", more than the mailbox capacity");
+		}
+		unsigned int* box(mailbox(rank_, to));
+		box[0] = outgoing[to].size();
+		std::copy(outgoing[to].begin(), outgoing[to].end(), box + 1);
+	}
+
+	// every mailbox addressed to this rank is written
+	barrier();
+
+	incoming.resize(size_);
+	for (int from(0); from < size_; ++from) {
+		unsigned int const* box(mailbox(from, rank_));
+		incoming[from].assign(box + 1, box + 1 + box[0]);
+	}
+
+	// nobody writes the next exchange before everybody has read this one
+	barrier();
+}
+
+void SharedMemoryCommunicator::barrier()
+{
+	SegmentHeader* header(header_of(segment_));
+	// the sense can't flip before this rank has arrived
+	int const sense(header->sense.load(std::memory_order_relaxed));
+
+	if (header->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		// last one in: prepare the next round, then release everybody
+		header->remaining.store(size_, std::memory_order_relaxed);
+		header->sense.store(!sense, std::memory_order_seq_cst);
+		futex_wake_all(&header->sense);
+		return;
+	}
+
+	for (unsigned int spin(0); spin < BARRIER_SPINS; ++spin) {
+		if (header->sense.load(std::memory_order_acquire) != sense) {
+			return;
+		}
+		relax();
+	}
+	while (header->sense.load(std::memory_order_seq_cst) == sense) {
+		if (header->aborted.load(std::memory_order_acquire) != 0) {
+			throw std::runtime_error("rank " + std::to_string(rank_) + ": another rank aborted the exchange");
+		}
+		futex_wait(&header->sense, sense);
+	}
+}
+
+void SharedMemoryCommunicator::abort()
+{
+	SegmentHeader* header(header_of(segment_));
+	header->aborted.store(1, std::memory_order_release);
+	futex_wake_all(&header->sense);
+}
@@ -0,0 +1,68 @@
+/*! \class SharedMemoryCommunicator
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Communicator between processes of one machine, through a POSIX shared memory segment.
+ *  \details The segment holds one mailbox per (source, destination) pair and a barrier shared by the processes,
+ *  \details which a failing rank aborts so that the other ranks throw instead of waiting for it forever.
+ *  \details It is created before the ranks are forked, so every rank inherits the mapping.
+ */
+
+#ifndef SHAREDMEMORYCOMMUNICATOR_H
+#define SHAREDMEMORYCOMMUNICATOR_H
+
+#include "Communicator.hpp"
+
+class SharedMemoryCommunicator : public Communicator
+{
+	private :
+
+		/*! \brief Start of the mapped segment */
+		void* segment_;
+
+		/*! \brief Size of the mapped segment in bytes */
+		std::size_t segment_size_;
+
+		/*! \brief Maximal number of words in one mailbox */
+		std::size_t capacity_;
+
+		/*! \brief Returns the mailbox written by rank from and read by rank to.
+		 *  \details The first word of a mailbox is the number of words it contains.
+		 */
+		unsigned int* mailbox(int from, int to) const;
+
+	public :
+
+		/*! \brief Constructor
+		 *  \details Creates and maps the shared segment; the rank is 0 until set_rank() is called.
+		 * @param[in] size the number of ranks
+		 * @param[in] capacity maximal number of words a rank sends to another rank per exchange
+		 * \throw runtime_error if the segment cannot be created
+		 */
+		SharedMemoryCommunicator(int size, std::size_t capacity);
+
+		/*! \brief Destructor
+		 *  \details Unmaps the segment; rank 0 first waits for the other ranks.
+		 */
+		~SharedMemoryCommunicator();
+
+		/*! \brief Sets the rank, called in each process after forking */
+		void set_rank(int rank);
+
+		/*! \brief See Communicator::exchange()
+		 * \throw runtime_error if a buffer does not fit in its mailbox, after aborting the exchange of the other ranks
+		 */
+		void exchange(RankBuffers const& outgoing, RankBuffers& incoming) override;
+
+		/*! \brief See Communicator::barrier()
+		 * \throw runtime_error if another rank aborted
+		 */
+		void barrier() override;
+
+		/*! \brief See Communicator::abort() */
+		void abort() override;
+};
+
+#endif /* SharedMemoryCommunicator_hpp */
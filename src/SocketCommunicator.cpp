@@ -0,0 +1,248 @@
+#include "SocketCommunicator.hpp"
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+/*! Number of attempts to connect to a rank which is not listening yet */
+constexpr int CONNECTION_ATTEMPTS (500);
+
+/*! Pause between two connection attempts [microseconds] */
+constexpr int CONNECTION_RETRY_DELAY (10000);
+
+void fail(std::string const& what)
+{
+	throw std::runtime_error(what + ": " + strerror(errno));
+}
+
+sockaddr_in address_of(std::string const& host, int port)
+{
+	sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+		throw std::runtime_error("invalid host address " + host);
+	}
+	return address;
+}
+
+/*! Blocking transfer of exactly size bytes, only used while connecting */
+void send_all(int socket, void const* data, std::size_t size)
+{
+	char const* bytes(static_cast<char const*>(data));
+	while (size > 0) {
+		ssize_t sent = send(socket, bytes, size, MSG_NOSIGNAL);
+		if (sent < 0) {
+			if (errno == EINTR) continue;
+			fail("send");
+		}
+		bytes += sent;
+		size -= sent;
+	}
+}
+
+void receive_all(int socket, void* data, std::size_t size)
+{
+	char* bytes(static_cast<char*>(data));
+	while (size > 0) {
+		ssize_t received = recv(socket, bytes, size, 0);
+		if (received == 0) {
+			throw std::runtime_error("connection closed by peer rank");
+		}
+		if (received < 0) {
+			if (errno == EINTR) continue;
+			fail("recv");
+		}
+		bytes += received;
+		size -= received;
+	}
+}
+
+/*! State of the transfer with one peer during an exchange */
+struct Transfer
+{
+	std::vector<unsigned int> out;	// word count followed by the words
+	std::size_t sent;				// bytes of out already sent
+	unsigned int count;				// number of words announced by the peer
+	std::size_t received;			// bytes received so far, count included
+};
+
+}
+
+SocketCommunicator::SocketCommunicator(int rank, int size, std::string const& host, int port)
+	: Communicator(rank, size), peers_(size, -1)
+{
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	if (listener < 0) {
+		fail("socket");
+	}
+	int yes(1);
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+	sockaddr_in own(address_of(host, port + rank));
+	if (bind(listener, reinterpret_cast<sockaddr*>(&own), sizeof(own)) != 0 or listen(listener, size) != 0) {
+		close(listener);
+		fail("rank " + std::to_string(rank) + " couldn't listen on port " + std::to_string(port + rank));
+	}
+
+	// connect to the lower ranks, which may not be listening yet
+	for (int peer(0); peer < rank; ++peer) {
+		sockaddr_in address(address_of(host, port + peer));
+		int connection(-1);
+		for (int attempt(0); attempt < CONNECTION_ATTEMPTS and connection < 0; ++attempt) {
+			connection = socket(AF_INET, SOCK_STREAM, 0);
+			if (connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+				close(connection);
+				connection = -1;
+				usleep(CONNECTION_RETRY_DELAY);
+			}
+		}
+		if (connection < 0) {
+			close(listener);
+			fail("rank " + std::to_string(rank) + " couldn't connect to rank " + std::to_string(peer));
+		}
+		unsigned int me(rank);
+		send_all(connection, &me, sizeof(me));
+		peers_[peer] = connection;
+	}
+
+	// the higher ranks connect to us and introduce themselves
+	for (int accepted(rank + 1); accepted < size; ++accepted) {
+		int connection = accept(listener, nullptr, nullptr);
+		if (connection < 0) {
+			close(listener);
+			fail("accept");
+		}
+		unsigned int peer(0);
+		receive_all(connection, &peer, sizeof(peer));
+		assert(peer > static_cast<unsigned int>(rank) and peer < static_cast<unsigned int>(size));
+		peers_[peer] = connection;
+	}
+	close(listener);
+
+	// spike lists are small, don't let Nagle's algorithm delay them
+	for (auto const peer : peers_) {
+		if (peer >= 0) {
+			setsockopt(peer, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+		}
+	}
+}
+
+SocketCommunicator::~SocketCommunicator()
+{
+	for (auto const peer : peers_) {
+		if (peer >= 0) {
+			close(peer);
+		}
+	}
+}
+
+void SocketCommunicator::exchange(RankBuffers const& outgoing, RankBuffers& incoming)
+{
+	assert(outgoing.size() == static_cast<std::size_t>(size_));
+
+	incoming.resize(size_);
+	incoming[rank_] = outgoing[rank_];
+
+	std::vector<Transfer> transfers(size_);
+	std::size_t pending(0);
+	for (int peer(0); peer < size_; ++peer) {
+		if (peer == rank_) continue;
+		Transfer& transfer(transfers[peer]);
+		transfer.out.reserve(outgoing[peer].size() + 1);
+		transfer.out.push_back(outgoing[peer].size());
+		transfer.out.insert(transfer.out.end(), outgoing[peer].begin(), outgoing[peer].end());
+		transfer.sent = 0;
+		transfer.count = 0;
+		transfer.received = 0;
+		incoming[peer].clear();
+		pending += 2;
+	}
+
+	// send and receive simultaneously, so that full socket buffers on both sides cannot block us
+	std::vector<pollfd> polled;
+	std::vector<int> polled_peers;
+	while (pending > 0) {
+		polled.clear();
+		polled_peers.clear();
+		for (int peer(0); peer < size_; ++peer) {
+			if (peer == rank_) continue;
+			Transfer const& transfer(transfers[peer]);
+			short events(0);
+			if (transfer.sent < transfer.out.size() * sizeof(unsigned int)) {
+				events |= POLLOUT;
+			}
+			if (transfer.received < sizeof(unsigned int) or transfer.received < (transfer.count + 1) * sizeof(unsigned int)) {
+				events |= POLLIN;
+			}
+			if (events != 0) {
+				pollfd entry;
+				entry.fd = peers_[peer];
+				entry.events = events;
+				entry.revents = 0;
+				polled.push_back(entry);
+				polled_peers.push_back(peer);
+			}
+		}
+
+		if (poll(polled.data(), polled.size(), -1) < 0) {
+			if (errno == EINTR) continue;
+			fail("poll");
+		}
+
+		for (std::size_t i(0); i < polled.size(); ++i) {
+			int peer(polled_peers[i]);
+			Transfer& transfer(transfers[peer]);
+
+			if (polled[i].revents & POLLOUT) {
+				std::size_t total(transfer.out.size() * sizeof(unsigned int));
+				char const* bytes(reinterpret_cast<char const*>(transfer.out.data()));
+				ssize_t sent = send(peers_[peer], bytes + transfer.sent, total - transfer.sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+				if (sent < 0 and errno != EAGAIN and errno != EWOULDBLOCK and errno != EINTR) {
+					fail("send to rank " + std::to_string(peer));
+				}
+				if (sent > 0) {
+					transfer.sent += sent;
+					if (transfer.sent == total) {
+						--pending;
+					}
+				}
+			}
+
+			if (polled[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+				ssize_t received(0);
+				if (transfer.received < sizeof(unsigned int)) {
+					char* bytes(reinterpret_cast<char*>(&transfer.count));
+					received = recv(peers_[peer], bytes + transfer.received, sizeof(unsigned int) - transfer.received, MSG_DONTWAIT);
+					if (received > 0 and transfer.received + received == sizeof(unsigned int)) {
+						incoming[peer].resize(transfer.count);
+					}
+				} else {
+					std::size_t offset(transfer.received - sizeof(unsigned int));
+					char* bytes(reinterpret_cast<char*>(incoming[peer].data()));
+					received = recv(peers_[peer], bytes + offset, transfer.count * sizeof(unsigned int) - offset, MSG_DONTWAIT);
+				}
+				if (received == 0) {
+					throw std::runtime_error("rank " + std::to_string(peer) + " closed the connection");
+				}
+				if (received < 0 and errno != EAGAIN and errno != EWOULDBLOCK and errno != EINTR) {
+					fail("recv from rank " + std::to_string(peer));
+				}
+				if (received > 0) {
+					transfer.received += received;
+					if (transfer.received == (transfer.count + 1) * sizeof(unsigned int)) {
+						--pending;
+					}
+				}
+			}
+		}
+	}
+}
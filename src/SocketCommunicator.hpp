@@ -0,0 +1,44 @@
+/*! \class SocketCommunicator
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Communicator over TCP sockets, with one connection between every pair of ranks.
+ *  \details Rank r listens on port + r and connects to every lower rank.
+ *  \details Messages are a word count followed by the words, sent without blocking so that
+ *  \details large exchanges cannot deadlock.
+ */
+
+#ifndef SOCKETCOMMUNICATOR_H
+#define SOCKETCOMMUNICATOR_H
+
+#include "Communicator.hpp"
+
+class SocketCommunicator : public Communicator
+{
+	private :
+
+		/*! \brief Connected socket to each peer rank, -1 for this rank */
+		std::vector<int> peers_;
+
+	public :
+
+		/*! \brief Constructor
+		 *  \details Blocks until the connections to all other ranks are established.
+		 * @param[in] rank the rank of this process
+		 * @param[in] size the number of ranks
+		 * @param[in] host address of the machine running the ranks
+		 * @param[in] port first TCP port, rank r listens on port + r
+		 * \throw runtime_error if a connection cannot be established
+		 */
+		SocketCommunicator(int rank, int size, std::string const& host, int port);
+
+		/*! \brief Destructor, closes the connections */
+		~SocketCommunicator();
+
+		/*! \brief See Communicator::exchange() */
+		void exchange(RankBuffers const& outgoing, RankBuffers& incoming) override;
+};
+
+#endif /* SocketCommunicator_hpp */
@@ -0,0 +1,173 @@
+#include "SpikeStatistics.hpp"
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+
+namespace {
+
+/*! Adds a spike at time step t to the counts of windows of window_steps steps */
+inline void count(int t, int window_steps, int& window, int& window_count, long& sum, long& square)
+{
+	int const current(t / window_steps);
+	if (current != window) {
+		sum += window_count;
+		square += static_cast<long>(window_count) * window_count;
+		window = current;
+		window_count = 0;
+	}
+	++window_count;
+}
+
+/*! Mean and variance of the counts of the complete windows, with the pending window if it is complete */
+inline void moments(int complete, int window, int window_count, long sum, long square, double& mean, double& variance)
+{
+	if (window < complete) {
+		sum += window_count;
+		square += static_cast<long>(window_count) * window_count;
+	}
+	mean = double(sum) / complete;
+	variance = double(square) / complete - mean * mean;
+}
+
+}
+
+SpikeStatistics::SpikeStatistics(double time_step, double window, double bin)
+	: time_step_(time_step), window_steps_(std::lround(window / time_step)), bin_steps_(std::lround(bin / time_step)),
+	  steps_(0), population_count_(0), population_sum_(0), population_square_(0)
+{
+	if (window_steps_ < 1 or bin_steps_ < 1) {
+		throw std::runtime_error("the windows of the statistics have to be at least one time step long");
+	}
+}
+
+void SpikeStatistics::start(unsigned int number_of_neurons)
+{
+	steps_ = 0;
+	spike_counts_.assign(number_of_neurons, 0);
+	last_spikes_.assign(number_of_neurons, -1);
+	interval_means_.assign(number_of_neurons, 0.0);
+	interval_deviations_.assign(number_of_neurons, 0.0);
+	windows_.assign(number_of_neurons, 0);
+	window_counts_.assign(number_of_neurons, 0);
+	window_sums_.assign(number_of_neurons, 0);
+	window_squares_.assign(number_of_neurons, 0);
+	bins_.assign(number_of_neurons, 0);
+	bin_counts_.assign(number_of_neurons, 0);
+	bin_sums_.assign(number_of_neurons, 0);
+	bin_squares_.assign(number_of_neurons, 0);
+	population_count_ = 0;
+	population_sum_ = 0;
+	population_square_ = 0;
+}
+
+void SpikeStatistics::record_spike(unsigned int neuron, int t)
+{
+	int const spikes(++spike_counts_[neuron]);
+	if (last_spikes_[neuron] >= 0) {
+		// Welford's update with the spikes - 1 intervals so far
+		double const interval((t - last_spikes_[neuron]) * time_step_);
+		double const delta(interval - interval_means_[neuron]);
+		interval_means_[neuron] += delta / (spikes - 1);
+		interval_deviations_[neuron] += delta * (interval - interval_means_[neuron]);
+	}
+	last_spikes_[neuron] = t;
+
+	count(t, window_steps_, windows_[neuron], window_counts_[neuron], window_sums_[neuron], window_squares_[neuron]);
+	count(t, bin_steps_, bins_[neuron], bin_counts_[neuron], bin_sums_[neuron], bin_squares_[neuron]);
+}
+
+void SpikeStatistics::record_step(int spikes)
+{
+	++steps_;
+	population_count_ += spikes;
+	if (steps_ % bin_steps_ == 0) {
+		population_sum_ += population_count_;
+		population_square_ += double(population_count_) * population_count_;
+		population_count_ = 0;
+	}
+}
+
+SpikeSummary SpikeStatistics::summarize() const
+{
+	unsigned int const neurons(spike_counts_.size());
+	double const duration(steps_ * time_step_);
+	int const complete_windows(steps_ / window_steps_);
+	int const complete_bins(steps_ / bin_steps_);
+
+	SpikeSummary summary {neurons, duration, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	if (neurons == 0 or steps_ == 0) {
+		return summary;
+	}
+
+	double rate_square(0), neuron_variances(0);
+	unsigned int silent(0), regular(0), counted(0);
+	for (unsigned int i(0); i < neurons; ++i) {
+		summary.spikes += spike_counts_[i];
+		double const rate(spike_counts_[i] * 1000.0 / duration);
+		summary.mean_rate += rate;
+		rate_square += rate * rate;
+		if (spike_counts_[i] == 0) {
+			++silent;
+		}
+		if (spike_counts_[i] >= 3) {
+			double const deviation(std::sqrt(interval_deviations_[i] / (spike_counts_[i] - 2)));
+			summary.mean_cv += deviation / interval_means_[i];
+			++regular;
+		}
+
+		double mean, variance;
+		if (complete_windows > 0) {
+			moments(complete_windows, windows_[i], window_counts_[i], window_sums_[i], window_squares_[i], mean, variance);
+			if (mean > 0) {
+				summary.mean_fano += variance / mean;
+				++counted;
+			}
+		}
+		if (complete_bins > 0) {
+			moments(complete_bins, bins_[i], bin_counts_[i], bin_sums_[i], bin_squares_[i], mean, variance);
+			neuron_variances += variance;
+		}
+	}
+
+	summary.mean_rate /= neurons;
+	summary.rate_deviation = std::sqrt(std::max(0.0, rate_square / neurons - summary.mean_rate * summary.mean_rate));
+	summary.silent_fraction = double(silent) / neurons;
+	summary.mean_cv = regular > 0 ? summary.mean_cv / regular : 0;
+	summary.mean_fano = counted > 0 ? summary.mean_fano / counted : 0;
+
+	if (complete_bins > 0) {
+		double const mean(population_sum_ / complete_bins);
+		double const variance(population_square_ / complete_bins - mean * mean);
+		double const to_rate(1000.0 / (neurons * bin_steps_ * time_step_));
+		summary.population_rate = mean * to_rate;
+		summary.population_rate_variance = variance * to_rate * to_rate;
+		// chi^2 = Var(population count) / (N sum of the variances of the counts of the neurons)
+		if (neuron_variances > 0) {
+			summary.synchrony = std::sqrt(std::max(0.0, variance / (neurons * neuron_variances)));
+		}
+	}
+	return summary;
+}
+
+void SpikeStatistics::write(std::string const& file_name) const
+{
+	std::ofstream file(file_name);
+	if (file.fail()) {
+		throw std::runtime_error("file " + file_name + " couldn't be opened");
+	}
+	SpikeSummary const summary(summarize());
+	file << "neurons " << summary.neurons << std::endl;
+	file << "duration_ms " << summary.duration << std::endl;
+	file << "spikes " << summary.spikes << std::endl;
+	file << "mean_rate_hz " << summary.mean_rate << std::endl;
+	file << "rate_deviation_hz " << summary.rate_deviation << std::endl;
+	file << "silent_fraction " << summary.silent_fraction << std::endl;
+	file << "mean_cv " << summary.mean_cv << std::endl;
+	file << "mean_fano " << summary.mean_fano << std::endl;
+	file << "fano_window_ms " << window_steps_ * time_step_ << std::endl;
+	file << "population_rate_hz " << summary.population_rate << std::endl;
+	file << "population_rate_variance_hz2 " << summary.population_rate_variance << std::endl;
+	file << "synchrony_bin_ms " << bin_steps_ * time_step_ << std::endl;
+	file << "synchrony " << summary.synchrony << std::endl;
+}
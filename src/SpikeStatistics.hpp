@@ -0,0 +1,105 @@
+/*! \class SpikeStatistics
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Statistics of the spike trains, accumulated during the simulation.
+ *  \details For each neuron: the number of spikes, the mean and variance of the interspike intervals
+ *  \details (Welford's algorithm), and the sums of the spike counts and of their squares over windows of
+ *  \details a fixed length, from which the Fano factor follows. For the population: the sums of the number
+ *  \details of spikes and of its square over short bins, from which the synchrony measure chi of Golomb
+ *  \details (2007) follows, the standard deviation of the population rate over the mean of the standard
+ *  \details deviations of the rates of the single neurons: 1 / sqrt(N) for independent neurons, 1 when they are synchronous.
+ *  \details Only complete windows and bins are taken into account.
+ *  \details record_spike() only touches the state of its neuron, so that the workers can call it concurrently for their neurons.
+ */
+
+#ifndef SPIKESTATISTICS_H
+#define SPIKESTATISTICS_H
+
+#include <vector>
+#include <string>
+
+/*! Default length of the windows of the Fano factor [ms] */
+constexpr double DEFAULT_FANO_WINDOW (100.0);
+
+/*! Default length of the bins of the synchrony [ms] */
+constexpr double DEFAULT_SYNCHRONY_BIN (1.0);
+
+/*! \brief Summary of the statistics */
+struct SpikeSummary
+{
+	unsigned int neurons;
+	/*! Simulated time [ms] */
+	double duration;
+	long spikes;
+	/*! Mean and standard deviation of the rates of the neurons [Hz] */
+	double mean_rate, rate_deviation;
+	/*! Fraction of the neurons which never spiked */
+	double silent_fraction;
+	/*! Mean coefficient of variation of the interspike intervals, over the neurons with 3 spikes or more */
+	double mean_cv;
+	/*! Mean Fano factor of the spike counts, over the neurons which spiked in a complete window */
+	double mean_fano;
+	/*! Mean and variance of the population rate over the synchrony bins [Hz, Hz^2] */
+	double population_rate, population_rate_variance;
+	/*! Synchrony measure chi */
+	double synchrony;
+};
+
+class SpikeStatistics
+{
+	private :
+
+		double const time_step_;
+		int const window_steps_, bin_steps_;
+
+		/*! \brief Number of time steps recorded */
+		int steps_;
+
+		/*! \brief Per neuron: number of spikes, time step of the last one, mean and sum of squared deviations of the intervals [ms] */
+		std::vector<int> spike_counts_, last_spikes_;
+		std::vector<double> interval_means_, interval_deviations_;
+
+		/*! \brief Per neuron: current window, spikes in it, and sums of the counts and squared counts of the previous windows */
+		std::vector<int> windows_, window_counts_;
+		std::vector<long> window_sums_, window_squares_;
+
+		/*! \brief Same as windows_ etc. for the synchrony bins */
+		std::vector<int> bins_, bin_counts_;
+		std::vector<long> bin_sums_, bin_squares_;
+
+		/*! \brief Spikes of the population in the current bin, and sums of the counts and squared counts of the previous bins */
+		long population_count_;
+		double population_sum_, population_square_;
+
+	public :
+
+		/*! \brief Constructor
+		 * @param[in] time_step the time step of the simulation [ms]
+		 * @param[in] window the length of the windows of the Fano factor [ms]
+		 * @param[in] bin the length of the bins of the synchrony [ms]
+		 * \throw runtime_error if a window or a bin is shorter than the time step
+		 */
+		SpikeStatistics(double time_step, double window, double bin);
+
+		/*! \brief Clears the statistics, for number_of_neurons neurons */
+		void start(unsigned int number_of_neurons);
+
+		/*! \brief Records a spike of a neuron at time step t */
+		void record_spike(unsigned int neuron, int t);
+
+		/*! \brief Records the end of a time step, in which the population spiked spikes times */
+		void record_step(int spikes);
+
+		/*! \brief Returns the summary of what was recorded */
+		SpikeSummary summarize() const;
+
+		/*! \brief Writes the summary into a file, one "name value" line per quantity
+		 * \throw runtime_error if the file can't be opened
+		 */
+		void write(std::string const& file_name) const;
+};
+
+#endif /* SpikeStatistics_hpp */
@@ -0,0 +1,200 @@
+#include "SpikeStore.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char HEADER_MAGIC[8] = {'N', 'E', 'U', 'R', 'O', 'S', 'P', 'K'};
+constexpr char TRAILER_MAGIC[8] = {'N', 'E', 'U', 'R', 'O', 'I', 'D', 'X'};
+constexpr std::uint32_t VERSION (1);
+
+}
+
+SpikeStoreWriter::SpikeStoreWriter(std::string const& file_name, unsigned int number_of_neurons, double time_step, double chunk)
+	: file_name_(file_name), file_(file_name, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc),
+	  chunk_steps_(std::lround(chunk / time_step)), current_chunk_(0), spikes_(0), closed_(false)
+{
+	if (file_.fail()) {
+		throw std::runtime_error("file " + file_name + " couldn't be opened");
+	}
+	if (chunk_steps_ < 1) {
+		throw std::runtime_error("the chunks of the spike store have to be at least one time step long");
+	}
+	SpikeStoreHeader header;
+	std::memcpy(header.magic, HEADER_MAGIC, sizeof(header.magic));
+	header.version = VERSION;
+	header.neurons = number_of_neurons;
+	header.time_step = time_step;
+	header.chunk_steps = chunk_steps_;
+	header.reserved = 0;
+	file_.write(reinterpret_cast<char const*>(&header), sizeof(header));
+}
+
+SpikeStoreWriter::~SpikeStoreWriter()
+{
+	if (!closed_) {
+		close();
+	}
+}
+
+void SpikeStoreWriter::record(unsigned int neuron, int step)
+{
+	assert(!closed_);
+	std::int64_t const number(step / chunk_steps_);
+	assert(number >= current_chunk_);
+	if (number != current_chunk_) {
+		flush();
+		current_chunk_ = number;
+	}
+	chunk_.push_back(SpikeEvent{neuron, step});
+	++spikes_;
+}
+
+void SpikeStoreWriter::flush()
+{
+	if (chunk_.empty()) {
+		return;
+	}
+	index_.push_back(SpikeChunk{static_cast<std::uint64_t>(file_.tellp()), chunk_.size(), current_chunk_});
+	file_.write(reinterpret_cast<char const*>(chunk_.data()), chunk_.size() * sizeof(SpikeEvent));
+	chunk_.clear();
+}
+
+void SpikeStoreWriter::close()
+{
+	flush();
+	SpikeStoreTrailer trailer;
+	trailer.index_offset = file_.tellp();
+	trailer.chunks = index_.size();
+	std::memcpy(trailer.magic, TRAILER_MAGIC, sizeof(trailer.magic));
+	file_.write(reinterpret_cast<char const*>(index_.data()), index_.size() * sizeof(SpikeChunk));
+	file_.write(reinterpret_cast<char const*>(&trailer), sizeof(trailer));
+	file_.close();
+	closed_ = true;
+}
+
+std::uint64_t SpikeStoreWriter::spikes() const
+{
+	return spikes_;
+}
+
+std::uint64_t SpikeStoreWriter::chunks() const
+{
+	return index_.size();
+}
+
+std::string const& SpikeStoreWriter::file_name() const
+{
+	return file_name_;
+}
+
+SpikeStoreReader::SpikeStoreReader(std::string const& file_name)
+	: data_(nullptr), size_(0), index_(nullptr), chunks_(0)
+{
+	int const fd(open(file_name.c_str(), O_RDONLY));
+	if (fd < 0) {
+		throw std::runtime_error("file " + file_name + " couldn't be opened: " + strerror(errno));
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0 or static_cast<size_t>(status.st_size) < sizeof(SpikeStoreHeader) + sizeof(SpikeStoreTrailer)) {
+		::close(fd);
+		throw std::runtime_error("file " + file_name + " isn't a spike store");
+	}
+	size_ = status.st_size;
+	void* const data(mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0));
+	::close(fd);
+	if (data == MAP_FAILED) {
+		throw std::runtime_error("file " + file_name + " couldn't be mapped: " + strerror(errno));
+	}
+	data_ = static_cast<char const*>(data);
+
+	SpikeStoreTrailer trailer;
+	std::memcpy(&header_, data_, sizeof(header_));
+	std::memcpy(&trailer, data_ + size_ - sizeof(trailer), sizeof(trailer));
+	if (std::memcmp(header_.magic, HEADER_MAGIC, sizeof(HEADER_MAGIC)) != 0 or header_.version != VERSION
+		or std::memcmp(trailer.magic, TRAILER_MAGIC, sizeof(TRAILER_MAGIC)) != 0
+		or trailer.index_offset + trailer.chunks * sizeof(SpikeChunk) + sizeof(trailer) != size_) {
+		munmap(const_cast<char*>(data_), size_);
+		throw std::runtime_error("file " + file_name + " isn't a complete spike store");
+	}
+	// the header and the chunks are multiples of 8 bytes, the index is aligned
+	index_ = reinterpret_cast<SpikeChunk const*>(data_ + trailer.index_offset);
+	chunks_ = trailer.chunks;
+}
+
+SpikeStoreReader::~SpikeStoreReader()
+{
+	munmap(const_cast<char*>(data_), size_);
+}
+
+unsigned int SpikeStoreReader::number_of_neurons() const
+{
+	return header_.neurons;
+}
+
+double SpikeStoreReader::time_step() const
+{
+	return header_.time_step;
+}
+
+int SpikeStoreReader::chunk_steps() const
+{
+	return header_.chunk_steps;
+}
+
+std::uint64_t SpikeStoreReader::chunks() const
+{
+	return chunks_;
+}
+
+int SpikeStoreReader::end_step() const
+{
+	return chunks_ == 0 ? 0 : (index_[chunks_ - 1].number + 1) * header_.chunk_steps;
+}
+
+SpikeChunk const* SpikeStoreReader::find_chunk(int step) const
+{
+	std::int64_t const number(step / static_cast<int>(header_.chunk_steps));
+	return std::lower_bound(index_, index_ + chunks_, number, [](SpikeChunk const& entry, std::int64_t number) { return entry.number < number; });
+}
+
+std::vector<SpikeEvent> SpikeStoreReader::read_steps(int first_step, int last_step, std::vector<unsigned int> const& neurons) const
+{
+	std::vector<SpikeEvent> events;
+	if (first_step >= last_step) {
+		return events;
+	}
+	std::vector<bool> selected(neurons.empty() ? 0 : header_.neurons, false);
+	for (auto const neuron : neurons) {
+		if (neuron < header_.neurons) {
+			selected[neuron] = true;
+		}
+	}
+
+	// the first chunk which may hold first_step, then the following ones until last_step
+	for (SpikeChunk const* chunk(find_chunk(first_step)); chunk != index_ + chunks_ and chunk->number * header_.chunk_steps < last_step; ++chunk) {
+		SpikeEvent const* const spikes(reinterpret_cast<SpikeEvent const*>(data_ + chunk->offset));
+		for (std::uint64_t i(0); i < chunk->spikes; ++i) {
+			if (spikes[i].step >= last_step) {
+				break;
+			}
+			if (spikes[i].step >= first_step and (selected.empty() or (spikes[i].neuron < selected.size() and selected[spikes[i].neuron]))) {
+				events.push_back(spikes[i]);
+			}
+		}
+	}
+	return events;
+}
+
+std::vector<SpikeEvent> SpikeStoreReader::read(double t0, double t1, std::vector<unsigned int> const& neurons) const
+{
+	return read_steps(std::lround(t0 / header_.time_step), std::lround(t1 / header_.time_step), neurons);
+}
@@ -0,0 +1,174 @@
+/*! \file SpikeStore.hpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Binary file of the spikes of a simulation, split into chunks of a fixed time span.
+ *  \details The file starts with a header, followed by the chunks, each the (neuron, time step) pairs of the spikes
+ *  \details of its time span in the order of the simulation, and ends with the index of the chunks and a trailer
+ *  \details locating the index. Chunks without spikes aren't written. The reader maps the file into memory and
+ *  \details finds the chunks of a time range by a binary search in the index, so that only their pages are read
+ *  \details however long the simulation. All numbers are written in the byte order of the machine.
+ */
+
+#ifndef SPIKESTORE_H
+#define SPIKESTORE_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+/*! Default time span of a chunk [ms] */
+constexpr double DEFAULT_STORE_CHUNK (100.0);
+
+/*! \brief A spike of the file */
+struct SpikeEvent
+{
+	std::uint32_t neuron;
+	std::int32_t step;
+};
+
+/*! \brief Header at the beginning of the file */
+struct SpikeStoreHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t neurons;
+	/*! Time step of the simulation [ms] */
+	double time_step;
+	/*! Number of time steps of a chunk */
+	std::uint32_t chunk_steps;
+	std::uint32_t reserved;
+};
+
+/*! \brief Entry of the index of the chunks */
+struct SpikeChunk
+{
+	/*! Position of the first spike of the chunk in the file */
+	std::uint64_t offset;
+	std::uint64_t spikes;
+	/*! Number of the chunk, which covers the time steps from number * chunk_steps on */
+	std::int64_t number;
+};
+
+/*! \brief Trailer at the end of the file */
+struct SpikeStoreTrailer
+{
+	/*! Position of the index in the file */
+	std::uint64_t index_offset;
+	std::uint64_t chunks;
+	char magic[8];
+};
+
+class SpikeStoreWriter
+{
+	private :
+
+		std::string const file_name_;
+		std::ofstream file_;
+		int const chunk_steps_;
+
+		/*! \brief Spikes of the current chunk, and its number */
+		std::vector<SpikeEvent> chunk_;
+		std::int64_t current_chunk_;
+
+		/*! \brief Index of the chunks written so far */
+		std::vector<SpikeChunk> index_;
+		std::uint64_t spikes_;
+		bool closed_;
+
+		/*! \brief Writes the current chunk and adds it to the index */
+		void flush();
+
+	public :
+
+		/*! \brief Constructor, creates the file and writes its header
+		 * @param[in] file_name the name of the file
+		 * @param[in] number_of_neurons the number of neurons of the network
+		 * @param[in] time_step the time step of the simulation [ms]
+		 * @param[in] chunk the time span of a chunk [ms]
+		 * \throw runtime_error if the file can't be opened or the chunk is shorter than the time step
+		 */
+		SpikeStoreWriter(std::string const& file_name, unsigned int number_of_neurons, double time_step, double chunk);
+
+		/*! \brief Destructor, closes the file if close() wasn't called */
+		~SpikeStoreWriter();
+
+		/*! \brief Records a spike, the steps of the spikes must not decrease */
+		void record(unsigned int neuron, int step);
+
+		/*! \brief Writes the last chunk, the index and the trailer, nothing can be recorded afterwards */
+		void close();
+
+		/*! \brief Returns the number of spikes recorded */
+		std::uint64_t spikes() const;
+
+		/*! \brief Returns the number of chunks written, the current one left out */
+		std::uint64_t chunks() const;
+
+		std::string const& file_name() const;
+};
+
+class SpikeStoreReader
+{
+	private :
+
+		/*! \brief The file mapped into memory and its size in bytes */
+		char const* data_;
+		size_t size_;
+
+		SpikeStoreHeader header_;
+		SpikeChunk const* index_;
+		std::uint64_t chunks_;
+
+		/*! \brief Returns the first chunk of the index which may hold a time step */
+		SpikeChunk const* find_chunk(int step) const;
+
+	public :
+
+		/*! \brief Constructor, maps the file into memory and checks its header and trailer
+		 * \throw runtime_error if the file can't be read or isn't a complete spike store
+		 */
+		SpikeStoreReader(std::string const& file_name);
+
+		/*! \brief Destructor, unmaps the file */
+		~SpikeStoreReader();
+
+		SpikeStoreReader(SpikeStoreReader const&) = delete;
+		SpikeStoreReader& operator=(SpikeStoreReader const&) = delete;
+
+		unsigned int number_of_neurons() const;
+		double time_step() const;
+		int chunk_steps() const;
+		std::uint64_t chunks() const;
+
+		/*! \brief Returns the time step after the span of the last chunk, 0 if the file holds no spike */
+		int end_step() const;
+
+		/*! \brief Calls visit(begin, end) with the spikes of each chunk overlapping the time steps from first_step to last_step excluded
+		 *  \details The chunks come in the order of the simulation. The spikes are read in place from the mapping, without a copy, and may lie outside the time steps
+		 *  \details at both ends, so that a whole file can be streamed through the visitor in a single pass.
+		 */
+		template<typename Visitor>
+		void for_each_chunk(int first_step, int last_step, Visitor visit) const
+		{
+			for (SpikeChunk const* chunk(find_chunk(first_step)); chunk != index_ + chunks_ and chunk->number * header_.chunk_steps < last_step; ++chunk) {
+				SpikeEvent const* const spikes(reinterpret_cast<SpikeEvent const*>(data_ + chunk->offset));
+				visit(spikes, spikes + chunk->spikes);
+			}
+		}
+
+		/*! \brief Returns the spikes of the time steps from first_step to last_step excluded, in the order of the simulation
+		 * @param[in] neurons the neurons whose spikes are returned, all of them if empty
+		 */
+		std::vector<SpikeEvent> read_steps(int first_step, int last_step, std::vector<unsigned int> const& neurons) const;
+
+		/*! \brief Returns the spikes of the time range [t0, t1) [ms], the limits rounded to the nearest time step
+		 * @param[in] neurons the neurons whose spikes are returned, all of them if empty
+		 */
+		std::vector<SpikeEvent> read(double t0, double t1, std::vector<unsigned int> const& neurons) const;
+};
+
+#endif /* SpikeStore_hpp */
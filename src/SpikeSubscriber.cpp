@@ -0,0 +1,81 @@
+#include "SpikeSubscriber.hpp"
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+AsyncSpikeSubscriber::AsyncSpikeSubscriber(SpikeSubscriber* subscriber, unsigned int capacity)
+	: subscriber_(subscriber), capacity_(capacity), finished_(false)
+{
+	if (capacity == 0) {
+		throw std::runtime_error("the queue of an asynchronous subscriber has to hold at least one batch");
+	}
+	thread_ = std::thread(&AsyncSpikeSubscriber::consume, this);
+}
+
+AsyncSpikeSubscriber::~AsyncSpikeSubscriber()
+{
+	on_finish();
+	delete subscriber_;
+}
+
+void AsyncSpikeSubscriber::push(Batch&& batch)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	changed_.wait(lock, [this]() { return queue_.size() < capacity_; });
+	queue_.push_back(std::move(batch));
+	changed_.notify_all();
+}
+
+void AsyncSpikeSubscriber::on_spikes(SpikeSpan const& spikes)
+{
+	assert(!finished_);
+	Batch batch = Batch();
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (!free_.empty()) {
+			batch = std::move(free_.back());
+			free_.pop_back();
+		}
+	}
+	// the buffers keep their capacity from batch to batch
+	batch.first_step = spikes.first_step;
+	batch.steps = spikes.steps;
+	batch.neurons.assign(spikes.begin(), spikes.end());
+	batch.offsets.assign(spikes.offsets, spikes.offsets + spikes.steps + 1);
+	batch.last = false;
+	push(std::move(batch));
+}
+
+void AsyncSpikeSubscriber::on_finish()
+{
+	if (finished_) {
+		return;
+	}
+	Batch last = Batch();
+	last.last = true;
+	push(std::move(last));
+	thread_.join();
+	finished_ = true;
+}
+
+void AsyncSpikeSubscriber::consume()
+{
+	while (true) {
+		Batch batch;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			changed_.wait(lock, [this]() { return !queue_.empty(); });
+			batch = std::move(queue_.front());
+			queue_.pop_front();
+			changed_.notify_all();
+		}
+		if (batch.last) {
+			subscriber_->on_finish();
+			return;
+		}
+		subscriber_->on_spikes(SpikeSpan{batch.first_step, batch.steps, batch.neurons.data(), batch.offsets.data()});
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		free_.push_back(std::move(batch));
+	}
+}
@@ -0,0 +1,120 @@
+/*! \file SpikeSubscriber.hpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Consumers of the spikes of the simulation, e.g. an online analysis, a closed-loop controller or a recorder.
+ *  \details A subscriber registered with Cortex::add_spike_subscriber() receives after each time step, or after each
+ *  \details batch of time steps, e.g. an epoch between two spike exchanges, a read-only span of the neurons which
+ *  \details spiked, pointing into the buffers of the Cortex. Nothing is collected when no subscriber is registered.
+ *  \details AsyncSpikeSubscriber runs a subscriber on a thread of its own, so that a slow consumer only delays the
+ *  \details simulation once it is more than a few batches behind.
+ */
+
+#ifndef SPIKESUBSCRIBER_H
+#define SPIKESUBSCRIBER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*! Default number of batches an AsyncSpikeSubscriber holds before the simulation waits for it */
+constexpr unsigned int DEFAULT_ASYNC_BATCHES (64);
+
+/*! \brief The neurons which spiked in consecutive time steps, valid during the call it is passed to only */
+struct SpikeSpan
+{
+	/*! First time step of the span and number of time steps */
+	int first_step;
+	int steps;
+	/*! The global indexes of the neurons which spiked, time step after time step, each in increasing order */
+	unsigned int const* neurons;
+	/*! The spikes of time step first_step + s are neurons[offsets[s]] to neurons[offsets[s + 1]] excluded */
+	unsigned int const* offsets;
+
+	/*! \brief Returns the number of spikes of the span */
+	size_t size() const { return offsets[steps]; }
+
+	unsigned int const* begin() const { return neurons; }
+	unsigned int const* end() const { return neurons + size(); }
+
+	/*! \brief Returns the first spike of a time step of the span, and the one after its last */
+	unsigned int const* step_begin(int step) const { return neurons + offsets[step - first_step]; }
+	unsigned int const* step_end(int step) const { return neurons + offsets[step - first_step + 1]; }
+};
+
+class SpikeSubscriber
+{
+	public :
+
+		virtual ~SpikeSubscriber() {}
+
+		/*! \brief Receives the spikes of a time step or of a batch of time steps, on the thread of the simulation */
+		virtual void on_spikes(SpikeSpan const& spikes) = 0;
+
+		/*! \brief Called by Cortex::finish(), after the last spikes */
+		virtual void on_finish() {}
+};
+
+/*! \brief Passes the spans to a subscriber running on a thread of its own
+ *  \details The spans are copied into recycled buffers and queued. No span is lost: the simulation waits when the
+ *  \details queue is full, until the subscriber has caught up.
+ */
+class AsyncSpikeSubscriber : public SpikeSubscriber
+{
+	private :
+
+		/*! \brief A copied span, or the end of the spikes */
+		struct Batch
+		{
+			int first_step;
+			int steps;
+			std::vector<unsigned int> neurons;
+			std::vector<unsigned int> offsets;
+			bool last;
+		};
+
+		SpikeSubscriber* const subscriber_;
+		unsigned int const capacity_;
+
+		std::mutex mutex_;
+		std::condition_variable changed_;
+		/*! \brief Batches waiting for the subscriber, and the buffers it is done with */
+		std::deque<Batch> queue_;
+		std::vector<Batch> free_;
+		bool finished_;
+
+		std::thread thread_;
+
+		/*! \brief Loop of the thread, passes the batches to the subscriber until the last one */
+		void consume();
+
+		/*! \brief Waits for room in the queue, then queues a batch */
+		void push(Batch&& batch);
+
+	public :
+
+		/*! \brief Constructor, starts the thread
+		 * @param[in] subscriber the subscriber, of which it takes ownership
+		 * @param[in] capacity the number of batches queued before the simulation waits
+		 */
+		AsyncSpikeSubscriber(SpikeSubscriber* subscriber, unsigned int capacity = DEFAULT_ASYNC_BATCHES);
+
+		/*! \brief Destructor, finishes the subscriber if on_finish() wasn't called, and deletes it */
+		~AsyncSpikeSubscriber();
+
+		AsyncSpikeSubscriber(AsyncSpikeSubscriber const&) = delete;
+		AsyncSpikeSubscriber& operator=(AsyncSpikeSubscriber const&) = delete;
+
+		/*! \brief Copies and queues the spikes */
+		void on_spikes(SpikeSpan const& spikes) override;
+
+		/*! \brief Waits until the subscriber has received every span and finished */
+		void on_finish() override;
+};
+
+#endif /* SpikeSubscriber_hpp */
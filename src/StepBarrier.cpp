@@ -0,0 +1,83 @@
+#include "StepBarrier.hpp"
+#include <cassert>
+#include <climits>
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+static_assert(sizeof(std::atomic<int>) == sizeof(int), "the futex word has to be a plain int");
+
+/*! Tells the core we are spinning, so that it can let its sibling hyperthread run */
+inline void relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield" ::: "memory");
+#endif
+}
+
+/*! Number of CPUs this process may run on */
+unsigned int available_cpus()
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+		return 1;
+	}
+	return CPU_COUNT(&set);
+}
+
+void futex_wait(std::atomic<int>* word, int value)
+{
+	// returns at once if the word doesn't hold value anymore, or spuriously: the caller checks again
+	syscall(SYS_futex, reinterpret_cast<int*>(word), FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+}
+
+void futex_wake_all(std::atomic<int>* word)
+{
+	syscall(SYS_futex, reinterpret_cast<int*>(word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+}
+
+StepBarrier::StepBarrier(unsigned int count, unsigned int spins)
+	: sense_(0), remaining_(count), sleepers_(0), count_(count),
+	  // with more threads than CPUs, the thread we wait for may need our CPU: don't spin then
+	  spins_(count > available_cpus() ? 0 : spins)
+{
+	assert(count > 0);
+}
+
+void StepBarrier::wait()
+{
+	// the sense can't flip before this thread has arrived
+	int const sense(sense_.load(std::memory_order_relaxed));
+
+	if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		// last one in: prepare the next round, then release everybody
+		remaining_.store(count_, std::memory_order_relaxed);
+		sense_.store(!sense, std::memory_order_seq_cst);
+		if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+			futex_wake_all(&sense_);
+		}
+		return;
+	}
+
+	for (unsigned int spin(0); spin < spins_; ++spin) {
+		if (sense_.load(std::memory_order_acquire) != sense) {
+			return;
+		}
+		relax();
+	}
+
+	// registering as sleeper before checking the sense again means the last thread can't miss us
+	sleepers_.fetch_add(1, std::memory_order_seq_cst);
+	while (sense_.load(std::memory_order_seq_cst) == sense) {
+		futex_wait(&sense_, sense);
+	}
+	sleepers_.fetch_sub(1, std::memory_order_relaxed);
+}
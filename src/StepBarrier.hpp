@@ -0,0 +1,67 @@
+/*! \class StepBarrier
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Sense-reversing barrier synchronizing the workers between the phases of a time step.
+ *  \details A time step of the network takes a few microseconds, less than a thread takes to be woken up.
+ *  \details Waiting threads therefore spin for a while on the sense word and only then sleep on it with a futex.
+ *  \details The sense word and the arrival counter sit on cache lines of their own, so that spinning
+ *  \details threads don't slow down the ones still arriving.
+ */
+
+#ifndef STEPBARRIER_H
+#define STEPBARRIER_H
+
+#include <atomic>
+
+/*! Size of a cache line [bytes] */
+constexpr unsigned int CACHE_LINE_SIZE (64);
+
+/*! Number of times a waiting thread checks the sense word before sleeping */
+constexpr unsigned int DEFAULT_BARRIER_SPINS (4000);
+
+class StepBarrier
+{
+	private :
+
+		/*! \brief Keeps sense_ off the cache line of whatever precedes the barrier */
+		char leading_padding_[CACHE_LINE_SIZE];
+
+		/*! \brief Flipped by the last thread to arrive, the waiting threads watch it
+		 *  \details Also the futex word the sleeping threads wait on.
+		 */
+		std::atomic<int> sense_;
+		char sense_padding_[CACHE_LINE_SIZE - sizeof(std::atomic<int>)];
+
+		/*! \brief Number of threads still expected in the current round */
+		std::atomic<unsigned int> remaining_;
+
+		/*! \brief Number of threads sleeping on the futex, so that the last one only wakes them when needed */
+		std::atomic<unsigned int> sleepers_;
+		char counter_padding_[CACHE_LINE_SIZE - 2 * sizeof(std::atomic<unsigned int>)];
+
+		/*! \brief Number of threads taking part in each round */
+		unsigned int const count_;
+
+		/*! \brief Number of checks of sense_ before sleeping */
+		unsigned int const spins_;
+
+	public :
+
+		/*! \brief Constructor
+		 * @param[in] count the number of threads taking part
+		 * @param[in] spins the number of checks before a waiting thread sleeps, 0 to sleep at once
+		 *  \details Threads never spin if there are more of them than CPUs available to the process.
+		 */
+		explicit StepBarrier(unsigned int count, unsigned int spins = DEFAULT_BARRIER_SPINS);
+
+		StepBarrier(StepBarrier const&) = delete;
+		StepBarrier& operator=(StepBarrier const&) = delete;
+
+		/*! \brief Blocks until count threads have called wait() in this round */
+		void wait();
+};
+
+#endif /* StepBarrier_hpp */
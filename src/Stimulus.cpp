@@ -0,0 +1,235 @@
+#include "Stimulus.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include "RecordingPolicy.hpp"
+
+namespace {
+
+constexpr double TWO_PI (6.283185307179586);
+
+/*! \brief Reads the numbers following the name of a stimulus, separated by ',' */
+std::vector<double> parse_parameters(std::string const& description, std::string const& parameters)
+{
+	std::vector<double> values;
+	std::stringstream list(parameters);
+	std::string item;
+	while (std::getline(list, item, ',')) {
+		char* end(nullptr);
+		values.push_back(std::strtod(item.c_str(), &end));
+		if (item.empty() or *end != '\0') {
+			throw std::runtime_error("invalid number " + item + " in the stimulus " + description);
+		}
+	}
+	return values;
+}
+
+}
+
+Stimulus::Stimulus(StimulusShape shape)
+	: shape_(shape), from_(0), to_(0), ratio_(0), amplitude_(0), frequency_(0), phase_(0)
+{}
+
+Stimulus Stimulus::step(double from, double to, double ratio)
+{
+	if (from < 0 or to <= from or ratio < 0) {
+		throw std::runtime_error("a step needs a time window and a rate, positive or 0");
+	}
+	Stimulus stimulus(StimulusShape::step);
+	stimulus.from_ = from;
+	stimulus.to_ = to;
+	stimulus.ratio_ = ratio;
+	return stimulus;
+}
+
+Stimulus Stimulus::ramp(double from, double to, double ratio)
+{
+	if (from < 0 or to <= from or ratio < 0) {
+		throw std::runtime_error("a ramp needs a time window and a rate, positive or 0");
+	}
+	Stimulus stimulus(StimulusShape::ramp);
+	stimulus.from_ = from;
+	stimulus.to_ = to;
+	stimulus.ratio_ = ratio;
+	return stimulus;
+}
+
+Stimulus Stimulus::sinusoid(double amplitude, double frequency, double phase)
+{
+	if (amplitude < 0 or frequency <= 0) {
+		throw std::runtime_error("a sine wave needs an amplitude, positive or 0, and a positive frequency");
+	}
+	Stimulus stimulus(StimulusShape::sinusoid);
+	stimulus.amplitude_ = amplitude;
+	stimulus.frequency_ = frequency;
+	stimulus.phase_ = phase;
+	return stimulus;
+}
+
+Stimulus Stimulus::series(std::vector<double> const& times, std::vector<double> const& ratios)
+{
+	if (times.empty() or times.size() != ratios.size()) {
+		throw std::runtime_error("a time series needs a rate for each of its times");
+	}
+	for (size_t i(0); i < times.size(); ++i) {
+		if ((i > 0 and times[i] <= times[i - 1]) or ratios[i] < 0) {
+			throw std::runtime_error("the times of a time series have to increase and its rates to be positive or 0");
+		}
+	}
+	Stimulus stimulus(StimulusShape::series);
+	stimulus.times_ = times;
+	stimulus.ratios_ = ratios;
+	return stimulus;
+}
+
+Stimulus Stimulus::load(std::string const& file)
+{
+	std::ifstream input(file);
+	if (!input) {
+		throw std::runtime_error("the time series " + file + " can't be read");
+	}
+	std::vector<double> times, ratios;
+	double time, ratio;
+	while (input >> time >> ratio) {
+		times.push_back(time);
+		ratios.push_back(ratio);
+	}
+	if (!input.eof()) {
+		throw std::runtime_error("row " + std::to_string(times.size() + 1) + " of " + file + " isn't a time and a rate");
+	}
+	return series(times, ratios);
+}
+
+Stimulus Stimulus::parse(std::string const& description)
+{
+	size_t const comma(description.find(','));
+	std::string const shape(description.substr(0, comma));
+	std::string const parameters(comma == std::string::npos ? "" : description.substr(comma + 1));
+	if (shape == "file") {
+		return load(parameters);
+	}
+	std::vector<double> const values(parse_parameters(description, parameters));
+	if (shape == "step" and values.size() == 3) {
+		return step(values[0], values[1], values[2]);
+	} else if (shape == "ramp" and values.size() == 3) {
+		return ramp(values[0], values[1], values[2]);
+	} else if (shape == "sine" and (values.size() == 2 or values.size() == 3)) {
+		return sinusoid(values[0], values[1], values.size() == 3 ? values[2] : 0.0);
+	}
+	throw std::runtime_error("invalid stimulus " + description + ", e.g. step,100,200,4 ramp,0,500,3 sine,1,10 or file,rates.txt");
+}
+
+double Stimulus::ratio(double time, double base_ratio) const
+{
+	switch (shape_) {
+		case StimulusShape::step :
+			return (time >= from_ and time < to_) ? ratio_ : base_ratio;
+		case StimulusShape::ramp :
+			if (time < from_) {
+				return base_ratio;
+			}
+			return time >= to_ ? ratio_ : base_ratio + (ratio_ - base_ratio) * (time - from_) / (to_ - from_);
+		case StimulusShape::sinusoid :
+			// the frequency is in Hz, the time in ms
+			return std::max(0.0, base_ratio + amplitude_ * std::sin(TWO_PI * frequency_ * time / 1000.0 + phase_));
+		case StimulusShape::series : {
+			auto const next(std::upper_bound(times_.begin(), times_.end(), time));
+			return next == times_.begin() ? base_ratio : ratios_[next - times_.begin() - 1];
+		}
+	}
+	return base_ratio;
+}
+
+ExternalDrive::ExternalDrive(double base_ratio, double mean_per_ratio, double time_step, unsigned int number_of_neurons)
+	: base_ratio_(base_ratio), mean_per_ratio_(mean_per_ratio), time_step_(time_step),
+	  groups_(number_of_neurons, 0), means_(1, base_ratio * mean_per_ratio), tables_(1, nullptr), tables_built_(0)
+{}
+
+void ExternalDrive::add(Stimulus const& stimulus, std::vector<unsigned int> const& neurons)
+{
+	if (stimuli_.size() + 1 >= std::numeric_limits<uint16_t>::max()) {
+		throw std::runtime_error("too many stimuli");
+	}
+	for (auto const neuron : neurons) {
+		if (neuron >= groups_.size()) {
+			throw std::runtime_error("the stimulated neuron " + std::to_string(neuron) + " isn't in the network");
+		}
+	}
+	stimuli_.push_back(stimulus);
+	for (auto const neuron : neurons) {
+		groups_[neuron] = stimuli_.size();
+	}
+	means_.push_back(0.0);
+	tables_.push_back(nullptr);
+}
+
+void ExternalDrive::prepare(int t, bool tables)
+{
+	double const time(t * time_step_);
+	for (size_t group(1); group < means_.size(); ++group) {
+		means_[group] = stimuli_[group - 1].ratio(time, base_ratio_) * mean_per_ratio_;
+	}
+	if (!tables) {
+		return;
+	}
+
+	double const resolution(MEAN_RESOLUTION * mean_per_ratio_);
+	for (size_t group(0); group < means_.size(); ++group) {
+		double const mean(resolution > 0.0 ? std::round(means_[group] / resolution) * resolution : means_[group]);
+		if (tables_[group] != nullptr and tables_[group]->mean() == mean) {
+			continue;
+		}
+		auto found(cache_.find(mean));
+		if (found == cache_.end()) {
+			if (cache_.size() >= MAX_CACHED_TABLES) {
+				// more rates than the cache holds, only the tables in use are kept
+				for (auto entry(cache_.begin()); entry != cache_.end();) {
+					if (std::find(tables_.begin(), tables_.end(), &entry->second) == tables_.end()) {
+						entry = cache_.erase(entry);
+					} else {
+						++entry;
+					}
+				}
+			}
+			found = cache_.emplace(mean, PoissonTable(mean)).first;
+			++tables_built_;
+		}
+		tables_[group] = &found->second;
+	}
+}
+
+long ExternalDrive::tables_built() const
+{
+	return tables_built_;
+}
+
+void add_stimuli(ExternalDrive& drive, std::string const& description, std::vector<Population> const& populations, unsigned int number_of_neurons)
+{
+	std::stringstream list(description);
+	std::string item;
+	while (std::getline(list, item, ';')) {
+		size_t const colon(item.find(':'));
+		std::vector<unsigned int> neurons;
+		if (colon == std::string::npos) {
+			for (unsigned int neuron(0); neuron < number_of_neurons; ++neuron) {
+				neurons.push_back(neuron);
+			}
+		} else {
+			std::string const group(item.substr(0, colon));
+			auto const population(std::find_if(populations.begin(), populations.end(),
+											   [&group](Population const& population) { return population.name == group; }));
+			if (population != populations.end()) {
+				for (unsigned int neuron(population->first); neuron < population->end; ++neuron) {
+					neurons.push_back(neuron);
+				}
+			} else {
+				neurons = parse_neuron_list(group, number_of_neurons);
+			}
+		}
+		drive.add(Stimulus::parse(colon == std::string::npos ? item : item.substr(colon + 1)), neurons);
+	}
+}
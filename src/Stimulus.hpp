@@ -0,0 +1,152 @@
+/*! \file Stimulus.hpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Time courses of the external rate of groups of neurons, the stimulation protocols of the simulation.
+ *  \details The rates are given like the constant one, as the ratio of the external frequency to the threshold
+ *  \details frequency. A stimulus steps, ramps or oscillates the rate around the constant one, or follows a time
+ *  \details series of a file. Each neuron follows the last stimulus covering it, the others the constant rate.
+ *  \details ExternalDrive gives the mean number of external spikes of each neuron in the current time step, and
+ *  \details the PoissonTable drawing them, cached per mean: a table is only built when a rate takes a new value.
+ *  \details The means of the tables are rounded to MEAN_RESOLUTION of the mean at the threshold rate, so that a rate
+ *  \details varying continuously, e.g. a sine wave, comes back to the tables of its previous periods.
+ */
+
+#ifndef STIMULUS_H
+#define STIMULUS_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "BackgroundNoise.hpp"
+#include "Population.hpp"
+
+/*! Number of PoissonTable an ExternalDrive keeps for the rates which come back */
+constexpr unsigned int MAX_CACHED_TABLES (4096);
+
+/*! Resolution of the rates of the tables, as a ratio to the threshold rate */
+constexpr double MEAN_RESOLUTION (1e-3);
+
+/*! The time courses of a stimulus */
+enum class StimulusShape
+{
+	/*! A rate during a time window */
+	step,
+	/*! From the constant rate to another one during a time window, then that rate */
+	ramp,
+	/*! A sine wave around the constant rate */
+	sinusoid,
+	/*! The rates of a time series, each until the next time */
+	series
+};
+
+class Stimulus
+{
+	private :
+
+		StimulusShape shape_;
+
+		/*! \brief Time window of a step or a ramp [ms], and the rate reached */
+		double from_, to_, ratio_;
+
+		/*! \brief Amplitude, frequency [Hz] and phase of a sine wave */
+		double amplitude_, frequency_, phase_;
+
+		/*! \brief Times [ms], increasing, and rates of a series */
+		std::vector<double> times_, ratios_;
+
+		explicit Stimulus(StimulusShape shape);
+
+	public :
+
+		/*! \brief Returns a rate during the time window [from, to) */
+		static Stimulus step(double from, double to, double ratio);
+
+		/*! \brief Returns a rate rising or falling linearly from the constant one at from to ratio at to, kept afterwards */
+		static Stimulus ramp(double from, double to, double ratio);
+
+		/*! \brief Returns a sine wave around the constant rate, cut at 0 */
+		static Stimulus sinusoid(double amplitude, double frequency, double phase = 0.0);
+
+		/*! \brief Returns the rates of a time series, the constant one before the first time */
+		static Stimulus series(std::vector<double> const& times, std::vector<double> const& ratios);
+
+		/*! \brief Reads a time series from a text file of rows "time [ms] rate" */
+		static Stimulus load(std::string const& file);
+
+		/*! \brief Reads a stimulus, e.g. "step,100,200,4", "ramp,0,500,3", "sine,1,10", "sine,1,10,1.57" or "file,rates.txt" */
+		static Stimulus parse(std::string const& description);
+
+		/*! \brief Returns the rate at a time
+		 * @param[in] time the time [ms]
+		 * @param[in] base_ratio the constant rate
+		 */
+		double ratio(double time, double base_ratio) const;
+};
+
+class ExternalDrive
+{
+	private :
+
+		/*! \brief Constant rate, mean number of external spikes per time step for a rate of 1, and time step [ms] */
+		double const base_ratio_;
+		double const mean_per_ratio_;
+		double const time_step_;
+
+		std::vector<Stimulus> stimuli_;
+
+		/*! \brief Stimulus followed by each neuron plus one, 0 for the constant rate */
+		std::vector<uint16_t> groups_;
+
+		/*! \brief Mean of each group in the current time step, and the table drawing it, of the rounded mean */
+		std::vector<double> means_;
+		std::vector<PoissonTable const*> tables_;
+
+		/*! \brief Tables by rounded mean */
+		std::map<double, PoissonTable> cache_;
+		long tables_built_;
+
+	public :
+
+		/*! \brief Constructor, every neuron at the constant rate
+		 * @param[in] base_ratio the constant rate, as the ratio of the external frequency to the threshold frequency
+		 * @param[in] mean_per_ratio the mean number of external spikes of a neuron per time step for a ratio of 1
+		 * @param[in] time_step the time step [ms]
+		 * @param[in] number_of_neurons the number of neurons of the network
+		 */
+		ExternalDrive(double base_ratio, double mean_per_ratio, double time_step, unsigned int number_of_neurons);
+
+		/*! \brief Adds a stimulus, followed by the given neurons from now on
+		 * @param[in] neurons the global indexes of the neurons
+		 */
+		void add(Stimulus const& stimulus, std::vector<unsigned int> const& neurons);
+
+		/*! \brief Computes the means of a time step, and looks up or builds their tables
+		 * @param[in] t the time step
+		 * @param[in] tables whether the tables are needed, i.e. the background is Poisson
+		 */
+		void prepare(int t, bool tables);
+
+		/*! \brief Returns the mean number of external spikes of a neuron in the prepared time step */
+		double mean(unsigned int neuron) const { return means_[groups_[neuron]]; }
+
+		/*! \brief Returns the table drawing the external spikes of a neuron in the prepared time step
+		 *  \details Its mean is that of the neuron rounded to MEAN_RESOLUTION times the mean per ratio.
+		 */
+		PoissonTable const& table(unsigned int neuron) const { return *tables_[groups_[neuron]]; }
+
+		/*! \brief Returns the number of tables built so far */
+		long tables_built() const;
+};
+
+/*! \brief Adds the stimuli of a description to a drive
+ *  \details The stimuli are separated by ';', each one is preceded by the neurons it drives and ':' unless it drives
+ *  \details them all, a population or a list of neurons, e.g. "excitatory:step,100,200,4;0-99:sine,1,10".
+ * @param[in] populations the populations of the network, by name
+ */
+void add_stimuli(ExternalDrive& drive, std::string const& description, std::vector<Population> const& populations, unsigned int number_of_neurons);
+
+#endif /* Stimulus_hpp */
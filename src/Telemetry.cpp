@@ -0,0 +1,232 @@
+#include "Telemetry.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char TELEMETRY_MAGIC[8] = {'N', 'E', 'U', 'R', 'O', 'T', 'E', 'L'};
+constexpr std::uint32_t TELEMETRY_VERSION (1);
+
+/*! Samples start on their own cache line after the header */
+constexpr size_t SAMPLES_OFFSET ((sizeof(TelemetryHeader) + 63) / 64 * 64);
+
+}
+
+std::string telemetry_segment(pid_t pid)
+{
+	return "/neurosim_telemetry_" + std::to_string(pid);
+}
+
+TelemetryWriter::TelemetryWriter(std::string const& name, unsigned int number_of_neurons, double time_step, std::vector<Population> const& populations,
+								 unsigned int capacity)
+	: name_(name), segment_(nullptr), size_(SAMPLES_OFFSET + capacity * sizeof(TelemetrySample)), header_(nullptr), samples_(nullptr),
+	  rate_per_spike_(1000.0 / (number_of_neurons * time_step))
+{
+	for (size_t population(0); population < std::min<size_t>(populations.size(), TELEMETRY_POPULATIONS); ++population) {
+		population_rates_per_spike_.push_back(1000.0 / ((populations[population].end - populations[population].first) * time_step));
+	}
+	if (capacity == 0) {
+		throw std::runtime_error("the telemetry ring has to hold at least one sample");
+	}
+
+	// a segment left by a killed simulation of a process with the same number is replaced
+	shm_unlink(name.c_str());
+	int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0) {
+		throw std::runtime_error("shared memory " + name + " couldn't be created: " + strerror(errno));
+	}
+	if (ftruncate(fd, size_) != 0) {
+		close(fd);
+		shm_unlink(name.c_str());
+		throw std::runtime_error("shared memory " + name + " couldn't be resized: " + strerror(errno));
+	}
+	segment_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (segment_ == MAP_FAILED) {
+		segment_ = nullptr;
+		shm_unlink(name.c_str());
+		throw std::runtime_error("shared memory " + name + " couldn't be mapped: " + strerror(errno));
+	}
+
+	header_ = new (segment_) TelemetryHeader;
+	samples_ = reinterpret_cast<TelemetrySample*>(static_cast<char*>(segment_) + SAMPLES_OFFSET);
+	assert(header_->written.is_lock_free());
+	header_->version = TELEMETRY_VERSION;
+	header_->capacity = capacity;
+	header_->neurons = number_of_neurons;
+	header_->populations = population_rates_per_spike_.size();
+	header_->time_step = time_step;
+	std::memset(header_->population_names, 0, sizeof(header_->population_names));
+	for (unsigned int population(0); population < header_->populations; ++population) {
+		populations[population].name.copy(header_->population_names[population], TELEMETRY_NAME_SIZE - 1);
+	}
+	header_->written.store(0, std::memory_order_relaxed);
+	header_->finished.store(0, std::memory_order_relaxed);
+	// the magic comes last, a monitor attaching in between finds no ring yet
+	std::atomic_thread_fence(std::memory_order_release);
+	std::memcpy(header_->magic, TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC));
+}
+
+TelemetryWriter::~TelemetryWriter()
+{
+	finish();
+	munmap(segment_, size_);
+	shm_unlink(name_.c_str());
+}
+
+void TelemetryWriter::publish(int step, unsigned int spikes, std::vector<unsigned int> const& population_spikes)
+{
+	std::uint64_t const number(header_->written.load(std::memory_order_relaxed));
+	std::uint32_t const capacity(header_->capacity);
+	auto const now(std::chrono::steady_clock::now());
+	if (number == 0) {
+		start_ = now;
+	}
+
+	TelemetrySample& sample(samples_[number % capacity]);
+	sample.step = step;
+	sample.spikes = spikes;
+	sample.time = step * header_->time_step;
+	sample.rate = spikes * rate_per_spike_;
+	sample.elapsed = std::chrono::duration<double>(now - start_).count();
+	for (size_t population(0); population < TELEMETRY_POPULATIONS; ++population) {
+		sample.population_rates[population] = population < population_rates_per_spike_.size()
+											  ? population_spikes[population] * population_rates_per_spike_[population] : 0.0;
+	}
+
+	// the older sample is still in the ring, it is at most capacity - 1 samples back
+	std::uint64_t const back(std::min<std::uint64_t>({number, TELEMETRY_RATE_WINDOW, capacity - 1u}));
+	sample.steps_per_second = 0.0;
+	if (back > 0) {
+		TelemetrySample const& older(samples_[(number - back) % capacity]);
+		if (sample.elapsed > older.elapsed) {
+			sample.steps_per_second = (step - older.step) / (sample.elapsed - older.elapsed);
+		}
+	}
+
+	header_->written.store(number + 1, std::memory_order_release);
+}
+
+void TelemetryWriter::finish()
+{
+	header_->finished.store(1, std::memory_order_release);
+}
+
+std::uint64_t TelemetryWriter::written() const
+{
+	return header_->written.load(std::memory_order_relaxed);
+}
+
+std::string const& TelemetryWriter::name() const
+{
+	return name_;
+}
+
+TelemetryReader::TelemetryReader(std::string const& name)
+	: segment_(nullptr), size_(0), header_(nullptr), samples_(nullptr)
+{
+	int fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0) {
+		throw std::runtime_error("shared memory " + name + " couldn't be opened: " + strerror(errno));
+	}
+	struct stat status;
+	if (fstat(fd, &status) != 0 or static_cast<size_t>(status.st_size) < SAMPLES_OFFSET) {
+		close(fd);
+		throw std::runtime_error("shared memory " + name + " isn't a telemetry ring");
+	}
+	size_ = status.st_size;
+	segment_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (segment_ == MAP_FAILED) {
+		segment_ = nullptr;
+		throw std::runtime_error("shared memory " + name + " couldn't be mapped: " + strerror(errno));
+	}
+
+	header_ = static_cast<TelemetryHeader const*>(segment_);
+	samples_ = reinterpret_cast<TelemetrySample const*>(static_cast<char const*>(segment_) + SAMPLES_OFFSET);
+	if (std::memcmp(header_->magic, TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC)) != 0 or header_->version != TELEMETRY_VERSION
+		or header_->populations > TELEMETRY_POPULATIONS
+		or size_ < SAMPLES_OFFSET + header_->capacity * sizeof(TelemetrySample)) {
+		munmap(segment_, size_);
+		throw std::runtime_error("shared memory " + name + " isn't a telemetry ring");
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+}
+
+TelemetryReader::~TelemetryReader()
+{
+	munmap(segment_, size_);
+}
+
+unsigned int TelemetryReader::number_of_neurons() const
+{
+	return header_->neurons;
+}
+
+double TelemetryReader::time_step() const
+{
+	return header_->time_step;
+}
+
+unsigned int TelemetryReader::capacity() const
+{
+	return header_->capacity;
+}
+
+unsigned int TelemetryReader::populations() const
+{
+	return header_->populations;
+}
+
+std::string TelemetryReader::population_name(unsigned int population) const
+{
+	assert(population < header_->populations);
+	char const* name(header_->population_names[population]);
+	return std::string(name, strnlen(name, TELEMETRY_NAME_SIZE));
+}
+
+std::uint64_t TelemetryReader::written() const
+{
+	return header_->written.load(std::memory_order_acquire);
+}
+
+bool TelemetryReader::finished() const
+{
+	return header_->finished.load(std::memory_order_acquire) != 0;
+}
+
+std::uint64_t TelemetryReader::read(std::uint64_t next, std::vector<TelemetrySample>& samples) const
+{
+	std::uint64_t const capacity(header_->capacity);
+	std::uint64_t const written(header_->written.load(std::memory_order_acquire));
+	std::uint64_t first(std::max(next, written > capacity ? written - capacity : 0));
+	if (first >= written) {
+		return written;
+	}
+
+	std::vector<TelemetrySample> copied;
+	copied.reserve(written - first);
+	for (std::uint64_t number(first); number < written; ++number) {
+		copied.push_back(samples_[number % capacity]);
+	}
+
+	// the writer may have overwritten the oldest copied samples meanwhile, and may be writing the slot of sample
+	// written_now - capacity, so only the samples after that one are sure to be intact
+	std::atomic_thread_fence(std::memory_order_acquire);
+	std::uint64_t const written_now(header_->written.load(std::memory_order_relaxed));
+	std::uint64_t const intact(written_now >= capacity ? written_now - capacity + 1 : 0);
+	auto begin(copied.begin());
+	if (intact > first) {
+		begin += std::min<std::uint64_t>(intact - first, copied.size());
+	}
+	samples.insert(samples.end(), begin, copied.end());
+	return written;
+}
@@ -0,0 +1,177 @@
+/*! \file Telemetry.hpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Live telemetry of a running simulation, published into a ring of samples in POSIX shared memory.
+ *  \details The simulation writes one sample per time step into the next slot of the ring and then advances the
+ *  \details number of samples written, without a lock, a system call or any formatting, so that publishing costs
+ *  \details the same whether a monitor is attached or not. A monitor maps the segment read-only, copies the new
+ *  \details samples and checks afterwards that the writer hasn't overwritten them in the meantime, so that it
+ *  \details never slows the simulation down and at worst misses samples if it reads less often than the ring wraps.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "Population.hpp"
+
+/*! Default number of samples of the ring, 6.5 s of simulated time at the default time step */
+constexpr unsigned int DEFAULT_TELEMETRY_CAPACITY (1 << 16);
+
+/*! Number of samples over which the steps per second are measured */
+constexpr unsigned int TELEMETRY_RATE_WINDOW (100);
+
+/*! Maximal number of populations whose rates are published, the others are left out */
+constexpr unsigned int TELEMETRY_POPULATIONS (4);
+
+/*! Maximal length of the name of a population, ended by a null character */
+constexpr unsigned int TELEMETRY_NAME_SIZE (16);
+
+/*! \brief A sample of the ring */
+struct TelemetrySample
+{
+	std::int32_t step;
+	/*! Number of spikes of the network in the time step */
+	std::uint32_t spikes;
+	/*! Simulated time [ms] */
+	double time;
+	/*! Population rate of the time step [Hz] */
+	double rate;
+	/*! Wall-clock time since the first sample [s] */
+	double elapsed;
+	/*! Time steps simulated per second of wall-clock time, over the last TELEMETRY_RATE_WINDOW samples */
+	double steps_per_second;
+	/*! Rate of each population in the time step [Hz] */
+	double population_rates[TELEMETRY_POPULATIONS];
+};
+
+/*! \brief Header at the beginning of the segment, the samples follow */
+struct TelemetryHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t capacity;
+	std::uint32_t neurons;
+	/*! Number of populations whose rates are published */
+	std::uint32_t populations;
+	/*! Time step of the simulation [ms] */
+	double time_step;
+	char population_names[TELEMETRY_POPULATIONS][TELEMETRY_NAME_SIZE];
+	/*! Number of samples written so far, the last one in slot (written - 1) % capacity */
+	std::atomic<std::uint64_t> written;
+	/*! Whether the simulation is finished, no sample follows */
+	std::atomic<std::uint32_t> finished;
+};
+
+/*! \brief Returns the name of the segment of the simulation of a process */
+std::string telemetry_segment(pid_t pid);
+
+class TelemetryWriter
+{
+	private :
+
+		std::string const name_;
+
+		/*! \brief The mapped segment and its size in bytes */
+		void* segment_;
+		size_t size_;
+
+		TelemetryHeader* header_;
+		TelemetrySample* samples_;
+
+		/*! \brief Rate of a time step per spike of the network and of each population [Hz] */
+		double const rate_per_spike_;
+		std::vector<double> population_rates_per_spike_;
+
+		std::chrono::steady_clock::time_point start_;
+
+	public :
+
+		/*! \brief Constructor, creates and maps the segment
+		 * @param[in] name the name of the segment, e.g. telemetry_segment(getpid())
+		 * @param[in] number_of_neurons the number of neurons of the network
+		 * @param[in] time_step the time step of the simulation [ms]
+		 * @param[in] populations the populations of the network, the first TELEMETRY_POPULATIONS are published
+		 * @param[in] capacity the number of samples of the ring
+		 * \throw runtime_error if the segment can't be created or the capacity is 0
+		 */
+		TelemetryWriter(std::string const& name, unsigned int number_of_neurons, double time_step, std::vector<Population> const& populations,
+						unsigned int capacity = DEFAULT_TELEMETRY_CAPACITY);
+
+		/*! \brief Destructor, marks the simulation as finished and removes the name of the segment
+		 *  \details Attached monitors keep their mapping and read the last samples.
+		 */
+		~TelemetryWriter();
+
+		TelemetryWriter(TelemetryWriter const&) = delete;
+		TelemetryWriter& operator=(TelemetryWriter const&) = delete;
+
+		/*! \brief Publishes the number of spikes of the network and of its populations in a time step */
+		void publish(int step, unsigned int spikes, std::vector<unsigned int> const& population_spikes);
+
+		/*! \brief Marks the simulation as finished */
+		void finish();
+
+		/*! \brief Returns the number of samples published */
+		std::uint64_t written() const;
+
+		std::string const& name() const;
+};
+
+class TelemetryReader
+{
+	private :
+
+		void* segment_;
+		size_t size_;
+
+		TelemetryHeader const* header_;
+		TelemetrySample const* samples_;
+
+	public :
+
+		/*! \brief Constructor, maps the segment read-only and checks its header
+		 * \throw runtime_error if the segment doesn't exist or isn't a telemetry ring
+		 */
+		TelemetryReader(std::string const& name);
+
+		/*! \brief Destructor, unmaps the segment */
+		~TelemetryReader();
+
+		TelemetryReader(TelemetryReader const&) = delete;
+		TelemetryReader& operator=(TelemetryReader const&) = delete;
+
+		unsigned int number_of_neurons() const;
+		double time_step() const;
+		unsigned int capacity() const;
+
+		/*! \brief Returns the number of populations whose rates are published */
+		unsigned int populations() const;
+
+		/*! \brief Returns the name of a population */
+		std::string population_name(unsigned int population) const;
+
+		/*! \brief Returns the number of samples written so far */
+		std::uint64_t written() const;
+
+		/*! \brief Returns whether the simulation is finished */
+		bool finished() const;
+
+		/*! \brief Appends the samples written from the sample next on, and returns the number of the sample after them
+		 *  \details The samples already overwritten by the writer are skipped, as is the oldest one of a full ring,
+		 *  \details which the writer may be overwriting, so that at most capacity - 1 samples are returned.
+		 * @param[in] next the number of the first sample wanted, e.g. what the previous call returned
+		 * @param[out] samples the samples read, in the order of the time steps
+		 */
+		std::uint64_t read(std::uint64_t next, std::vector<TelemetrySample>& samples) const;
+};
+
+#endif /* Telemetry_hpp */
@@ -0,0 +1,105 @@
+/*! \class WorkStealingDeque
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Double-ended queue of tasks of one worker, which idle workers can steal from (Chase-Lev).
+ *  \details The owner pushes and pops at the bottom, the thieves take from the top, without locks.
+ *  \details The tasks of a phase are all pushed before the phase starts, so push() and clear()
+ *  \details must not run concurrently with pop() or steal().
+ */
+
+#ifndef WORKSTEALINGDEQUE_H
+#define WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <vector>
+#include "StepBarrier.hpp"
+
+template <typename Task>
+class WorkStealingDeque
+{
+	private :
+
+		/*! \brief The tasks, those from top_ to bottom_ - 1 are still to be taken */
+		std::vector<Task> tasks_;
+
+		/*! \brief Index of the next task to steal, on a cache line of its own as the thieves write it */
+		char top_padding_[CACHE_LINE_SIZE];
+		std::atomic<long> top_;
+		char bottom_padding_[CACHE_LINE_SIZE - sizeof(std::atomic<long>)];
+
+		/*! \brief Index after the last task, only written by the owner */
+		std::atomic<long> bottom_;
+		char trailing_padding_[CACHE_LINE_SIZE - sizeof(std::atomic<long>)];
+
+	public :
+
+		WorkStealingDeque() : top_(0), bottom_(0) {}
+
+		WorkStealingDeque(WorkStealingDeque const&) = delete;
+		WorkStealingDeque& operator=(WorkStealingDeque const&) = delete;
+
+		/*! \brief Empties the deque, by the owner */
+		void clear()
+		{
+			tasks_.clear();
+			top_.store(0, std::memory_order_relaxed);
+			bottom_.store(0, std::memory_order_relaxed);
+		}
+
+		/*! \brief Adds a task at the bottom, by the owner */
+		void push(Task const& task)
+		{
+			tasks_.push_back(task);
+			bottom_.store(tasks_.size(), std::memory_order_release);
+		}
+
+		/*! \brief Takes the last task, by the owner
+		 *  \return false if the deque is empty
+		 */
+		bool pop(Task& task)
+		{
+			long const bottom(bottom_.load(std::memory_order_relaxed) - 1);
+			bottom_.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			long top(top_.load(std::memory_order_relaxed));
+
+			if (top > bottom) {
+				// empty
+				bottom_.store(bottom + 1, std::memory_order_relaxed);
+				return false;
+			}
+			task = tasks_[bottom];
+			if (top == bottom) {
+				// last task: race the thieves for it
+				bool const won(top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed));
+				bottom_.store(bottom + 1, std::memory_order_relaxed);
+				return won;
+			}
+			return true;
+		}
+
+		/*! \brief Takes the first task, by any other worker
+		 *  \return false if the deque is empty
+		 */
+		bool steal(Task& task)
+		{
+			while (true) {
+				long top(top_.load(std::memory_order_acquire));
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				long const bottom(bottom_.load(std::memory_order_acquire));
+				if (top >= bottom) {
+					return false;
+				}
+				task = tasks_[top];
+				if (top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+					return true;
+				}
+				// another worker took it first, try the next one
+			}
+		}
+};
+
+#endif /* WorkStealingDeque_hpp */
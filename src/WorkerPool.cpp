@@ -0,0 +1,101 @@
+#include "WorkerPool.hpp"
+#include "Numa.hpp"
+#include <cassert>
+
+WorkerPool::WorkerPool(unsigned int size, std::vector<int> const& cpus)
+	: cpus_(size, -1), job_barrier_(size), phase_barrier_(size), job_(nullptr), stopping_(false)
+{
+	assert(size > 0);
+
+	if (!cpus.empty()) {
+		for (unsigned int worker(0); worker < size; ++worker) {
+			cpus_[worker] = cpus[worker % cpus.size()];
+		}
+		if (!pin_current_thread(cpus_[0])) {
+			cpus_[0] = -1;
+		}
+	}
+
+	for (unsigned int worker(0); worker < size; ++worker) {
+		tasks_.push_back(std::unique_ptr<WorkStealingDeque<WorkerTask> >(new WorkStealingDeque<WorkerTask>));
+	}
+
+	for (unsigned int worker(1); worker < size; ++worker) {
+		threads_.push_back(std::thread(&WorkerPool::work, this, worker));
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	stopping_ = true;
+	job_barrier_.wait();
+	for (auto& thread : threads_) {
+		thread.join();
+	}
+}
+
+void WorkerPool::work(unsigned int worker)
+{
+	if (cpus_[worker] >= 0 and !pin_current_thread(cpus_[worker])) {
+		cpus_[worker] = -1;
+	}
+
+	while (true) {
+		// wait for a job
+		job_barrier_.wait();
+		if (stopping_) {
+			return;
+		}
+		(*job_)(worker);
+		// tell run() we are done
+		job_barrier_.wait();
+	}
+}
+
+unsigned int WorkerPool::size() const
+{
+	return threads_.size() + 1;
+}
+
+int WorkerPool::cpu_of(unsigned int worker) const
+{
+	return cpus_[worker];
+}
+
+void WorkerPool::run(std::function<void(unsigned int)> const& job)
+{
+	job_ = &job;
+	job_barrier_.wait();
+	job(0);
+	job_barrier_.wait();
+	job_ = nullptr;
+}
+
+void WorkerPool::synchronize()
+{
+	phase_barrier_.wait();
+}
+
+void WorkerPool::push_task(unsigned int worker, WorkerTask const& task)
+{
+	tasks_[worker]->push(task);
+}
+
+bool WorkerPool::next_task(unsigned int worker, WorkerTask& task)
+{
+	if (tasks_[worker]->pop(task)) {
+		return true;
+	}
+	// no task is added during a phase: once every deque was seen empty, the phase's work is done
+	for (unsigned int offset(1); offset < tasks_.size(); ++offset) {
+		if (tasks_[(worker + offset) % tasks_.size()]->steal(task)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorkerPool::clear_tasks(unsigned int worker)
+{
+	tasks_[worker]->clear();
+}
@@ -0,0 +1,99 @@
+/*! \class WorkerPool
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Fixed set of worker threads running the phases of a time step together.
+ *  \details The calling thread is worker 0, so a pool of n workers starts n - 1 threads.
+ *  \details Every worker can be pinned to a CPU, so that the memory it first touches stays on its NUMA node.
+ *  \details Work whose cost isn't known in advance is split into tasks: each worker pushes tasks onto its own
+ *  \details deque, then every worker runs its own tasks and steals from the others once it runs out.
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <vector>
+#include <thread>
+#include <functional>
+#include <memory>
+#include "StepBarrier.hpp"
+#include "WorkStealingDeque.hpp"
+
+/*! \brief Task of the work-stealing scheduler: the items begin to end - 1 of a list owned by a worker */
+struct WorkerTask
+{
+	unsigned int owner;
+	unsigned int begin;
+	unsigned int end;
+};
+
+class WorkerPool
+{
+	private :
+
+		/*! \brief The threads of workers 1 to size() - 1 */
+		std::vector<std::thread> threads_;
+
+		/*! \brief CPU of each worker, -1 if the worker is not pinned */
+		std::vector<int> cpus_;
+
+		/*! \brief Releases the workers at the beginning of a job and gathers them at its end */
+		StepBarrier job_barrier_;
+
+		/*! \brief Synchronizes the workers between the phases of a job */
+		StepBarrier phase_barrier_;
+
+		/*! \brief The job being run, called with the worker number */
+		std::function<void(unsigned int)> const* job_;
+
+		/*! \brief Tasks of each worker */
+		std::vector<std::unique_ptr<WorkStealingDeque<WorkerTask> > > tasks_;
+
+		/*! \brief Set to make the threads terminate */
+		bool stopping_;
+
+		/*! \brief Main loop of the threads of the pool */
+		void work(unsigned int worker);
+
+	public :
+
+		/*! \brief Constructor
+		 * @param[in] size the number of workers, the calling thread included
+		 * @param[in] cpus the CPUs to pin the workers to, worker w runs on cpus[w % cpus.size()], none if empty
+		 */
+		WorkerPool(unsigned int size, std::vector<int> const& cpus);
+
+		/*! \brief Destructor, terminates the threads */
+		~WorkerPool();
+
+		/*! \brief Returns the number of workers */
+		unsigned int size() const;
+
+		/*! \brief Returns the CPU worker is pinned to, -1 if it isn't */
+		int cpu_of(unsigned int worker) const;
+
+		/*! \brief Runs job(w) on every worker w and returns once all of them are done
+		 *  \details The calling thread runs job(0).
+		 */
+		void run(std::function<void(unsigned int)> const& job);
+
+		/*! \brief Waits until every worker of the running job has reached this point */
+		void synchronize();
+
+		/*! \brief Adds a task to the deque of a worker, by that worker
+		 *  \details The tasks of a phase have to be pushed before the synchronize() starting the phase.
+		 */
+		void push_task(unsigned int worker, WorkerTask const& task);
+
+		/*! \brief Finds the next task for a worker: its own last one, or else the first one of another worker
+		 *  \return false once no worker has any task left
+		 */
+		bool next_task(unsigned int worker, WorkerTask& task);
+
+		/*! \brief Empties the deque of a worker, by that worker, once no task is left anywhere */
+		void clear_tasks(unsigned int worker);
+};
+
+#endif /* WorkerPool_hpp */
@@ -7,6 +7,7 @@
 #include <chrono>
 #include <iomanip>
 #include <chrono>
+#include <cmath>
 
 #define RED "\033[1m\033[31m"
 #define ORANGE "\033[38;5;214m"
@@ -21,31 +22,69 @@
 // Units: ms
 const int MAX_TIME(2000);
 const double TIME_STEP(0.1);
+// left out of the rate compared to the mean field
+const int BURN_IN(200);
+
+#define STATISTICS_FILE "statistics.txt"
+#define SPECTRUM_FILE "spectrum.txt"
+
+// exit codes of runs stopped early, see ActivityStatus
+const int QUIESCENT_EXIT(2);
+const int SATURATED_EXIT(3);
+const int STATIONARY_EXIT(4);
 
 int main (int argc, char** argv) {
 
 	auto start = std::chrono::system_clock::now();
-	if(initialize_cortex(argc, argv, TIME_STEP, MAX_TIME)) {
+	double time_step(TIME_STEP);
+	double predicted_rate(-1);
+	int exit_code(0);
+	if(initialize_cortex(argc, argv, time_step, MAX_TIME, predicted_rate)) {
 		Cortex::initialize_neurons();
+
+		// in a distributed simulation, only rank 0 talks to the terminal
+		bool const verbose(Cortex::is_root());
 	
 		auto after_init = std::chrono::system_clock::now();
 		auto elapsed =  std::chrono::duration_cast<std::chrono::seconds>(after_init - start);
-		std::cout << "Initialization time: " << elapsed.count() << " seconds" << std::endl;
+		if (verbose) {
+			std::cout << "Initialization time: " << elapsed.count() << " seconds" << std::endl;
+		}
 	
 		// initializing of the parameters and the connections between neurons */
 		try {
 		
 			int progress(0);
-			std::cout << "Simulating : " << std::endl;
-			std::cout << "[  0%] [--------------------]" << std::flush;
+			// the telemetry shows the progress, redrawing a bar in the terminal would only slow the run down
+			bool const progress_bar(verbose and Cortex::get_telemetry() == nullptr);
+			if (progress_bar) {
+				std::cout << "Simulating : " << std::endl;
+				std::cout << "[  0%] [--------------------]" << std::flush;
+			} else if (verbose) {
+				std::cout << "Simulating, see TelemetryMonitor for the progress..." << std::flush;
+			}
 	
-			for (int t(0); t < (MAX_TIME / TIME_STEP); ++t) {
+			int const steps(std::lround(MAX_TIME / time_step));
+			int const burn_in_steps(std::lround(BURN_IN / time_step));
+			long burn_in_spikes(0);
+			int simulated_steps(steps);
+			for (int t(0); t < steps; ++t) {
 
 				Cortex::update(t);
+				if (t + 1 == burn_in_steps) {
+					burn_in_spikes = Cortex::get_total_spike_sum();
+				}
+				if (Cortex::get_activity_status() != ActivityStatus::running) {
+					if (verbose) {
+						std::cout << " STOPPED" << RESET << std::endl;
+					}
+					simulated_steps = t + 1;
+					break;
+				}
 
 				//loading bar animation
-				if (progress != ((t * 100)/(MAX_TIME / TIME_STEP - 1))) {
-					progress = (t * 100)/(MAX_TIME / TIME_STEP -1 );
+				if (progress_bar and progress != ((t * 100)/(steps - 1))) {
+					progress = (t * 100)/(steps - 1);
 					std::cout << ESCAPE << std::flush;
 					std::cout << SPACE << std::flush;
 					std::cout << ESCAPE << std::flush;
@@ -82,23 +121,116 @@ int main (int argc, char** argv) {
 					std::cout << ']' << std::flush;
 				}
 
-				if (progress == 100){
+				if (progress_bar and progress == 100){
 					std::cout << " DONE" << RESET << std::endl;
 				}
 			}
+			if (verbose and !progress_bar and simulated_steps == steps) {
+				std::cout << " DONE" << std::endl;
+			}
+
+			Cortex::finish();
+
+			ActivityMonitor const* monitor(Cortex::get_monitor());
+			if (verbose and monitor != nullptr and monitor->status() != ActivityStatus::running) {
+				std::cout << "Stopped after " << monitor->time() << " ms: " << BOLD << to_string(monitor->status()) << RESET;
+				if (monitor->status() == ActivityStatus::stationary) {
+					std::cout << ", mean rate " << monitor->mean_rate() << " Hz";
+				}
+				std::cout << std::endl;
+			}
+
+			SpikeStatistics const* statistics(Cortex::get_statistics());
+			if (verbose and statistics != nullptr) {
+				SpikeSummary const summary(statistics->summarize());
+				std::cout << "Statistics of the " << summary.neurons << " neurons" << (Cortex::is_root() and summary.neurons < Cortex::get_number_of_neurons() ? " of rank 0" : "")
+						  << " (" << STATISTICS_FILE << "):" << std::endl;
+				std::cout << "     rate " << BOLD << summary.mean_rate << " Hz" << RESET << " +- " << summary.rate_deviation
+						  << " Hz, " << 100 * summary.silent_fraction << "% silent" << std::endl;
+				std::cout << "     CV " << BOLD << summary.mean_cv << RESET << ", Fano factor " << BOLD << summary.mean_fano << RESET
+						  << ", synchrony " << BOLD << summary.synchrony << RESET << std::endl;
+				std::cout << "     population rate " << summary.population_rate << " Hz, variance " << summary.population_rate_variance << " Hz^2" << std::endl;
+				statistics->write(STATISTICS_FILE);
+			}
+
+			PopulationSpectrum const* spectrum(Cortex::get_spectrum());
+			if (verbose and spectrum != nullptr) {
+				SpectrumSummary const summary(spectrum->summarize());
+				std::cout << "Spectrum of the population rate (" << summary.segments << " segments, " << summary.resolution
+						  << " Hz resolution, " << SPECTRUM_FILE << "):" << std::endl;
+				std::cout << "     peak at " << BOLD << summary.peak_frequency << " Hz" << RESET << ", " << summary.peak_power
+						  << " Hz^2/Hz, " << BOLD << summary.peak_power / summary.poisson_power << RESET
+						  << " times the spectrum of independent Poisson neurons" << std::endl;
+				std::cout << "     variance of the population rate " << summary.total_power << " Hz^2" << std::endl;
+				spectrum->write(SPECTRUM_FILE);
+			}
+
+			SpikeStoreWriter const* spike_store(Cortex::get_spike_store());
+			if (verbose and spike_store != nullptr) {
+				std::cout << "Spike store: " << spike_store->spikes() << " spikes in " << spike_store->chunks() << " chunks ("
+						  << spike_store->file_name() << ")" << std::endl;
+			}
+
+			NpyRecording const* npy_recording(Cortex::get_npy_recording());
+			if (verbose and npy_recording != nullptr) {
+				std::cout << "NumPy arrays: " << npy_recording->sums().rows() << " sums (" << npy_recording->sums().file_name() << "), "
+						  << npy_recording->observed().rows() << " rows of observed spikes (" << npy_recording->observed().file_name() << "), "
+						  << npy_recording->raster().rows() << " spikes (" << npy_recording->raster().file_name() << ")" << std::endl;
+			}
+
+			Multimeter const* multimeter(Cortex::get_multimeter());
+			if (verbose and multimeter != nullptr) {
+				std::cout << "Multimeter: " << multimeter->rows() << " samples of " << multimeter->neurons().size() << " neurons ("
+						  << multimeter->file_name() << ")" << std::endl;
+			}
+
+			double const simulated_time(simulated_steps * time_step);
+			if (verbose and Cortex::writes_population_sums()) {
+				std::cout << "Population rates:";
+				std::vector<Population> const& populations(Cortex::get_populations());
+				for (size_t population(0); population < populations.size(); ++population) {
+					unsigned int const size(populations[population].end - populations[population].first);
+					std::cout << (population > 0 ? ", " : " ") << populations[population].name << " " << BOLD
+							  << Cortex::get_total_population_sums()[population] * 1000.0 / (size * simulated_time) << " Hz" << RESET;
+				}
+				std::cout << std::endl;
+			}
+			if (verbose and predicted_rate >= 0 and simulated_time > BURN_IN) {
+				double const simulated_rate((Cortex::get_total_spike_sum() - burn_in_spikes) * 1000.0
+											/ (Cortex::get_number_of_neurons() * (simulated_time - BURN_IN)));
+				std::cout << "Rate after " << BURN_IN << " ms: " << BOLD << simulated_rate << " Hz" << RESET
+						  << ", predicted " << predicted_rate << " Hz (" << std::showpos
+						  << std::lround(100 * (simulated_rate - predicted_rate) / predicted_rate) << std::noshowpos << "%)" << std::endl;
+			}
 		
 			auto end = std::chrono::system_clock::now();
 			auto elapsed =  std::chrono::duration_cast<std::chrono::seconds>(end - start);
-			std::cout << "Total execution time: " << elapsed.count() << " seconds" << std::endl;
+			if (verbose) {
+				std::cout << "Total execution time: " << elapsed.count() << " seconds" << std::endl;
+			}
 		
 			} 
 			catch (std::runtime_error error) {
 				std::cerr << error.what();
+				Cortex::abort_ranks();
 				Cortex::reset();
 				return -1;
 			}
 	
+			switch (Cortex::get_activity_status()) {
+				case ActivityStatus::quiescent :
+					exit_code = QUIESCENT_EXIT;
+					break;
+				case ActivityStatus::saturated :
+					exit_code = SATURATED_EXIT;
+					break;
+				case ActivityStatus::stationary :
+					exit_code = STATIONARY_EXIT;
+					break;
+				default :
+					break;
+			}
 			Cortex::reset();
 		}
-	return 0;
+	return exit_code;
 }
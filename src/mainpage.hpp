@@ -35,10 +35,86 @@ Flags, to be followed by their desired value:
 * "-f": the ratio vext/vthr, which will be used to calculate the external input frequency. Default: 5
 * "-g": the relative amplitude g of inhibitory neurons (versus excitatory). Default: 2
 * "-j": the excitatory amplitude Je (in mVolt), the amplitude of a spike from an inhibitory neuron. Default: 0.1
+* "-n": the number of processes the network is distributed over. Default: 1
+* "--Transport": how the processes exchange their spikes, "shm" (shared memory) or "socket" (TCP on the loopback interface). Default: shm
+* "--Port": the first TCP port used by the socket transport, process r listens on Port + r. Default: 47000
+* "-t": the number of threads simulating the neurons of each process. Default: 1
+* "--Cpus": the CPUs the threads are pinned to, e.g. "0-7,16-23"; thread i runs on the i-th CPU of the list. Default: not pinned
+* "--Deterministic": 1 to make the results independent of the number of threads. Default: 0
+* "-s": the seed of the random numbers. Default: based on the time, 0 with "--Deterministic 1"
+* "--Time_step": the time step of the simulation in ms. The refractory period (2 ms) and the transmission delay (1.5 ms) have to be multiples of it, and the delay has to last at least two steps, e.g. 0.05, 0.1, 0.25 or 0.5. With "--Precise 1" they only have to last one step, e.g. 1. Default: 0.1
+* "--Synapse": "delta" to add the amplitude of a spike to the potential at once, "exp" for exponentially decaying synaptic currents. Default: delta
+* "--Tau_syn": the time constant of the exponential synaptic current in ms. Default: 0.5
+* "--Background": "poisson" for the exact Poisson background input, "gaussian" for its diffusion approximation, "shared" for a Gaussian input partly common to all neurons. Default: poisson
+* "--Shared_fraction": the fraction of the variance of the "shared" background input common to all neurons, between 0 and 1. Default: 0.1
+* "--Predict": 1 to print the stationary states predicted by the mean field within milliseconds, without simulating unless "-r 1" is also given, in which case the simulated rate is compared to the prediction at the end. Default: 0
+* "--Early_stop": 1 to stop the simulation once its activity died out, saturated or its mean rate converged. Default: 0
+* "--Rate_tolerance": the relative standard error of the mean rate at which it has converged. Default: 0.02
+* "--Statistics": 1 to accumulate the statistics of the spike trains during the run and write their summary into statistics.txt. Default: 0
+* "--Fano_window": the length of the windows of the Fano factor in ms. Default: 100
+* "--Synchrony_bin": the length of the bins of the population synchrony in ms. Default: 1
+* "--Write_spikes": 0 not to write spikes.txt and sum_spikes.txt. Default: 1
+* "--Spectrum": 1 to estimate the power spectrum of the population rate during the run and write it into spectrum.txt. Default: 0
+* "--Spectrum_segment": the number of time steps of the segments the spectrum is averaged over, a power of two. Default: 2048
+* "--Spike_store": 1 to write the spikes of all neurons into the binary, time-indexed spikes.bin, in a simulation which isn't distributed. Default: 0
+* "--Store_chunk": the time span of the chunks of spikes.bin in ms. Default: 100
+* "--Npy": 1 to also write the spike sums, the spikes of the observed neurons and the spikes of all neurons into the NumPy arrays sum_spikes.npy, spikes.npy and raster.npy, in a simulation which isn't distributed. Default: 0
+* "--Record_from", "--Record_to": the time window in ms of all recordings. Default: the whole simulation
+* "--Record_every": records the spike sums and the observed neurons every k-th time step of the window. Default: 1
+* "--Record_bin": records the spike sums and the observed neurons in bins of b time steps, the sum of the spikes of the bin and whether the neuron spiked in it. Default: 1
+* "--Record_neurons": the neurons to observe instead of 50 random ones, which are also the only ones of spikes.bin and raster.npy, e.g. "0-99,12000". Default: none
+* "--Record_fraction": the fraction of the neurons, drawn with the seed, whose spikes are written into spikes.bin and raster.npy. Default: 1
+* "--Multimeter": the neurons, simulated by rank 0, whose membrane potential and input are sampled into multimeter.npy, e.g. "0-99". Default: none
+* "--Multimeter_interval": the interval between two samples of the multimeter, a multiple of the time step. Default: 1 ms
+* "--Population_sums": 1 to write the spikes of the inhibitory and of the excitatory neurons after the spike sum of each time step, as more columns of sum_spikes.txt and sum_spikes.npy. Default: 0
+* "--Telemetry": publishes the number of spikes, the population rate and the steps per second of each time step into a shared memory ring, which TelemetryMonitor reads while the simulation runs. Default: 0
+* "--Stimulus": time courses of the external rate, as ratios like "-f", each after the population ("inhibitory", "excitatory") or the neurons (e.g. "0-99") it drives and ":", or for all neurons, separated by ";": "step,from,to,ratio" during a time window [ms], "ramp,from,to,ratio" from the constant rate to the ratio then kept, "sine,amplitude,frequency[,phase]" around the constant rate [Hz], or "file,rates.txt", rows "time ratio" each kept until the next time, e.g. "excitatory:step,100,200,4;0-99:sine,1,10". Can't be used with "--Early_stop", as a stimulated rate isn't meant to be stationary. Default: constant
+* "--Model": "lif" for leaky integrate-and-fire neurons, "adaptive" to add a spike-triggered adaptation current, with delta synapses only. Default: lif
+* "--Precise": 1 to time the refractory period and the arrival of the spikes from the threshold crossing interpolated within the time step, for coarser time steps, with delta synapses only. Default: 0
 * "-h": get further information, e.g. default values of the parameters
 
 Each parameter can take positive floating point or integer values. If you provide an unacceptable value, the program will terminate and you will have to try again with another value.
 
+When the network is distributed, each process simulates a contiguous block of neurons and only keeps the connections towards its own neurons. The processes exchange the spikes that have targets on the other processes every 1.4 ms (the transmission delay minus one time step, or minus two with "--Precise 1", so that the delay has to last at least three steps), and only the first process writes the output files. The 50 observed neurons are then chosen among the neurons of the first process.
+
+When several threads are used, each thread owns a contiguous range of neurons: it allocates their state and connections itself, so that on machines with several NUMA nodes they are placed in the memory next to the core the thread runs on. The spikes are delivered in two passes: a thread sorts the inputs of the spikes it delivers into one bucket per thread owning their targets, then each thread adds the inputs of its buckets to its own neurons, so that no thread writes to the neurons of another or scans the whole network. Pin the threads with "--Cpus" to keep them there; the placement of each thread's data is printed at startup. Each thread allocates its buckets, which are placed on its node.
+
+With "--Deterministic 1", two runs with the same seed give the same spikes whatever the number of threads. The background noise of a neuron at a time step is drawn from a counter-based generator (Philox) keyed by the seed, the neuron and the time step rather than from one generator per thread, and the inputs are summed as 64 bit fixed-point numbers, so that the order in which the threads deliver the spikes doesn't matter. The observed neurons are chosen with the seed too.
+
+With "--Synapse exp", a spike of amplitude J starts a synaptic current J/tau_syn which decays exponentially and charges the membrane, so that the potential rises smoothly instead of jumping by J. The current and the potential are integrated exactly over each time step with precomputed propagators (Rotter and Diesmann 1999), so the result doesn't depend on the time step, which can be raised to 0.5 ms to simulate five times fewer steps.
+
+With "--Precise 1", a neuron which crosses the threshold during a time step interpolates the potential linearly over the step to find when it crossed, and its spike carries this offset from the time grid through the transmission delay, also to the other processes. The spike is still recorded at the step after the crossing, where the neuron is reset, but the refractory period ends 2 ms after the crossing itself, and the neuron integrates the rest of that step. The spike arrives 1.5 ms after the crossing, so it is delivered into the step it arrives in, with its amplitude scaled by the decay of the potential from its arrival to the end of the step. In the synchronous regime of "-g 3 -s 3", 0.5 ms steps then give 328 Hz and a synchrony of 0.48 against 329 Hz and 0.49 with 0.1 ms steps, and 329 Hz with 0.05 ms steps, where the grid gives 249 Hz, 309 Hz and 319 Hz: on the grid, the intervals between the spikes are whole steps. With 1 ms steps, the rate stays within 2% but the fast oscillation, whose period is a few steps, is lost. Without "--Precise", the processes exchange a spike as two words, its neuron and its time step, instead of three.
+
+With "--Model adaptive", each spike of a neuron increases an adaptation current by 0.02 mV/ms, which decays with a time constant of 100 ms and lowers the potential, so that a neuron firing often slows down. The models are templates resolved at compile time: the simulation chooses the model once per time step and runs a loop specialized for it, and at the default time step and time constants the propagators are compile-time constants.
+
+The background input of a neuron is J times a Poisson number of mean lambda per time step. With "--Background gaussian", it is replaced by a Gaussian of the same mean J lambda and variance J^2 lambda, drawn in bulk by the Box-Muller transform. Both inputs have the same mean and variance, but with lambda about 2 per time step the Poisson numbers are skewed, which the Gaussian isn't: a neuron alone firing at about 100 Hz under the default input keeps its rate and its CV within 1%, while at the threshold input, where it fires at about 16 Hz driven by the fluctuations, its rate differs by up to 3% and its CV by 3% (see BackgroundNoise_Test.diffusion_error). The whole simulation runs about a quarter faster. With "--Background shared", the fraction given by "--Shared_fraction" of the variance comes from a number common to all neurons at each time step, which correlates their inputs.
+
+"--Predict 1" solves the mean-field equations of the network (Brunel 2000): in the diffusion approximation, the rate of the neurons is given by Siegert's formula as a function of the mean and the fluctuations of their input, which depend on the rate itself. The self-consistent rates, with their CV and whether the mean input is above the threshold, are found within tens of milliseconds, which is enough to prune a sweep over g and vext/vthr. The analysis only covers the asynchronous states: the synchronous regimes are oscillatory instabilities of these states which it doesn't predict. It models delta-synapse LIF neurons under a constant Poisson background: with "--Synapse exp", "--Model adaptive", a Gaussian background or "--Stimulus", the states are labelled approximate with what they ignore, and the simulated rate isn't compared to them.
+
+With "--Early_stop 1", the number of spikes of the network is watched in windows of 50 ms. After 100 ms, a window without spikes stops the run as quiescent, and a window in which the neurons fire at half the inverse of the refractory period or more stops it as saturated. After a burn-in of 200 ms, the run stops as stationary once the standard error of the mean rate of the windows is below the rate tolerance, and the means of the first and of the second half of the windows agree within two standard errors of their difference, so that a rate which is still drifting doesn't pass for converged. The program then exits with 2 (quiescent), 3 (saturated) or 4 (stationary), and with 0 if it simulated the whole time, so that a sweep script can tell the regimes apart. The default network is stationary after 400 to 450 ms.
+
+With "--Statistics 1", the simulation accumulates for each neuron its number of spikes, the mean and the variance of its interspike intervals and its spike counts in windows of "--Fano_window" ms, and the spike count of the population in bins of "--Synchrony_bin" ms. At the end it prints, and writes into statistics.txt with one "name value" line per quantity, the mean and the spread of the rates, the fraction of silent neurons, the mean CV of the intervals, the mean Fano factor, the mean and variance of the population rate, and the synchrony chi of Golomb (2007), which is about 1/sqrt(N) for independent neurons and 1 for synchronous ones. Together with "--Write_spikes 0", most runs don't need the text files nor the MATLAB scripts. In a distributed simulation, the statistics cover the neurons of rank 0.
+
+With "--Spectrum 1", the simulation estimates the power spectrum of the population rate while it runs (Welch 1967): the rate is cut into segments of "--Spectrum_segment" steps overlapping by half, each segment is detrended, multiplied by a Hann window and transformed by an FFT, and the periodograms are averaged, so that only one segment and the spectrum stay in memory however long the run. At the end it prints the frequency of the peak, its power relative to the flat spectrum 2ν/N of N independent Poisson neurons firing at the mean rate ν, and the variance of the population rate, and writes the spectrum into spectrum.txt with one "frequency power" line per frequency. With the default time step and segments, the peak of the asynchronous irregular state (g=5, f=2) is at about 120 Hz and 700 times the Poisson spectrum, that of the slow synchronous irregular state (g=4.5, f=0.9) at 20 Hz and 2600 times, that of the fast one (g=6, f=4) at 170 Hz and 8700 times, and that of the synchronous regular state (g=3, f=2) at 625 Hz and 500000 times. The spectrum covers the whole network, also in a distributed simulation.
+
+With "--Spike_store 1", the simulation writes every spike, not only those of the 50 observed neurons, as a (neuron, time step) pair into spikes.bin. The spikes are grouped into chunks of "--Store_chunk" ms, and the file ends with an index of the chunks, so that a reader maps the file into memory and only touches the chunks of the time range it is asked for: reading 100 ms of the 920000 spikes of a default run takes milliseconds, however long the run. The SpikeStoreReader class of src/SpikeStore.hpp returns the spikes of a range [t0, t1) for all neurons or a subset of them, and the SpikeRange tool prints them as text. As each process only knows the spikes of its own neurons, "--Spike_store" can't be used with "--Ranks".
+
+With "--Npy 1", the recordings are also written as NumPy arrays, which numpy.load(file, mmap_mode='r') maps into memory without parsing: sum_spikes.npy holds the spike sums as uint32, one per time step, spikes.npy the spikes of the observed neurons as uint8, one row of bits per time step packed like numpy.packbits (numpy.unpackbits(spikes, axis=1)[:, :50] gives the columns of spikes.txt), and raster.npy the spikes of all neurons as int32, one (neuron, time step) row per spike. The headers are padded to 128 bytes and rewritten with the number of rows every 64 KB, so the arrays of a running simulation can already be read. With "--Write_spikes 0", the text files aren't written at all. Like sum_spikes.txt and spikes.txt, sum_spikes.npy and spikes.npy count a spike when it is sent, one transmission delay minus a time step after the neuron reached the threshold, whereas raster.npy and spikes.bin hold the time step at which it reached the threshold. As each process only knows the spikes of its own neurons, "--Npy" can't be used with "--Ranks".
+
+The recording options make the size of the files and the time spent writing them scale with what is analyzed: e.g. "--Record_from 500 --Record_to 600" writes 1000 rows into sum_spikes.txt and spikes.txt instead of 20000, and "--Record_bin 10" writes one row per ms. The time steps are either sampled every k-th one or binned, not both, and an incomplete last bin isn't written. The window and the neurons also apply to the spikes of spikes.bin and raster.npy, which aren't subsampled.
+
+The multimeter writes one float32 row per sample into multimeter.npy: the time in ms, then the potentials of the sampled neurons in increasing order, then their inputs of the time step, both in mV. The potential is sampled after the update, so that it is above the threshold in the step a neuron crosses it. The rows are buffered and written in batches, and the file is read without parsing, e.g. numpy.load("multimeter.npy", mmap_mode="r")[:, 1:101] for the potentials of 100 neurons.
+
+The telemetry costs one write into shared memory per time step: the simulation neither formats text nor waits for the monitor, which may be attached or not, and reads the ring at its own pace. The segment is named after the process of the simulation, e.g. /neurosim_telemetry_1234, printed with the parameters, and removed at the end of the run. In a distributed simulation the first process only knows the spikes of the whole network once the processes have exchanged them, so it publishes the time steps of an exchange epoch together, every 1.4 ms of simulated time, rather than one by one. With the telemetry, the progress bar isn't drawn in the terminal.
+
+The spikes of the inhibitory neurons, which are the first fifth of the neurons, and of the excitatory ones are counted apart during the update, at no cost: a thread counts the spikes of a population in a local variable, added once to the sums of the time step. With "--Population_sums 1", a row of sum_spikes.txt is "sum inhibitory excitatory", binned and subsampled like the sum, sum_spikes.npy has three columns, the telemetry publishes the rates of both populations, and the rates of the run are printed at the end, so that the balance of excitation and inhibition is analyzed without a raster.
+
+The simulation is also built as a library, libneurosim.a and libneurosim.so, for programs which drive it in-process instead of running NeuronSimulation and parsing its files. Its C interface, src/neurosim.h, creates a simulation, configures it with the flags of NeuronSimulation (e.g. {"-t", "4", "--Deterministic", "1"}, "-r 1" implied, no text file written unless "--Write_spikes 1"), advances it with neurosim_step() or neurosim_run_until(), and hands out the neurons which spiked in the last time step with neurosim_get_spikes(), a pointer into the simulation valid until the next step, without a copy. The network being static, a process runs one simulation at a time, in a single process.
+
+C++ programs linking the library register subscribers, src/SpikeSubscriber.hpp, with Cortex::add_spike_subscriber(): after each time step, or each batch of time steps such as an exchange epoch, a subscriber receives a read-only span of the neurons of the process which spiked, step by step. A span of a single step points into the buffer of the simulation, without a copy. Wrapped into an AsyncSpikeSubscriber, a slow consumer like an online analysis or a closed-loop controller runs on a thread of its own, fed through a bounded queue of recycled buffers, and the simulation only waits when it falls behind. Nothing is collected while no subscriber is registered.
+
+With "--Stimulus", the external rate of a neuron follows the last stimulus covering it, the other neurons keep the constant rate of "-f". The means of the time step are computed once per step, before the threads update their neurons. The Poisson numbers are drawn by inverting uniform numbers, drawn in bulk, with a table of the cumulative distribution of each rate and a guide table, about one comparison per number whatever the rate. The tables are cached by mean, rounded to a thousandth of the mean at the threshold rate, so a table is only built when a rate takes a new value, e.g. twice for a step, and a ramp or a sine wave builds at most a thousand tables per unit of ratio it spans, a sine wave all of them in its first period. The cost of a time step then doesn't depend on the protocol. The Gaussian models of "--Background" follow the rates as well.
+
 #### EXAMPLE EXECUTIONS
 
 ##### Example execution 1:
@@ -89,6 +165,23 @@ Place yourself in the build directory and execute the following commands in the
 		
 This generates an executable, NeuronSimulation_test, which can be launched for further information. Make tests indicates whether the test passed.
 
+### BENCHMARKS
+
+Building also generates benchmark executables in the build directory:
+
+* BarrierBenchmark [max_threads] [rounds]: the cost of one synchronization of the threads between two phases of a time step, versus the number of threads, for the barrier of the simulation and for a mutex/condition variable barrier.
+
+### TOOLS
+
+* ValidateEngines: runs a reference engine and a candidate engine on the same network with the same seed, and checks that the candidate simulates the same network. The engines are "sequential" (the original code), "parallel:N" and "deterministic:N" with N threads, chosen with "--Reference" (default: deterministic:1) and "--Candidate" (default: deterministic:2). Without "--Mode", engines which can be bitwise identical, two deterministic ones or two sequential ones, are compared exactly, the others statistically.
+  * "--Mode exact" compares a hash of the state of every neuron and the number of spikes after each time step, and prints the first step and neuron where the engines diverge, e.g. "--Reference deterministic:1 --Candidate deterministic:4". It is rejected for the other pairs, which draw different noise and diverge at the first step.
+  * "--Mode statistical" is for engines which aren't bitwise identical, e.g. "--Candidate parallel:4": it compares the mean rate and the standard deviation of the number of spikes per step within "--Tolerance" (default: 0.1), and the distributions of the rates of the single neurons with a Kolmogorov-Smirnov test, leaving out the first "--Burn_in" steps (default: 1000).
+  * "--Steps" sets the number of time steps (default: 5000) and "-s" the seed. The exit status is 0 if the engines are equivalent and 1 otherwise.
+* SpikeRange: prints the spikes of spikes.bin (or "--File") from "--From" to "--To" ms, for all neurons or the comma-separated "--Neurons", one "time neuron" line per spike, reading only the chunks of the range. From MATLAB: [status, text] = system('./SpikeRange --From 500 --To 600'); data = str2num(text);
+* TelemetryMonitor: attaches to the telemetry ring of the simulation with the process number "--Pid", waiting up to "--Wait" seconds for it (default: 10), and prints one "time rate steps_per_second" line every "--Interval" ms (default: 500), the rate averaged over the steps since the previous line, or one line per time step with "--Samples 1". It exits when the simulation is finished, e.g. ./NeuronSimulation -r 1 --Telemetry 1 & ./TelemetryMonitor --Pid $!
+* RasterPlot: renders the raster and the population rate of spikes.bin, or of the "--File" given, a spike store or the recordings raster.npy, spikes.npy and spikes.txt of the observed neurons, from "--From" to "--To" ms (default: the whole file), for the neurons from "--First_neuron" to "--End_neuron" excluded, to "--Output" (default: raster.png), a PNG or an SVG with axes according to the extension. The spikes are streamed once into pixels of "--Width" by "--Height" (default: 1600 by 800), shaded by the square root of their number of spikes, with the rate of each column in a plot of "--Rate_height" pixels below (default: 200, none if 0), so that 100 million spikes of a spike store render in about half a second. The recordings are read through open_recording() at about 2 s for 100 million rows of raster.npy, plus a first pass when "--To" or "--End_neuron" isn't given, since they store neither the end of the run nor the number of neurons, and their time step is given by "--Time_step" (default: 0.1 ms). sum_spikes.txt and sum_spikes.npy hold no spikes of single neurons and are rejected.
+* ConvertRecording: converts a legacy "--Input" text recording (default: sum_spikes.txt) into "--Output" (default: the same name with .npy), the array the simulation writes with "--Npy 1": the spike sums as uint32, with the sums of the populations as more columns, and the observed neurons of a spikes.txt as rows of packed bits ("--Kind sums" or "observed", by default observed for a file named spikes.txt). The text is parsed by hand at a few hundred MB/s. The readers it uses, in src/RecordingReader.hpp, stream the rows of the text files and of the .npy arrays with a single iterator API, e.g. for (auto const& row : *open_recording("sum_spikes.txt")).
+
 
 ### CONTRIBUTORS
 Gaia Carparelli <br/> 
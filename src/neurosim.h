@@ -0,0 +1,96 @@
+/*! \file neurosim.h
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief C interface of libneurosim, which runs the simulation inside another program.
+ *  \details A program creates a simulation, configures it with the flags of NeuronSimulation, then advances it
+ *  \details step by step or up to a time, reading the neurons which spiked in each time step straight from the
+ *  \details simulation, without a copy nor a file. Only plain C types cross the interface, and no exception, so
+ *  \details that the library can be loaded from C, Python (ctypes, cffi) or any language with a C FFI.
+ *  \details The network is held in static members of the Cortex, so a process runs one simulation at a time, in
+ *  \details a single process: the flags distributing it over several ranks are rejected. The text files are only
+ *  \details written with "--Write_spikes 1".
+ */
+
+#ifndef NEUROSIM_H
+#define NEUROSIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! Version of the interface, increased whenever a function changes */
+#define NEUROSIM_API_VERSION 1
+
+/*! Results of the functions */
+#define NEUROSIM_OK 0
+#define NEUROSIM_ERROR (-1)
+/*! The simulation was stopped by "--Early_stop 1", the activity died out, saturated or its rate converged */
+#define NEUROSIM_STOPPED 1
+
+/*! \brief A simulation, opaque to the program */
+typedef struct neurosim neurosim;
+
+/*! \brief Returns NEUROSIM_API_VERSION of the library, to check it against that of the header */
+int neurosim_api_version(void);
+
+/*! \brief Creates a simulation, NULL if the process already has one */
+neurosim* neurosim_create(void);
+
+/*! \brief Builds the network, once per simulation
+ * @param[in] argc the number of flags
+ * @param[in] argv the flags of NeuronSimulation without the name of the program and "-r 1", e.g. {"-t", "4", "--Deterministic", "1"}
+ * @param[in] duration the time the simulation is expected to run [ms], the end of the default recording window
+ * \return NEUROSIM_OK, or NEUROSIM_ERROR with the reason in neurosim_last_error(), also for an unknown flag, --help or --version, which never end the process
+ */
+int neurosim_configure(neurosim* simulation, int argc, char const* const* argv, double duration);
+
+/*! \brief Simulates the next time step
+ * \return NEUROSIM_OK, NEUROSIM_STOPPED once the simulation was stopped early, or NEUROSIM_ERROR
+ */
+int neurosim_step(neurosim* simulation);
+
+/*! \brief Simulates the time steps up to a time [ms], rounded to the nearest time step, excluded
+ * \return NEUROSIM_OK, NEUROSIM_STOPPED if the simulation was stopped early before the time, or NEUROSIM_ERROR
+ */
+int neurosim_run_until(neurosim* simulation, double time);
+
+/*! \brief Gives the neurons which spiked in the last time step, in increasing order
+ *  \details Their spikes reach the other neurons after the transmission delay. The array belongs to the simulation and stays valid until the next step or neurosim_destroy().
+ * @param[out] neurons the global indexes of the neurons
+ * @param[out] count the number of neurons
+ * \return NEUROSIM_OK, or NEUROSIM_ERROR if the simulation isn't configured
+ */
+int neurosim_get_spikes(neurosim const* simulation, uint32_t const** neurons, size_t* count);
+
+/*! \brief Returns the number of time steps simulated */
+int64_t neurosim_steps(neurosim const* simulation);
+
+/*! \brief Returns the simulated time [ms] */
+double neurosim_time(neurosim const* simulation);
+
+/*! \brief Returns the time step [ms], 0 before the simulation is configured */
+double neurosim_time_step(neurosim const* simulation);
+
+/*! \brief Returns the number of neurons of the network, 0 before the simulation is configured */
+uint32_t neurosim_number_of_neurons(neurosim const* simulation);
+
+/*! \brief Returns the number of spikes of the network sent so far, those of the last transmission delay left out */
+int64_t neurosim_total_spikes(neurosim const* simulation);
+
+/*! \brief Returns the reason of the last NEUROSIM_ERROR, empty if none */
+char const* neurosim_last_error(neurosim const* simulation);
+
+/*! \brief Completes the simulation, closes its recordings and frees it, after which the process can create another one */
+void neurosim_destroy(neurosim* simulation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* neurosim_h */
@@ -2,10 +2,42 @@
 #include <stdexcept>
 #include <iostream>
 #include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <numeric>
+#include <utility>
 
 #include <gtest/gtest.h>
 #include "../src/Cortex.hpp"
 #include "../src/Neuron.hpp"
+#include "../src/Communicator.hpp"
+#include "../src/Numa.hpp"
+#include "../src/WorkerPool.hpp"
+#include "../src/StepBarrier.hpp"
+#include "../src/CounterRandom.hpp"
+#include "../src/BackgroundNoise.hpp"
+#include "../src/MeanField.hpp"
+#include "../src/ActivityMonitor.hpp"
+#include "../src/SpikeStatistics.hpp"
+#include "../src/PopulationSpectrum.hpp"
+#include "../src/SpikeStore.hpp"
+#include "../src/NpyExport.hpp"
+#include "../src/RecordingPolicy.hpp"
+#include "../src/Multimeter.hpp"
+#include "../src/Telemetry.hpp"
+#include "../src/RasterPlot.hpp"
+#include "../src/RecordingReader.hpp"
+#include "../src/SpikeSubscriber.hpp"
+#include "../src/Stimulus.hpp"
+#include "../src/neurosim.h"
+#include "../src/CortexInitializer.hpp"
+#include "../src/EngineValidation.hpp"
+#include <thread>
+#include <atomic>
+#include <unistd.h>
 
 double excitatory_amplitude (0.1);
 double relative_inhibitory_amplitude (5.0);
@@ -32,6 +64,14 @@ TEST (Main_Test, constants) {
 
 // ------------------------ Cortex Tests--------------------------------
 
+// Communicator which doesn't talk to anybody, for tests that only need a rank and a size
+class LoopbackCommunicator : public Communicator
+{
+	public :
+		LoopbackCommunicator(int rank, int size) : Communicator(rank, size) {}
+		void exchange(RankBuffers const& outgoing, RankBuffers& incoming) override { incoming = outgoing; }
+};
+
 // Test Cortex constructor
 TEST(Cortex_Test, initialize_cortex) {
 	
@@ -57,15 +97,6 @@ TEST(Cortex_Test, update) {
 	}
 }
 
-// Test Cortex::increment_spike_sum()
-TEST(Cortex_Test, increment_spike_sum) {
-	double spike_sum(2);
-	Cortex::set_spike_sum (spike_sum);
-	EXPECT_EQ(spike_sum, Cortex::get_spike_sum());
-	Cortex::increment_spike_sum();
-	EXPECT_EQ(++spike_sum, Cortex::get_spike_sum());
-}
-
 // Test Cortex::send_spike
 TEST(Cortex_Test, send_spike) {
 	short unsigned int index1(0), index2(15), index3(30), index4(45), index5(50), index6(70), index7(99);
@@ -136,6 +167,312 @@ TEST(Cortex_Test, write_spike_sum_file) {
 	EXPECT_EQ(0, Cortex::get_spike_sum());
 }
 
+// Test Cortex::first_neuron_of_rank and Cortex::rank_of
+TEST(Cortex_Test, domain_decomposition) {
+	constexpr int SIZE(3);
+	
+	// the blocks cover the network without overlapping
+	EXPECT_EQ(0, Cortex::first_neuron_of_rank(0, SIZE));
+	EXPECT_EQ(Cortex::number_of_neurons_, Cortex::first_neuron_of_rank(SIZE, SIZE));
+	for (int rank(0); rank < SIZE; ++rank) {
+		EXPECT_LE(Cortex::first_neuron_of_rank(rank, SIZE), Cortex::first_neuron_of_rank(rank + 1, SIZE));
+	}
+	
+	// every neuron is simulated by the rank whose block contains it
+	LoopbackCommunicator communicator(0, SIZE);
+	Cortex::communicator_ = &communicator;
+	for (unsigned int neuron(0); neuron < Cortex::number_of_neurons_; ++neuron) {
+		int rank(Cortex::rank_of(neuron));
+		EXPECT_LE(Cortex::first_neuron_of_rank(rank, SIZE), neuron);
+		EXPECT_GT(Cortex::first_neuron_of_rank(rank + 1, SIZE), neuron);
+	}
+	Cortex::communicator_ = nullptr;
+}
+
+// Test Cortex::update with several threads
+TEST(Cortex_Test, update_in_parallel) {
+	constexpr unsigned int THREADS(3);
+	constexpr int TIME(100);
+	
+	Cortex::reset();
+	Cortex::set_threads(THREADS, std::vector<int>());
+	Cortex::initialize_neurons();
+	ASSERT_NE(nullptr, Cortex::workers_);
+	EXPECT_EQ(THREADS, Cortex::workers_->size());
+	EXPECT_EQ(Cortex::number_of_neurons_, Cortex::neurons_.size());
+	for (unsigned int worker(0); worker < THREADS; ++worker) {
+		for (unsigned int i(Cortex::worker_first_neuron_[worker]); i < Cortex::worker_first_neuron_[worker + 1]; ++i) {
+			EXPECT_EQ(worker, Cortex::worker_of(i));
+		}
+	}
+	
+	// only the first neuron sends a spike at TIME, nobody reaches the threshold
+	for (auto& neuron : Cortex::neurons_) {
+		neuron->potential_ = RESTING_POTENTIAL;
+		neuron->last_spike_ = -100;
+	}
+	Neuron& sender(*Cortex::neurons_[0]);
+	sender.last_spike_ = TIME - TRANSMISSION_DELAY + 1;
+	Cortex::update(TIME);
+	
+	// the spike reached the targets of all workers, and only them
+	std::vector<double> expected(Cortex::neurons_.size(), 0.0);
+	for (auto const index : sender.connection_indexes_) {
+		expected[index] = sender.amplitude_;
+	}
+	for (size_t i(0); i < Cortex::neurons_.size(); ++i) {
+		EXPECT_EQ(expected[i], Cortex::neurons_[i]->next_input_);
+		EXPECT_LE(0.0, Cortex::neurons_[i]->current_input_);
+	}
+	// the owners emptied the buckets
+	for (auto const worker : Cortex::worker_states_) {
+		for (auto const& bucket : worker->buckets) {
+			EXPECT_TRUE(bucket.empty());
+		}
+	}
+	
+	Cortex::reset();
+	Cortex::set_threads(1, std::vector<int>());
+	EXPECT_EQ(nullptr, Cortex::workers_);
+}
+
+// Test the spikes counted by population, in a single thread and in several
+TEST(Cortex_Test, population_sums) {
+	constexpr int TIME(100);
+	std::vector<Population> const defaults(Cortex::get_populations());
+	unsigned int const last(Cortex::number_of_neurons_);
+	EXPECT_THROW(Cortex::set_populations({Population{"a", 0, 20}, Population{"b", 10, 30}}), std::runtime_error);
+	EXPECT_THROW(Cortex::set_populations({Population{"a", 0, last + 1}}), std::runtime_error);
+	
+	for (unsigned int threads(1); threads <= 2; ++threads) {
+		// the neurons 10 to last - 11 belong to no population
+		Cortex::reset();
+		Cortex::set_populations({Population{"first", 0, 10}, Population{"last", last - 10, last}});
+		Cortex::set_threads(threads, std::vector<int>());
+		Cortex::initialize_neurons();
+		for (auto& neuron : Cortex::neurons_) {
+			neuron->potential_ = RESTING_POTENTIAL;
+			neuron->last_spike_ = -100;
+		}
+		for (unsigned int const sender : {0u, 9u, 15u, last - 1}) {
+			Cortex::neurons_[sender]->last_spike_ = TIME - TRANSMISSION_DELAY + 1;
+		}
+		long const total(Cortex::get_total_population_sums()[1]);
+		Cortex::update(TIME);
+		EXPECT_EQ(4, Cortex::get_step_spike_sum());
+		EXPECT_EQ(std::vector<unsigned int>({2, 1}), Cortex::get_step_population_sums());
+		EXPECT_EQ(total + 1, Cortex::get_total_population_sums()[1]);
+	}
+	
+	Cortex::reset();
+	Cortex::set_threads(1, std::vector<int>());
+	Cortex::set_populations(defaults);
+}
+
+// Test that the spike sum of a time step is counted with the sums of the populations
+TEST(Cortex_Test, spike_sum) {
+	constexpr int STEPS(300);
+	Cortex::initialize_neurons();
+	long const total(Cortex::get_total_spike_sum());
+	long counted(0);
+	for (int t(0); t < STEPS; ++t) {
+		Cortex::update(t);
+		// every neuron belongs to one of the default populations
+		std::vector<unsigned int> const& sums(Cortex::get_step_population_sums());
+		EXPECT_EQ(Cortex::get_step_spike_sum(), sums[0] + sums[1]);
+		counted += Cortex::get_step_spike_sum();
+	}
+	EXPECT_GT(counted, 0);
+	EXPECT_EQ(total + counted, Cortex::get_total_spike_sum());
+	Cortex::reset();
+}
+
+// Subscriber recording the spikes it receives as pairs of a time step and a neuron
+class RecordingSubscriber : public SpikeSubscriber
+{
+	public :
+
+		RecordingSubscriber(std::vector<std::pair<int, unsigned int>>& spikes, int& finished)
+			: spikes_(spikes), finished_(finished)
+		{}
+
+		void on_spikes(SpikeSpan const& spikes) override
+		{
+			for (int step(spikes.first_step); step < spikes.first_step + spikes.steps; ++step) {
+				for (auto neuron(spikes.step_begin(step)); neuron != spikes.step_end(step); ++neuron) {
+					spikes_.emplace_back(step, *neuron);
+				}
+			}
+		}
+
+		void on_finish() override
+		{
+			++finished_;
+		}
+
+	private :
+
+		std::vector<std::pair<int, unsigned int>>& spikes_;
+		int& finished_;
+};
+
+// Test that the subscribers receive the spikes of every time step, by batches and on their own thread
+TEST(Cortex_Test, spike_subscribers) {
+	constexpr int TIME(150);
+	std::vector<std::pair<int, unsigned int>> expected, each_step, batched, asynchronous;
+	int finished(0);
+	EXPECT_THROW(Cortex::add_spike_subscriber(new RecordingSubscriber(expected, finished), 0), std::runtime_error);
+
+	Cortex::reset();
+	Cortex::set_threads(2, std::vector<int>());
+	Cortex::initialize_neurons();
+	// the spike store keeps its own copy of the spikes, the sums count them when they are sent
+	Cortex::set_spike_store(new SpikeStoreWriter("test_subscribers.bin", Cortex::get_number_of_neurons(), Cortex::timestep_, 1.0));
+	Cortex::add_spike_subscriber(new RecordingSubscriber(each_step, finished));
+	Cortex::add_spike_subscriber(new RecordingSubscriber(batched, finished), 4);
+	Cortex::add_spike_subscriber(new AsyncSpikeSubscriber(new RecordingSubscriber(asynchronous, finished), 2), Cortex::exchange_epoch());
+	std::vector<int> sent(TIME, 0);
+	for (int t(0); t < TIME; ++t) {
+		Cortex::update(t);
+		sent[t] = Cortex::get_step_spike_sum();
+	}
+	Cortex::finish();
+
+	SpikeStoreReader const store("test_subscribers.bin");
+	store.for_each_chunk(0, TIME, [&expected](SpikeEvent const* begin, SpikeEvent const* end) {
+		for (SpikeEvent const* spike(begin); spike != end; ++spike) {
+			expected.emplace_back(spike->step, spike->neuron);
+		}
+	});
+	std::remove("test_subscribers.bin");
+	// the subscribers receive the neurons of a step in increasing order
+	std::sort(expected.begin(), expected.end());
+
+	// a spike is sent in the step before it is received, the transmission delay after its neuron spiked
+	int const delay(Neuron::get_delay_steps() - 1);
+	for (int t(0); t + delay < TIME; ++t) {
+		EXPECT_EQ(sent[t + delay], std::count_if(each_step.begin(), each_step.end(),
+												 [t](std::pair<int, unsigned int> const& spike) { return spike.first == t; }));
+	}
+	EXPECT_FALSE(expected.empty());
+	EXPECT_EQ(expected, each_step);
+	EXPECT_EQ(expected, batched);
+	EXPECT_EQ(expected, asynchronous);
+	EXPECT_EQ(3, finished);
+
+	Cortex::reset();
+	Cortex::set_threads(1, std::vector<int>());
+	Cortex::initialize_neurons();
+	Cortex::update(0);
+	EXPECT_TRUE(Cortex::get_step_spikes().empty());
+}
+
+// Test that a deterministic simulation gives the same results with any number of threads
+TEST(Cortex_Test, deterministic_update) {
+	constexpr int TIME(400);
+	
+	std::vector<double> reference_potentials, potentials;
+	std::vector<int> reference_spikes, spikes;
+	for (unsigned int threads(1); threads <= 3; ++threads) {
+		Cortex::reset();
+		Cortex::set_threads(threads, std::vector<int>());
+		Cortex::set_deterministic(true, 42);
+		Cortex::initialize_neurons();
+		
+		potentials.clear();
+		spikes.clear();
+		for (int t(0); t < TIME; ++t) {
+			Cortex::update(t);
+		}
+		for (auto const neuron : Cortex::neurons_) {
+			spikes.push_back(neuron->last_spike_);
+			potentials.push_back(neuron->potential_);
+			potentials.push_back(neuron->next_input_);
+		}
+		
+		if (threads == 1) {
+			reference_potentials = potentials;
+			reference_spikes = spikes;
+		} else {
+			EXPECT_EQ(reference_spikes, spikes);
+			EXPECT_EQ(reference_potentials, potentials);
+		}
+	}
+	
+	Cortex::reset();
+	Cortex::set_deterministic(false, 0);
+	Cortex::set_threads(1, std::vector<int>());
+}
+
+// Test the background models
+TEST(Cortex_Test, background_noise) {
+	Cortex::reset();
+	Cortex::initialize_neurons();
+	std::default_random_engine generator(1);
+	std::poisson_distribution<int> distribution(external_input_frequency);
+	std::vector<double> noise;
+	
+	// a fraction 1 shared by all neurons gives them all the same input
+	Cortex::set_background(BackgroundModel::shared, 1.0);
+	Cortex::update(0);
+	Cortex::add_background_noise(0, Cortex::neurons_.size(), 1, generator, distribution, noise);
+	EXPECT_EQ(Cortex::neurons_.size(), noise.size());
+	EXPECT_EQ(std::vector<double>(noise.size(), noise[0]), noise);
+	
+	Cortex::set_background(BackgroundModel::gaussian, 1.0);
+	Cortex::add_background_noise(0, Cortex::neurons_.size(), 1, generator, distribution, noise);
+	EXPECT_NE(noise[0], noise[1]);
+	
+	EXPECT_THROW(Cortex::set_background(BackgroundModel::shared, 1.5), std::runtime_error);
+	Cortex::set_background(BackgroundModel::poisson, 0.0);
+	Cortex::reset();
+}
+
+// Test that the background input follows the drive, for the Poisson and the Gaussian models
+TEST(Cortex_Test, external_drive) {
+	constexpr int STEPS(60);
+	std::default_random_engine generator(1);
+	std::poisson_distribution<int> distribution(external_input_frequency);
+	std::vector<double> noise;
+	unsigned int const neurons(Cortex::get_number_of_neurons());
+	for (auto const model : {BackgroundModel::poisson, BackgroundModel::gaussian}) {
+		for (bool const deterministic : {false, true}) {
+			Cortex::reset();
+			Cortex::set_deterministic(deterministic, 7);
+			Cortex::set_background(model, 0.0);
+			Cortex::initialize_neurons();
+			ExternalDrive* drive = new ExternalDrive(2.0, external_input_frequency / 2.0, DEFAULT_TIME_STEP, neurons);
+			Cortex::set_drive(drive);
+			// no external input for the inhibitory neurons after 1 ms
+			add_stimuli(*drive, "inhibitory:step,1,1000,0", Cortex::get_populations(), neurons);
+			unsigned int const inhibitory(Cortex::get_populations()[0].end);
+
+			double inhibitory_sum(0), excitatory_sum(0);
+			for (int t(10); t < STEPS; ++t) {
+				Cortex::update(t);
+				Cortex::add_background_noise(0, neurons, t, generator, distribution, noise);
+				for (unsigned int i(0); i < neurons; ++i) {
+					(i < inhibitory ? inhibitory_sum : excitatory_sum) += noise[i];
+				}
+			}
+			EXPECT_EQ(0.0, inhibitory_sum);
+			double const mean(excitatory_amplitude * external_input_frequency);
+			EXPECT_NEAR(mean, excitatory_sum / ((STEPS - 10) * (neurons - inhibitory)), 0.05 * mean);
+			if (deterministic) {
+				// the input of a neuron doesn't depend on the part of the network drawn with it
+				std::vector<double> part;
+				Cortex::add_background_noise(inhibitory + 10, inhibitory + 40, STEPS - 1, generator, distribution, part);
+				EXPECT_EQ(std::vector<double>(noise.begin() + inhibitory + 10, noise.begin() + inhibitory + 40),
+						  std::vector<double>(part.begin(), part.begin() + 30));
+			}
+		}
+	}
+	Cortex::set_deterministic(false, 0);
+	Cortex::set_background(BackgroundModel::poisson, 0.0);
+	Cortex::reset();
+	Cortex::initialize_neurons();
+}
+
 // Test Cortex::reset
 TEST(Cortex_Test, reset_neurons) {
 	Cortex::reset();
@@ -143,6 +480,267 @@ TEST(Cortex_Test, reset_neurons) {
 }
 
 
+// ------------------------ CounterRandom Tests--------------------------------
+
+// Test that a stream only depends on the seed and its identifiers
+TEST(CounterRandom_Test, streams) {
+	CounterRandom first(42, 7, 100), same(42, 7, 100), other(42, 7, 101);
+	bool all_equal(true), all_different(true);
+	for (int i(0); i < 16; ++i) {
+		uint32_t const number(first.next());
+		all_equal = all_equal and number == same.next();
+		all_different = all_different and number != other.next();
+	}
+	EXPECT_TRUE(all_equal);
+	EXPECT_TRUE(all_different);
+}
+
+// Test the mean of the Poisson numbers, for the inversion and the rejection
+TEST(CounterRandom_Test, poisson_mean) {
+	constexpr int DRAWS(20000);
+	for (double const mean : {0.5, 2.0, 30.0}) {
+		PoissonSampler const sampler(mean);
+		double sum(0);
+		for (int i(0); i < DRAWS; ++i) {
+			CounterRandom random(1, i, 0);
+			sum += sampler(random);
+		}
+		// within 5 standard deviations of the sample mean
+		EXPECT_NEAR(mean, sum / DRAWS, 5 * std::sqrt(mean / DRAWS));
+	}
+}
+
+
+// ------------------------ EngineValidation Tests--------------------------------
+
+// Test the parsing of the engine names
+TEST(EngineValidation_Test, parse_engine) {
+	EngineSpec const sequential(parse_engine("sequential"));
+	EXPECT_EQ(1u, sequential.threads);
+	EXPECT_FALSE(sequential.deterministic);
+	EngineSpec const deterministic(parse_engine("deterministic:3"));
+	EXPECT_EQ(3u, deterministic.threads);
+	EXPECT_TRUE(deterministic.deterministic);
+	EXPECT_THROW(parse_engine("parallel"), std::runtime_error);
+	EXPECT_THROW(parse_engine("parallel:0"), std::runtime_error);
+	EXPECT_THROW(parse_engine("vectorized:2"), std::runtime_error);
+	
+	EXPECT_TRUE(can_be_identical(parse_engine("deterministic:1"), parse_engine("deterministic:4")));
+	EXPECT_TRUE(can_be_identical(sequential, sequential));
+	EXPECT_FALSE(can_be_identical(sequential, parse_engine("parallel:2")));
+	EXPECT_FALSE(can_be_identical(parse_engine("parallel:2"), parse_engine("parallel:2")));
+	EXPECT_FALSE(can_be_identical(sequential, deterministic));
+}
+
+// Test that identical engines are equivalent and that a divergence is located
+TEST(EngineValidation_Test, compare_exact) {
+	NetworkParameters const parameters {5.0, 0.1, 2.0, 12500, 0.1, 3};
+	
+	EngineValidation same(parameters, parse_engine("deterministic:1"), parse_engine("deterministic:2"));
+	ExactReport const equivalent(same.compare_exact(200));
+	EXPECT_TRUE(equivalent.equivalent);
+	EXPECT_EQ(-1, equivalent.step);
+	
+	// the sequential engine draws its noise from another generator: the inputs differ from the first step on
+	EngineValidation different(parameters, parse_engine("sequential"), parse_engine("deterministic:1"));
+	ExactReport const divergent(different.compare_exact(200));
+	EXPECT_FALSE(divergent.equivalent);
+	EXPECT_EQ(0, divergent.step);
+	EXPECT_LE(0, divergent.neuron);
+	EXPECT_NE(divergent.reference_value, divergent.candidate_value);
+	Cortex::set_write_files(true);
+}
+
+
+// ------------------------ Communicator Tests--------------------------------
+
+// Exchanges distinct buffers between the ranks of a communicator,
+// returns whether each rank received what the others sent it
+bool exchange_rank_buffers(Communicator& communicator) {
+	int const rank(communicator.get_rank());
+	int const size(communicator.get_size());
+	
+	// rank r sends r * 100 + d repeated d + 1 times to rank d
+	RankBuffers outgoing(size), incoming;
+	for (int to(0); to < size; ++to) {
+		outgoing[to].assign(to + 1, rank * 100 + to);
+	}
+	communicator.exchange(outgoing, incoming);
+	
+	bool correct(incoming.size() == static_cast<size_t>(size));
+	for (int from(0); correct and from < size; ++from) {
+		correct = (incoming[from] == std::vector<unsigned int>(rank + 1, from * 100 + rank));
+	}
+	return correct;
+}
+
+// Test the shared memory transport between forked processes
+TEST(Communicator_Test, shared_memory_exchange) {
+	constexpr int SIZE(3);
+	Communicator* communicator(launch_local_ranks("shm", SIZE, 16, 0));
+	bool correct(exchange_rank_buffers(*communicator));
+	
+	if (communicator->get_rank() != 0) {
+		// forked rank: report through the exit status, don't run the other tests
+		delete communicator;
+		_exit(correct ? 0 : 1);
+	}
+	EXPECT_TRUE(correct);
+	EXPECT_EQ(0, communicator->wait_for_children());
+	delete communicator;
+}
+
+// Test that the ranks leave an exchange which one of them aborted, instead of waiting for it forever
+TEST(Communicator_Test, shared_memory_abort) {
+	constexpr int SIZE(3);
+	Communicator* communicator(launch_local_ranks("shm", SIZE, 2, 0));
+	int const rank(communicator->get_rank());
+	
+	// the last rank overflows a mailbox, the others wait for it in the barrier
+	RankBuffers outgoing(SIZE), incoming;
+	if (rank == SIZE - 1) {
+		outgoing[0].assign(3, rank);
+	}
+	bool thrown(false);
+	try {
+		communicator->exchange(outgoing, incoming);
+	} catch (std::runtime_error const&) {
+		thrown = true;
+	}
+	
+	if (rank != 0) {
+		delete communicator;
+		_exit(thrown ? 0 : 1);
+	}
+	EXPECT_TRUE(thrown);
+	EXPECT_EQ(0, communicator->wait_for_children());
+	delete communicator;
+}
+
+// Test the socket transport between forked processes
+TEST(Communicator_Test, socket_exchange) {
+	constexpr int SIZE(3);
+	Communicator* communicator(launch_local_ranks("socket", SIZE, 0, 47700 + getpid() % 1000));
+	bool correct(exchange_rank_buffers(*communicator));
+	
+	if (communicator->get_rank() != 0) {
+		delete communicator;
+		_exit(correct ? 0 : 1);
+	}
+	EXPECT_TRUE(correct);
+	EXPECT_EQ(0, communicator->wait_for_children());
+	delete communicator;
+}
+
+
+// ------------------------ Threading Tests--------------------------------
+
+// Test parse_cpu_list
+TEST(Numa_Test, parse_cpu_list) {
+	EXPECT_TRUE(parse_cpu_list("").empty());
+	EXPECT_EQ(std::vector<int>({3}), parse_cpu_list("3"));
+	EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}), parse_cpu_list("0-3,8,10-11"));
+	
+	EXPECT_THROW(parse_cpu_list("1,,2"), std::runtime_error);
+	EXPECT_THROW(parse_cpu_list("3-1"), std::runtime_error);
+	EXPECT_THROW(parse_cpu_list("a"), std::runtime_error);
+	EXPECT_THROW(parse_cpu_list("1-"), std::runtime_error);
+}
+
+// Test StepBarrier::wait, spinning and sleeping
+TEST(StepBarrier_Test, wait) {
+	constexpr unsigned int THREADS(4);
+	constexpr unsigned int ROUNDS(200);
+	
+	// the barrier sits on cache lines of its own
+	EXPECT_LE(3 * CACHE_LINE_SIZE, sizeof(StepBarrier));
+	
+	for (unsigned int spins : {0u, DEFAULT_BARRIER_SPINS}) {
+		StepBarrier barrier(THREADS, spins);
+		std::atomic<unsigned int> arrived(0);
+		std::atomic<bool> overtaken(false);
+		
+		// nobody may start a round before everybody has finished the previous one
+		auto run = [&] {
+			for (unsigned int round(0); round < ROUNDS; ++round) {
+				arrived.fetch_add(1);
+				barrier.wait();
+				if (arrived.load() < (round + 1) * THREADS) {
+					overtaken = true;
+				}
+				barrier.wait();
+			}
+		};
+		std::vector<std::thread> threads;
+		for (unsigned int thread(1); thread < THREADS; ++thread) {
+			threads.push_back(std::thread(run));
+		}
+		run();
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		
+		EXPECT_FALSE(overtaken);
+		EXPECT_EQ(ROUNDS * THREADS, arrived.load());
+	}
+}
+
+// Test WorkerPool::run and WorkerPool::synchronize
+TEST(WorkerPool_Test, run) {
+	constexpr unsigned int SIZE(4);
+	WorkerPool pool(SIZE, std::vector<int>());
+	EXPECT_EQ(SIZE, pool.size());
+	
+	// every worker writes its slot, then reads the slot of its neighbour after synchronizing
+	std::vector<unsigned int> written(SIZE, 0), read(SIZE, 0);
+	for (unsigned int round(1); round <= 3; ++round) {
+		pool.run([&](unsigned int worker) {
+			written[worker] = round * 10 + worker;
+			pool.synchronize();
+			read[worker] = written[(worker + 1) % SIZE];
+		});
+		for (unsigned int worker(0); worker < SIZE; ++worker) {
+			EXPECT_EQ(round * 10 + (worker + 1) % SIZE, read[worker]);
+		}
+	}
+}
+
+// Test WorkerPool::push_task and WorkerPool::next_task: every task runs exactly once
+TEST(WorkerPool_Test, work_stealing) {
+	constexpr unsigned int SIZE(4);
+	constexpr unsigned int TASKS(5000);
+	WorkerPool pool(SIZE, std::vector<int>());
+	std::vector<std::atomic<unsigned int> > runs(TASKS);
+	std::vector<unsigned int> ran_by(SIZE, 0);
+	
+	for (unsigned int round(0); round < 3; ++round) {
+		for (auto& count : runs) {
+			count = 0;
+		}
+		pool.run([&](unsigned int worker) {
+			pool.clear_tasks(worker);
+			// all the work is on worker 0, the others have to steal it
+			if (worker == 0) {
+				for (unsigned int i(0); i < TASKS; ++i) {
+					pool.push_task(worker, WorkerTask{worker, i, i + 1});
+				}
+			}
+			pool.synchronize();
+			WorkerTask task;
+			while (pool.next_task(worker, task)) {
+				EXPECT_EQ(0u, task.owner);
+				runs[task.begin].fetch_add(1);
+				++ran_by[worker];
+			}
+		});
+		for (auto const& count : runs) {
+			EXPECT_EQ(1u, count.load());
+		}
+	}
+	EXPECT_EQ(3 * TASKS, ran_by[0] + ran_by[1] + ran_by[2] + ran_by[3]);
+}
+
+
 // ------------------------ Neuron Tests--------------------------------
 
 // Test Neuron constructor
@@ -287,6 +885,903 @@ TEST(Neuron_Test, reset_input) {
 	EXPECT_EQ(neuron.next_input_, neuron.current_input_);
 }
 
+// Test the exact integration of the exponential synaptic current
+TEST(Neuron_Test, exponential_synapse) {
+	constexpr double TIME_STEP(0.5);
+	constexpr double AMPLITUDE(2.0);
+	
+	Neuron::set_model(NeuronModel::lif_exponential, DEFAULT_TAU_SYN);
+	Neuron::set_time_step(TIME_STEP);
+	// without targets, as if they were all simulated by other ranks
+	Neuron neuron(AMPLITUDE, std::vector<short unsigned int>(), true);
+	
+	// one input at the first step, then the potential follows the analytic solution
+	neuron.sum_input(AMPLITUDE);
+	for (int step(1); step <= 10; ++step) {
+		neuron.reset_input();
+		neuron.update(100 + step);
+		double const time(step * TIME_STEP);
+		double const expected(AMPLITUDE * TAU / (TAU - DEFAULT_TAU_SYN) * (exp(-time / TAU) - exp(-time / DEFAULT_TAU_SYN)));
+		EXPECT_NEAR(expected, neuron.get_potential(), 1e-12);
+		EXPECT_NEAR(AMPLITUDE / DEFAULT_TAU_SYN * exp(-time / DEFAULT_TAU_SYN), neuron.get_synaptic_current(), 1e-12);
+	}
+	
+	// the periods have to be whole numbers of time steps, and the delay at least two of them
+	EXPECT_THROW(Neuron::set_time_step(0.3), std::runtime_error);
+	EXPECT_THROW(Neuron::set_time_step(1.5), std::runtime_error);
+	EXPECT_THROW(Neuron::set_model(NeuronModel::lif_exponential, 0), std::runtime_error);
+	
+	Neuron::set_model(NeuronModel::lif_delta, DEFAULT_TAU_SYN);
+	Neuron::set_time_step(Cortex::timestep_);
+	EXPECT_EQ(TRANSMISSION_DELAY, Neuron::get_delay_steps());
+}
+
+// Test the interpolation of the threshold crossing
+TEST(Neuron_Test, precise_spike_time) {
+	constexpr double BELOW_THRESHOLD(THRESHOLD_POTENTIAL - 0.5);
+	constexpr double INPUT(1.0);
+	
+	Neuron::set_precise(true);
+	Neuron neuron(Cortex::get_excitatory_amplitude(), std::vector<short unsigned int>(), true);
+	neuron.sum_input(BELOW_THRESHOLD);
+	neuron.reset_input();
+	neuron.update(100);
+	EXPECT_EQ(0, neuron.get_spike_offset());
+	
+	neuron.sum_input(INPUT);
+	neuron.reset_input();
+	neuron.update(101);
+	double const potential(BELOW_THRESHOLD * DefaultPropagators::membrane + INPUT);
+	double const offset((potential - THRESHOLD_POTENTIAL) / (potential - BELOW_THRESHOLD));
+	EXPECT_DOUBLE_EQ(offset, neuron.get_spike_offset());
+	EXPECT_LT(0, neuron.get_spike_offset());
+	EXPECT_GT(1, neuron.get_spike_offset());
+	
+	// a spike arriving offset steps before the end of a step decays until then
+	EXPECT_DOUBLE_EQ(1.0, Neuron::offset_decay(0));
+	EXPECT_DOUBLE_EQ(exp(-offset * Cortex::timestep_ / TAU), Neuron::offset_decay(offset));
+	
+	// reset on the grid, the spike reaches the targets the delay after the crossing, offset steps before the end of a step
+	EXPECT_FALSE(neuron.update(102));
+	EXPECT_EQ(102, neuron.get_last_spike());
+	EXPECT_EQ(RESET_POTENTIAL, neuron.get_potential());
+	EXPECT_EQ(102 + TRANSMISSION_DELAY - 2, neuron.send_step_);
+	EXPECT_NEAR(offset, neuron.arrival_offset_, 1e-12);
+	
+	// the refractory period ends offset steps before the grid point 102 + REFRACTORY_PERIOD, then the rest of the step is integrated
+	for (int t(103); t < 102 + REFRACTORY_PERIOD - 1; ++t) {
+		neuron.sum_input(INPUT);
+		neuron.reset_input();
+		EXPECT_EQ(t == 102 + TRANSMISSION_DELAY - 2, neuron.update(t));
+		EXPECT_EQ(RESET_POTENTIAL, neuron.get_potential());
+	}
+	neuron.sum_input(INPUT);
+	neuron.reset_input();
+	neuron.update(102 + REFRACTORY_PERIOD - 1);
+	EXPECT_NEAR(RESET_POTENTIAL * Neuron::offset_decay(offset) + offset * INPUT, neuron.get_potential(), 1e-12);
+	
+	// across a step boundary, the spike arrives the delay after the crossing
+	int send_step(0);
+	double arrival_offset(0);
+	Neuron::schedule_spike(200, 0.25, send_step, arrival_offset);
+	EXPECT_EQ(200 + TRANSMISSION_DELAY - 2, send_step);
+	EXPECT_DOUBLE_EQ(0.25, arrival_offset);
+	
+	// the periods no longer have to be multiples of the time step, only to last one of them
+	Neuron::set_time_step(1.0);
+	EXPECT_EQ(2, Neuron::get_delay_steps());
+	Neuron::schedule_spike(200, 0.25, send_step, arrival_offset);
+	EXPECT_EQ(200, send_step);
+	EXPECT_DOUBLE_EQ(0.75, arrival_offset);
+	Neuron::schedule_spike(200, 0.75, send_step, arrival_offset);
+	EXPECT_EQ(199, send_step);
+	EXPECT_DOUBLE_EQ(0.25, arrival_offset);
+	EXPECT_THROW(Neuron::set_time_step(2.0), std::runtime_error);
+	Neuron::set_time_step(Cortex::timestep_);
+	
+	Neuron::set_model(NeuronModel::lif_exponential, DEFAULT_TAU_SYN);
+	EXPECT_THROW(Neuron::set_precise(true), std::runtime_error);
+	Neuron::set_model(NeuronModel::lif_delta, DEFAULT_TAU_SYN);
+	Neuron::set_precise(false);
+}
+
+// ------------------------ BackgroundNoise Tests--------------------------------
+
+// Test the moments of the Box-Muller numbers
+TEST(BackgroundNoise_Test, normal_moments) {
+	constexpr unsigned int DRAWS(100001);
+	std::default_random_engine generator(3);
+	std::vector<double> normals;
+	fill_normal(generator, normals, DRAWS);
+	ASSERT_EQ(DRAWS, normals.size());
+	
+	double mean(0), square(0), counter_mean(0), counter_square(0);
+	for (unsigned int i(0); i < DRAWS; ++i) {
+		mean += normals[i];
+		square += normals[i] * normals[i];
+		CounterRandom random(3, i, 0);
+		double const number(normal(random));
+		counter_mean += number;
+		counter_square += number * number;
+	}
+	EXPECT_NEAR(0.0, mean / DRAWS, 0.01);
+	EXPECT_NEAR(1.0, square / DRAWS, 0.02);
+	EXPECT_NEAR(0.0, counter_mean / DRAWS, 0.01);
+	EXPECT_NEAR(1.0, counter_square / DRAWS, 0.02);
+}
+
+// Drives a lone neuron with the background input of mean lambda per time step, Poisson or Gaussian,
+// returns its firing rate [Hz] and the coefficient of variation of its interspike intervals
+void fire_with_background(double lambda, bool gaussian, double& rate, double& cv) {
+	constexpr int STEPS(1000000);
+	Neuron::set_model(NeuronModel::lif_delta, DEFAULT_TAU_SYN);
+	Neuron::set_time_step(DEFAULT_TIME_STEP);
+	std::default_random_engine generator(5);
+	std::poisson_distribution<int> distribution(lambda);
+	std::vector<double> normals;
+	fill_normal(generator, normals, STEPS);
+	
+	Neuron neuron(excitatory_amplitude, std::vector<short unsigned int>(), true);
+	int last_spike(neuron.get_last_spike());
+	std::vector<double> intervals;
+	for (int t(0); t < STEPS; ++t) {
+		neuron.sum_input(excitatory_amplitude * (gaussian ? lambda + std::sqrt(lambda) * normals[t] : distribution(generator)));
+		neuron.reset_input();
+		neuron.update(t);
+		if (neuron.get_last_spike() != last_spike) {
+			if (last_spike >= 0) {
+				intervals.push_back(neuron.get_last_spike() - last_spike);
+			}
+			last_spike = neuron.get_last_spike();
+		}
+	}
+	ASSERT_GT(intervals.size(), 100u);
+	double mean(0), square(0);
+	for (double const interval : intervals) {
+		mean += interval;
+		square += interval * interval;
+	}
+	mean /= intervals.size();
+	rate = 1000.0 / (mean * DEFAULT_TIME_STEP);
+	cv = std::sqrt(square / intervals.size() - mean * mean) / mean;
+}
+
+// Quantify the error of the diffusion approximation on the firing of a neuron, at the default input rate
+// and at the threshold rate, where the firing is driven by the fluctuations of the input
+TEST(BackgroundNoise_Test, diffusion_error) {
+	double poisson_rate(0), poisson_cv(0), gaussian_rate(0), gaussian_cv(0);
+	
+	// about 100 Hz, nearly regular: the rates agree within 2%, the CV within 5%
+	fire_with_background(external_input_frequency, false, poisson_rate, poisson_cv);
+	fire_with_background(external_input_frequency, true, gaussian_rate, gaussian_cv);
+	EXPECT_NEAR(poisson_rate, gaussian_rate, 0.02 * poisson_rate);
+	EXPECT_NEAR(poisson_cv, gaussian_cv, 0.05 * poisson_cv);
+	
+	// mean input at the threshold, about 16 Hz with a CV of 0.37: the skew of the Poisson numbers, which the
+	// Gaussian lacks, shows most there, the rates agree within 5%, the CV within 8%
+	fire_with_background(external_input_frequency / 2, false, poisson_rate, poisson_cv);
+	fire_with_background(external_input_frequency / 2, true, gaussian_rate, gaussian_cv);
+	EXPECT_NEAR(poisson_rate, gaussian_rate, 0.05 * poisson_rate);
+	EXPECT_NEAR(poisson_cv, gaussian_cv, 0.08 * poisson_cv);
+	EXPECT_GT(poisson_cv, 0.2);
+	
+	Neuron::set_time_step(Cortex::timestep_);
+}
+
+// Test the moments of the tables inverting uniform numbers, for small, large and null means
+TEST(BackgroundNoise_Test, poisson_table) {
+	constexpr unsigned int DRAWS(200000);
+	for (double const mean : {0.0, 0.3, 2.0, 40.0, 1000.0}) {
+		PoissonTable const table(mean);
+		EXPECT_EQ(mean, table.mean());
+		// uniform numbers evenly spread over [0, 1), the moments are those of the table
+		double sum(0), square(0);
+		for (unsigned int i(0); i < DRAWS; ++i) {
+			int const k(table((i + 0.5) / DRAWS));
+			sum += k;
+			square += static_cast<double>(k) * k;
+		}
+		double const drawn_mean(sum / DRAWS);
+		EXPECT_NEAR(mean, drawn_mean, 1e-3 * (mean + 1));
+		EXPECT_NEAR(mean, square / DRAWS - drawn_mean * drawn_mean, 1e-2 * (mean + 1));
+	}
+	EXPECT_EQ(0, PoissonTable(2.0)(0.0));
+	EXPECT_EQ(0, PoissonTable(0.0)(0.99));
+	EXPECT_LT(PoissonTable(1000.0).size(), 1000u);
+}
+
+// ------------------------ Stimulus Tests--------------------------------
+
+// Test the rates of the time courses, and that they are read from their descriptions
+TEST(Stimulus_Test, time_courses) {
+	Stimulus const step(Stimulus::step(100, 200, 4));
+	EXPECT_EQ(2.0, step.ratio(99.9, 2.0));
+	EXPECT_EQ(4.0, step.ratio(100.0, 2.0));
+	EXPECT_EQ(2.0, step.ratio(200.0, 2.0));
+	Stimulus const ramp(Stimulus::parse("ramp,0,100,4"));
+	EXPECT_DOUBLE_EQ(3.0, ramp.ratio(50.0, 2.0));
+	EXPECT_EQ(4.0, ramp.ratio(150.0, 2.0));
+	Stimulus const sine(Stimulus::parse("sine,3,10"));
+	EXPECT_NEAR(5.0, sine.ratio(25.0, 2.0), 1e-12);
+	EXPECT_EQ(0.0, sine.ratio(75.0, 2.0));
+	Stimulus const series(Stimulus::series({10, 20}, {1, 3}));
+	EXPECT_EQ(2.0, series.ratio(5.0, 2.0));
+	EXPECT_EQ(1.0, series.ratio(19.9, 2.0));
+	EXPECT_EQ(3.0, series.ratio(1000.0, 2.0));
+
+	std::ofstream("stimulus_test.txt") << "0 1\n50.5 2.5\n";
+	EXPECT_EQ(2.5, Stimulus::parse("file,stimulus_test.txt").ratio(60.0, 2.0));
+	std::ofstream("stimulus_test.txt") << "0 1\n50 x\n";
+	EXPECT_THROW(Stimulus::parse("file,stimulus_test.txt"), std::runtime_error);
+	std::remove("stimulus_test.txt");
+	EXPECT_THROW(Stimulus::parse("step,100,50,4"), std::runtime_error);
+	EXPECT_THROW(Stimulus::parse("step,100,200"), std::runtime_error);
+	EXPECT_THROW(Stimulus::parse("pulse,1,2,3"), std::runtime_error);
+	EXPECT_THROW(Stimulus::series({20, 10}, {1, 3}), std::runtime_error);
+}
+
+// Test that the neurons follow the last stimulus covering them, and that a table is built per distinct rate
+TEST(Stimulus_Test, external_drive) {
+	std::vector<Population> const populations {Population{"first", 0, 10}, Population{"second", 10, 20}};
+	ExternalDrive drive(2.0, 0.5, 0.1, 20);
+	add_stimuli(drive, "second:step,10,20,4;15-16:ramp,0,10,0", populations, 20);
+	EXPECT_THROW(add_stimuli(drive, "20:step,10,20,4", populations, 20), std::runtime_error);
+	EXPECT_THROW(add_stimuli(drive, "third:step,10,20,4", populations, 20), std::runtime_error);
+
+	for (int t(0); t < 300; ++t) {
+		drive.prepare(t, true);
+		double const time(t * 0.1);
+		EXPECT_EQ(1.0, drive.mean(0));
+		EXPECT_EQ(time >= 10 and time < 20 ? 2.0 : 1.0, drive.mean(10));
+		EXPECT_DOUBLE_EQ(time >= 10 ? 0.0 : 1.0 - time / 10, drive.mean(15));
+		// the tables are rounded to MEAN_RESOLUTION times the mean per ratio, 0.5
+		EXPECT_NEAR(drive.mean(10), drive.table(10).mean(), 0.5 * MEAN_RESOLUTION * 0.5);
+		EXPECT_NEAR(drive.mean(15), drive.table(16).mean(), 0.5 * MEAN_RESOLUTION * 0.5);
+	}
+	// 1 for the constant rate and the ramp at 0 ms, 2 for the step, 99 more values of the ramp then 0
+	EXPECT_EQ(1 + 1 + 99 + 1, drive.tables_built());
+	drive.prepare(0, true);
+	EXPECT_EQ(102, drive.tables_built());
+	
+	// a sine wave of amplitude 1 around 2 at 10 Hz, over 5 periods: at most one table per rounded rate between
+	// 1 and 3, all of them built in the first period
+	ExternalDrive sine(2.0, 0.5, 0.1, 1);
+	add_stimuli(sine, "sine,1,10", populations, 1);
+	for (int t(0); t < 1000; ++t) {
+		sine.prepare(t, true);
+	}
+	long const first_period(sine.tables_built());
+	EXPECT_LE(first_period, 1 + 2.0 / MEAN_RESOLUTION + 1);
+	for (int t(1000); t < 5000; ++t) {
+		sine.prepare(t, true);
+	}
+	EXPECT_EQ(first_period, sine.tables_built());
+}
+
+// ------------------------ MeanField Tests--------------------------------
+
+// Test the stationary states of the network of the README (Brunel 2000, figure 8)
+TEST(MeanField_Test, stationary_states) {
+	// inhibition dominated: a single stable asynchronous irregular state, driven by the fluctuations
+	MeanField const irregular(5.0, 0.1, 2.0, 12500);
+	std::vector<MeanFieldState> states(irregular.solve());
+	ASSERT_EQ(1u, states.size());
+	EXPECT_TRUE(states[0].stable);
+	EXPECT_NEAR(states[0].rate, irregular.transfer(states[0].rate), 1e-6);
+	EXPECT_NEAR(38.0, states[0].rate, 1.0);
+	EXPECT_LT(0.5, states[0].cv);
+	EXPECT_GT(1.0, states[0].cv);
+	
+	// excitation dominated: close to saturation and regular
+	states = MeanField(3.0, 0.1, 2.0, 12500).solve();
+	ASSERT_FALSE(states.empty());
+	EXPECT_LT(300.0, states.back().rate);
+	EXPECT_GT(0.2, states.back().cv);
+	EXPECT_LT(THRESHOLD_POTENTIAL, states.back().mean_input);
+	
+	// more background input, more activity
+	EXPECT_LT(irregular.transfer(10.0), MeanField(5.0, 0.1, 3.0, 12500).transfer(10.0));
+	EXPECT_THROW(MeanField(5.0, 0.0, 2.0, 12500), std::runtime_error);
+}
+
+// ------------------------ ActivityMonitor Tests--------------------------------
+
+// Test the detection of quiescent, saturated and stationary activity, from spike counts of 1000 neurons every 0.1 ms
+TEST(ActivityMonitor_Test, status) {
+	// no spike at all: quiescent after the grace period and one window
+	ActivityMonitor quiescent(1000, 0.1, 0.02);
+	while (quiescent.status() == ActivityStatus::running) {
+		quiescent.record(0);
+	}
+	EXPECT_EQ(ActivityStatus::quiescent, quiescent.status());
+	EXPECT_NEAR(MONITOR_GRACE_PERIOD + MONITOR_WINDOW, quiescent.time(), 1e-6);
+	
+	// every neuron spiking every refractory period
+	ActivityMonitor saturated(1000, 0.1, 0.02);
+	for (int t(0); t < 10000 and saturated.status() == ActivityStatus::running; ++t) {
+		saturated.record(t % static_cast<int>(REFRACTORY_PERIOD) == 0 ? 1000 : 0);
+	}
+	EXPECT_EQ(ActivityStatus::saturated, saturated.status());
+	EXPECT_NEAR(MONITOR_GRACE_PERIOD + MONITOR_WINDOW, saturated.time(), 1e-6);
+	
+	// 10 Hz with alternating windows of 9 and 11 Hz: stationary once the standard error is 2% of the mean
+	ActivityMonitor stationary(1000, 0.1, 0.02);
+	int const window_steps(MONITOR_WINDOW / 0.1);
+	for (int t(0); t < 100000 and stationary.status() == ActivityStatus::running; ++t) {
+		stationary.record((t / window_steps) % 2 == 0 ? (t % 10 < 9 ? 1 : 0) : (t % 10 == 0 ? 2 : 1));
+	}
+	EXPECT_EQ(ActivityStatus::stationary, stationary.status());
+	EXPECT_NEAR(10.0, stationary.mean_rate(), 1e-6);
+	// the standard error of n windows is 1 / sqrt(n) Hz, which reaches 0.2 Hz with 25 windows
+	EXPECT_NEAR(MONITOR_BURN_IN + 26 * MONITOR_WINDOW, stationary.time(), 1e-6);
+	
+	// the status doesn't change anymore
+	stationary.record(0);
+	EXPECT_EQ(ActivityStatus::stationary, stationary.status());
+	EXPECT_STREQ("stationary", to_string(stationary.status()));
+	
+	// a rate rising steadily by 0.2 Hz per window from 10 Hz, over 50 windows: its standard error is below 2% of
+	// the mean after 4 windows, but the second half of the windows stays above the first one, it doesn't converge
+	ActivityMonitor drifting(1000, 0.1, 0.02);
+	int const burn_in_windows(MONITOR_BURN_IN / MONITOR_WINDOW);
+	for (int t(0); t < (burn_in_windows + 50) * window_steps; ++t) {
+		// in the window k after the burn-in, a spike every step and a second one in 10 k steps
+		int const window(std::max(0, t / window_steps - burn_in_windows));
+		drifting.record(t % window_steps < 10 * window ? 2 : 1);
+	}
+	EXPECT_EQ(ActivityStatus::running, drifting.status());
+	EXPECT_NEAR(10.0 + 0.2 * 24.5, drifting.mean_rate(), 1e-6);
+}
+
+// ------------------------ SpikeStatistics Tests--------------------------------
+
+// Test the statistics of two synchronous regular neurons and a silent one, over 105 steps of 1 ms
+TEST(SpikeStatistics_Test, summary) {
+	SpikeStatistics statistics(1.0, 10.0, 1.0);
+	statistics.start(3);
+	for (int t(0); t < 105; ++t) {
+		if (t % 5 == 0) {
+			statistics.record_spike(0, t);
+			statistics.record_spike(2, t);
+		}
+		statistics.record_step(t % 5 == 0 ? 2 : 0);
+	}
+	
+	SpikeSummary const summary(statistics.summarize());
+	EXPECT_EQ(3u, summary.neurons);
+	EXPECT_DOUBLE_EQ(105.0, summary.duration);
+	EXPECT_EQ(42, summary.spikes);
+	EXPECT_DOUBLE_EQ(2 * 21 * 1000.0 / 105 / 3, summary.mean_rate);
+	EXPECT_DOUBLE_EQ(1.0 / 3, summary.silent_fraction);
+	EXPECT_DOUBLE_EQ(0.0, summary.mean_cv);
+	// 2 spikes in each of the 10 complete windows, the spike at 100 ms is in the incomplete one
+	EXPECT_DOUBLE_EQ(0.0, summary.mean_fano);
+	// chi^2 = Var(P) / (N sum Var(n_i)) = 4 * 0.16 / (3 * 2 * 0.16)
+	EXPECT_NEAR(std::sqrt(2.0 / 3), summary.synchrony, 1e-12);
+	EXPECT_NEAR(2 * 0.2 * 1000.0 / 3, summary.population_rate, 1e-9);
+	
+	EXPECT_THROW(SpikeStatistics(0.1, 0.01, 1.0), std::runtime_error);
+}
+
+// Test the spectrum of the population rate
+TEST(PopulationSpectrum_Test, sine_peak) {
+	// the FFT against the DFT
+	std::vector<std::complex<double> > data {1.0, -2.0, 0.5, 3.0, 0.0, 1.5, -1.0, 2.0}, twiddles(4);
+	for (unsigned int k(0); k < 4; ++k) {
+		twiddles[k] = std::polar(1.0, -2.0 * 3.141592653589793 * k / 8);
+	}
+	std::vector<std::complex<double> > transform(data);
+	fft(transform, twiddles);
+	for (unsigned int k(0); k < 8; ++k) {
+		std::complex<double> sum(0.0);
+		for (unsigned int i(0); i < 8; ++i) {
+			sum += data[i] * std::polar(1.0, -2.0 * 3.141592653589793 * k * i / 8);
+		}
+		EXPECT_NEAR(sum.real(), transform[k].real(), 1e-12);
+		EXPECT_NEAR(sum.imag(), transform[k].imag(), 1e-12);
+	}
+	
+	// 1000 neurons, steps of 1 ms: a rate of 100 + 50 sin(2 pi 250 Hz t), whose variance is 1250 Hz^2
+	PopulationSpectrum spectrum(1000, 1.0, 256), constant(1000, 1.0, 256);
+	int const counts[4] = {100, 150, 100, 50};
+	for (int t(0); t < 1024; ++t) {
+		spectrum.record(counts[t % 4]);
+		constant.record(100);
+	}
+	
+	SpectrumSummary const summary(spectrum.summarize());
+	EXPECT_EQ(7u, summary.segments);
+	EXPECT_DOUBLE_EQ(1000.0 / 256, summary.resolution);
+	EXPECT_DOUBLE_EQ(250.0, summary.peak_frequency);
+	EXPECT_NEAR(1250.0, summary.total_power, 25.0);
+	EXPECT_DOUBLE_EQ(100.0, summary.mean_rate);
+	EXPECT_DOUBLE_EQ(0.2, summary.poisson_power);
+	EXPECT_NEAR(0.0, constant.summarize().total_power, 1e-9);
+	
+	EXPECT_EQ(0u, PopulationSpectrum(1000, 1.0, 256).summarize().segments);
+	EXPECT_THROW(PopulationSpectrum(1000, 1.0, 1000), std::runtime_error);
+}
+
+// Test the chunks of the spike store and the range queries
+TEST(SpikeStore_Test, range_query) {
+	std::string const file_name("test_spikes.bin");
+	{
+		// chunks of 10 steps of 0.1 ms, the chunks 2 and 4 to 9 are empty
+		SpikeStoreWriter writer(file_name, 100, 0.1, 1.0);
+		for (int step(0); step < 120; ++step) {
+			if (step / 10 == 2 or (step / 10 >= 4 and step / 10 < 10)) {
+				continue;
+			}
+			writer.record(step % 7, step);
+			writer.record(50 + step % 7, step);
+		}
+		writer.close();
+		EXPECT_EQ(5u, writer.chunks());
+		EXPECT_EQ(100u, writer.spikes());
+	}
+	
+	SpikeStoreReader const reader(file_name);
+	EXPECT_EQ(100u, reader.number_of_neurons());
+	EXPECT_DOUBLE_EQ(0.1, reader.time_step());
+	EXPECT_EQ(10, reader.chunk_steps());
+	EXPECT_EQ(5u, reader.chunks());
+	
+	// [0.5 ms, 3.5 ms): steps 5 to 19 and 30 to 34
+	std::vector<SpikeEvent> const all(reader.read(0.5, 3.5, std::vector<unsigned int>()));
+	ASSERT_EQ(40u, all.size());
+	EXPECT_EQ(5, all.front().step);
+	EXPECT_EQ(5u, all.front().neuron);
+	EXPECT_EQ(34, all.back().step);
+	EXPECT_EQ(56u, all.back().neuron);
+	for (size_t i(1); i < all.size(); ++i) {
+		EXPECT_LE(all[i - 1].step, all[i].step);
+	}
+	
+	std::vector<SpikeEvent> const subset(reader.read_steps(0, 1000, std::vector<unsigned int> {3, 53}));
+	ASSERT_EQ(16u, subset.size());
+	for (auto const& spike : subset) {
+		EXPECT_EQ(3, spike.step % 7);
+	}
+	EXPECT_TRUE(reader.read_steps(40, 100, std::vector<unsigned int>()).empty());
+	EXPECT_TRUE(reader.read_steps(200, 300, std::vector<unsigned int>()).empty());
+	
+	std::ofstream truncated(file_name, std::ofstream::out | std::ofstream::app);
+	truncated << "0";
+	truncated.close();
+	EXPECT_THROW(SpikeStoreReader("test_spikes.bin"), std::runtime_error);
+	std::remove(file_name.c_str());
+	EXPECT_THROW(SpikeStoreReader("test_spikes.bin"), std::runtime_error);
+}
+
+// Test the headers and the packing of the .npy arrays
+TEST(NpyExport_Test, arrays) {
+	{
+		NpyRecording recording("test_", 10);
+		for (int t(0); t < 3; ++t) {
+			recording.record_sum(1000 + t);
+			for (unsigned int i(0); i < 10; ++i) {
+				// neurons 0 and 9 spike at t = 1
+				recording.record_observed(t == 1 and (i == 0 or i == 9));
+			}
+		}
+		recording.record_spike(12499, 2);
+		recording.close();
+		EXPECT_EQ(3u, recording.sums().rows());
+		EXPECT_EQ(3u, recording.observed().rows());
+		EXPECT_EQ(1u, recording.raster().rows());
+	}
+	
+	auto const read = [](std::string const& file_name) {
+		std::ifstream file(file_name, std::ifstream::binary);
+		std::string const content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		std::remove(file_name.c_str());
+		return content;
+	};
+	std::string const sums(read("test_sum_spikes.npy")), observed(read("test_spikes.npy")), raster(read("test_raster.npy"));
+	
+	ASSERT_EQ(NPY_HEADER_SIZE + 3 * 4, sums.size());
+	EXPECT_EQ("\x93NUMPY", sums.substr(0, 6));
+	EXPECT_EQ(NPY_HEADER_SIZE - 10, static_cast<unsigned char>(sums[8]) + 256 * static_cast<unsigned char>(sums[9]));
+	EXPECT_NE(std::string::npos, sums.find("{'descr': '<u4', 'fortran_order': False, 'shape': (3,), }"));
+	EXPECT_EQ('\n', sums[NPY_HEADER_SIZE - 1]);
+	std::uint32_t last_sum;
+	std::memcpy(&last_sum, sums.data() + NPY_HEADER_SIZE + 8, 4);
+	EXPECT_EQ(1002u, last_sum);
+	
+	// 10 bits in 2 bytes per row, the first neuron in the most significant bit
+	ASSERT_EQ(NPY_HEADER_SIZE + 3 * 2, observed.size());
+	EXPECT_NE(std::string::npos, observed.find("'descr': '|u1'"));
+	EXPECT_NE(std::string::npos, observed.find("'shape': (3, 2)"));
+	EXPECT_EQ(0, observed[NPY_HEADER_SIZE]);
+	EXPECT_EQ(0x80, static_cast<unsigned char>(observed[NPY_HEADER_SIZE + 2]));
+	EXPECT_EQ(0x40, static_cast<unsigned char>(observed[NPY_HEADER_SIZE + 3]));
+	
+	ASSERT_EQ(NPY_HEADER_SIZE + 8, raster.size());
+	EXPECT_NE(std::string::npos, raster.find("'descr': '<i4', 'fortran_order': False, 'shape': (1, 2)"));
+	std::int32_t spike[2];
+	std::memcpy(spike, raster.data() + NPY_HEADER_SIZE, 8);
+	EXPECT_EQ(12499, spike[0]);
+	EXPECT_EQ(2, spike[1]);
+}
+
+// Test the time window, the subsampling and the neurons of the recordings
+TEST(RecordingPolicy_Test, actions) {
+	RecordingPolicy const everything;
+	EXPECT_EQ(RecordingAction::write, everything.action(12345));
+	EXPECT_TRUE(everything.records_spike(12499, 0));
+	
+	// bins of 5 steps of 0.1 ms from 1 ms to 3 ms
+	RecordingPolicy const binned(0.1, 1.0, 3.0, 1, 5);
+	EXPECT_EQ(RecordingAction::skip, binned.action(9));
+	EXPECT_EQ(RecordingAction::accumulate, binned.action(10));
+	EXPECT_EQ(RecordingAction::accumulate, binned.action(13));
+	EXPECT_EQ(RecordingAction::write, binned.action(14));
+	EXPECT_EQ(RecordingAction::write, binned.action(29));
+	EXPECT_EQ(RecordingAction::skip, binned.action(30));
+	EXPECT_FALSE(binned.records_spike(0, 30));
+	EXPECT_TRUE(binned.records_spike(0, 10));
+	
+	// the incomplete last bin isn't written
+	RecordingPolicy const incomplete(1.0, 0.0, 10.0, 1, 4);
+	int writes(0);
+	for (int step(0); step < 20; ++step) {
+		writes += incomplete.action(step) == RecordingAction::write;
+	}
+	EXPECT_EQ(2, writes);
+	
+	RecordingPolicy const every(1.0, 0.0, 10.0, 3, 1);
+	EXPECT_EQ(RecordingAction::write, every.action(0));
+	EXPECT_EQ(RecordingAction::skip, every.action(1));
+	EXPECT_EQ(RecordingAction::write, every.action(9));
+	
+	RecordingPolicy listed;
+	listed.set_neurons(parse_neuron_list("7,3-5,4", 100), 100);
+	EXPECT_EQ(std::vector<unsigned int>({3, 4, 5, 7}), listed.neurons());
+	EXPECT_TRUE(listed.records_spike(5, 0));
+	EXPECT_FALSE(listed.records_spike(6, 0));
+	EXPECT_THROW(listed.set_neurons(std::vector<unsigned int> {100}, 100), std::runtime_error);
+	
+	RecordingPolicy fraction;
+	fraction.set_fraction(0.1, 10000, 1);
+	int recorded(0);
+	for (unsigned int neuron(0); neuron < 10000; ++neuron) {
+		recorded += fraction.records_spike(neuron, 0);
+	}
+	EXPECT_NEAR(1000, recorded, 100);
+	EXPECT_TRUE(fraction.neurons().empty());
+	
+	EXPECT_THROW(parse_neuron_list("1,,2", 100), std::runtime_error);
+	EXPECT_THROW(parse_neuron_list("5-3", 100), std::runtime_error);
+	EXPECT_THROW(parse_neuron_list("99-100", 100), std::runtime_error);
+	// thrown at once, without expanding the range
+	EXPECT_THROW(parse_neuron_list("0-4000000000", 100), std::runtime_error);
+	EXPECT_EQ(std::vector<unsigned int>({98, 99}), parse_neuron_list("98-99", 100));
+	EXPECT_THROW(RecordingPolicy(0.1, 0.0, 100.0, 2, 2), std::runtime_error);
+	EXPECT_THROW(RecordingPolicy(0.1, 10.0, 10.0, 1, 1), std::runtime_error);
+}
+
+// Test the rows of the multimeter
+TEST(Multimeter_Test, sample) {
+	std::vector<Neuron*> neurons;
+	for (int i(0); i < 4; ++i) {
+		neurons.push_back(new Neuron(Cortex::get_excitatory_amplitude(), std::vector<short unsigned int>(), true));
+		neurons.back()->sum_input(0.5 * i);
+		neurons.back()->reset_input();
+		neurons.back()->update(0);
+	}
+	{
+		Multimeter multimeter("test_multimeter.npy", std::vector<unsigned int> {3, 1, 3}, 0.1, 0.5);
+		EXPECT_EQ(std::vector<unsigned int>({1, 3}), multimeter.neurons());
+		for (int step(0); step < 12; ++step) {
+			if (multimeter.samples(step)) {
+				multimeter.sample(step, neurons);
+			}
+		}
+		multimeter.close();
+		EXPECT_EQ(3u, multimeter.rows());
+	}
+	
+	std::ifstream file("test_multimeter.npy", std::ifstream::binary);
+	std::string const content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	std::remove("test_multimeter.npy");
+	ASSERT_EQ(NPY_HEADER_SIZE + 3 * 5 * sizeof(float), content.size());
+	EXPECT_NE(std::string::npos, content.find("'descr': '<f4', 'fortran_order': False, 'shape': (3, 5)"));
+	float row[5];
+	std::memcpy(row, content.data() + NPY_HEADER_SIZE + 2 * sizeof(row), sizeof(row));
+	EXPECT_FLOAT_EQ(1.0, row[0]);
+	EXPECT_FLOAT_EQ(neurons[1]->get_potential(), row[1]);
+	EXPECT_FLOAT_EQ(neurons[3]->get_potential(), row[2]);
+	EXPECT_FLOAT_EQ(0.5, row[3]);
+	EXPECT_FLOAT_EQ(1.5, row[4]);
+	
+	for (auto neuron : neurons) {
+		delete neuron;
+	}
+	EXPECT_THROW(Multimeter("test_multimeter.npy", std::vector<unsigned int>(), 0.1, 1.0), std::runtime_error);
+	EXPECT_THROW(Multimeter("test_multimeter.npy", std::vector<unsigned int> {1}, 0.1, 0.01), std::runtime_error);
+}
+
+// Test the samples of the telemetry ring
+TEST(Telemetry_Test, ring) {
+	std::string const name(telemetry_segment(getpid()) + "_test");
+	TelemetryWriter writer(name, 100, 0.1, std::vector<Population> {Population{"inhibitory", 0, 20}, Population{"excitatory", 20, 100}}, 8);
+	TelemetryReader reader(name);
+	EXPECT_EQ(100u, reader.number_of_neurons());
+	EXPECT_DOUBLE_EQ(0.1, reader.time_step());
+	EXPECT_EQ(8u, reader.capacity());
+	
+	std::vector<TelemetrySample> samples;
+	EXPECT_EQ(0u, reader.read(0, samples));
+	EXPECT_EQ(2u, reader.populations());
+	EXPECT_EQ("excitatory", reader.population_name(1));
+	for (int step(0); step < 5; ++step) {
+		writer.publish(step, step, std::vector<unsigned int> {1, static_cast<unsigned int>(step)});
+	}
+	std::uint64_t next(reader.read(0, samples));
+	EXPECT_EQ(5u, next);
+	ASSERT_EQ(5u, samples.size());
+	EXPECT_EQ(3, samples[3].step);
+	EXPECT_DOUBLE_EQ(0.3, samples[3].time);
+	// 3 spikes of 100 neurons in 0.1 ms
+	EXPECT_DOUBLE_EQ(300.0, samples[3].rate);
+	EXPECT_DOUBLE_EQ(500.0, samples[3].population_rates[0]);
+	EXPECT_DOUBLE_EQ(375.0, samples[3].population_rates[1]);
+	EXPECT_GE(samples[4].elapsed, samples[0].elapsed);
+	
+	// the ring wraps, the oldest samples are lost, and the oldest left may be overwritten next
+	for (int step(5); step < 20; ++step) {
+		writer.publish(step, 0, std::vector<unsigned int> {0, 0});
+	}
+	samples.clear();
+	EXPECT_EQ(20u, reader.read(next, samples));
+	ASSERT_EQ(7u, samples.size());
+	EXPECT_EQ(13, samples.front().step);
+	EXPECT_EQ(19, samples.back().step);
+	EXPECT_FALSE(reader.finished());
+	writer.finish();
+	EXPECT_TRUE(reader.finished());
+	
+	EXPECT_THROW(TelemetryReader("/neurosim_telemetry_none"), std::runtime_error);
+	EXPECT_THROW(TelemetryWriter(name + "_empty", 100, 0.1, std::vector<Population>(), 0), std::runtime_error);
+}
+
+// Test the pixels of the raster plot, streamed from a spike store, and its PNG
+TEST(RasterPlot_Test, pixels) {
+	{
+		SpikeStoreWriter store("test_raster.bin", 12, 0.1, 1.0);
+		store.record(0, 0);
+		store.record(10, 0);
+		store.record(3, 50);
+		store.record(3, 50);
+		store.record(9, 99);
+		store.record(0, 100);
+		store.close();
+	}
+	SpikeStoreReader const store("test_raster.bin");
+	EXPECT_EQ(110, store.end_step());
+	
+	// 10 time steps and 2 neurons per pixel, neuron 10 and step 100 left out
+	RasterPlot plot(0, 100, 0, 10, 10, 5);
+	store.for_each_chunk(0, 100, [&plot](SpikeEvent const* begin, SpikeEvent const* end) { plot.add(begin, end); });
+	std::remove("test_raster.bin");
+	EXPECT_EQ(4u, plot.spikes());
+	EXPECT_EQ(1u, plot.count(0, 0));
+	EXPECT_EQ(2u, plot.count(5, 1));
+	EXPECT_EQ(1u, plot.count(9, 4));
+	EXPECT_EQ(2u, plot.column_spikes(5));
+	// 2 spikes of 10 neurons in 10 steps of 0.1 ms
+	EXPECT_DOUBLE_EQ(200.0, plot.column_rate(5, 0.1));
+	
+	// signature, header, a single stored block of 10 rows of 11 bytes, the end
+	plot.write("test_raster.png", 0.1, 4);
+	std::ifstream file("test_raster.png", std::ifstream::binary);
+	std::string const png((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	std::remove("test_raster.png");
+	ASSERT_EQ(178u, png.size());
+	EXPECT_EQ("\x89PNG", png.substr(0, 4));
+	auto const pixel = [&png](unsigned int row, unsigned int x) { return static_cast<unsigned char>(png[48 + row * 11 + 1 + x]); };
+	// the first neurons at the bottom, the fullest pixel black, a single spike lighter
+	EXPECT_EQ(0, pixel(3, 5));
+	EXPECT_EQ(61, pixel(4, 0));
+	EXPECT_EQ(255, pixel(4, 1));
+	// the line, then the rates, the highest one filling the plot and half of it
+	EXPECT_EQ(0, pixel(5, 3));
+	EXPECT_EQ(0, pixel(6, 5));
+	EXPECT_EQ(255, pixel(7, 0));
+	EXPECT_EQ(0, pixel(8, 0));
+	
+	EXPECT_THROW(plot.write("test_raster.jpg", 0.1), std::runtime_error);
+	EXPECT_THROW(RasterPlot(100, 100, 0, 10), std::runtime_error);
+	EXPECT_THROW(RasterPlot(0, 100, 0, 10, 0, 5), std::runtime_error);
+}
+
+// Test the rows of the legacy text files and of the .npy arrays
+TEST(RecordingReader_Test, rows) {
+	{
+		std::ofstream sums("test_sum_spikes.txt");
+		sums << "12 3 9\n\n7 0 7\r\n40 10 30";
+	}
+	std::unique_ptr<RecordingReader> text(open_recording("test_sum_spikes.txt"));
+	std::vector<std::vector<long>> rows(text->begin(), text->end());
+	ASSERT_EQ(3u, rows.size());
+	EXPECT_EQ(std::vector<long>({7, 0, 7}), rows[1]);
+	EXPECT_EQ(std::vector<long>({40, 10, 30}), rows[2]);
+	EXPECT_EQ(3u, text->columns());
+	EXPECT_FALSE(text->next());
+	
+	{
+		std::ofstream sums("test_sum_spikes.txt");
+		sums << "1 2\n3 x\n";
+	}
+	TextRecordingReader malformed("test_sum_spikes.txt");
+	EXPECT_TRUE(malformed.next());
+	EXPECT_THROW(malformed.next(), std::runtime_error);
+	{
+		std::ofstream sums("test_sum_spikes.txt");
+		sums << "1 2\n3\n";
+	}
+	TextRecordingReader ragged("test_sum_spikes.txt");
+	EXPECT_TRUE(ragged.next());
+	EXPECT_THROW(ragged.next(), std::runtime_error);
+	std::remove("test_sum_spikes.txt");
+	
+	{
+		NpyRecording recording("test_", 10, 2);
+		recording.record_sum(12, std::vector<long> {3, 9});
+		recording.record_sum(7, std::vector<long> {0, 7});
+		for (unsigned int neuron(0); neuron < 10; ++neuron) {
+			recording.record_observed(neuron == 0 or neuron == 9);
+		}
+		recording.record_spike(4, 17);
+		recording.close();
+	}
+	NpyRecordingReader sums("test_sum_spikes.npy");
+	EXPECT_EQ(2u, sums.rows());
+	EXPECT_EQ(3u, sums.columns());
+	ASSERT_TRUE(sums.next());
+	EXPECT_EQ(std::vector<long>({12, 3, 9}), sums.row());
+	
+	// the bits of the observed neurons unpacked, or their two bytes
+	std::unique_ptr<RecordingReader> observed(open_recording("test_spikes.npy", 10));
+	ASSERT_TRUE(observed->next());
+	EXPECT_EQ(std::vector<long>({1, 0, 0, 0, 0, 0, 0, 0, 0, 1}), observed->row());
+	NpyRecordingReader bytes("test_spikes.npy");
+	ASSERT_TRUE(bytes.next());
+	EXPECT_EQ(std::vector<long>({0x80, 0x40}), bytes.row());
+	EXPECT_THROW(NpyRecordingReader("test_spikes.npy", 17), std::runtime_error);
+	
+	NpyRecordingReader raster("test_raster.npy");
+	std::vector<std::vector<long>> spikes(raster.begin(), raster.end());
+	ASSERT_EQ(1u, spikes.size());
+	EXPECT_EQ(std::vector<long>({4, 17}), spikes[0]);
+	EXPECT_THROW(NpyRecordingReader("test_sum_spikes.txt"), std::runtime_error);
+	std::remove("test_sum_spikes.npy");
+	std::remove("test_spikes.npy");
+	std::remove("test_raster.npy");
+}
+
+// Test the flags which only make sense in a single process
+TEST(Cortex_Test, single_rank_records) {
+	double timestep(DEFAULT_TIME_STEP), predicted_rate(-1);
+	// each rank only knows the spikes of its own neurons, the records of all neurons are rejected before any rank is launched
+	char const* spike_store[] = {"NeuronSimulation", "-r", "1", "-n", "2", "--Spike_store", "1"};
+	EXPECT_FALSE(initialize_cortex(7, const_cast<char**>(spike_store), timestep, 100, predicted_rate, false));
+	char const* npy[] = {"NeuronSimulation", "-r", "1", "--Ranks", "3", "--Npy", "1"};
+	EXPECT_FALSE(initialize_cortex(7, const_cast<char**>(npy), timestep, 100, predicted_rate, false));
+	EXPECT_EQ(DEFAULT_TIME_STEP, timestep);
+}
+
+// Test the compile-time propagators and the models
+TEST(Neuron_Test, neuron_models) {
+	// the compile-time decays are the library's, to the last bit
+	EXPECT_EQ(std::exp(-DEFAULT_TIME_STEP / TAU), DefaultPropagators::membrane);
+	EXPECT_EQ(std::exp(-DEFAULT_TIME_STEP / DEFAULT_TAU_SYN), DefaultPropagators::current);
+	EXPECT_EQ(std::exp(-DEFAULT_TIME_STEP / ADAPTATION_TAU), DefaultPropagators::adaptation);
+	static_assert(DefaultPropagators::membrane < 1.0 and DefaultPropagators::current_to_potential > 0.0,
+				  "the propagators are compile-time constants");
+	
+	// the runtime propagators of the default time step are the compile-time ones
+	Neuron::set_model(NeuronModel::adaptive_lif, DEFAULT_TAU_SYN);
+	Neuron::set_time_step(DEFAULT_TIME_STEP);
+	EXPECT_TRUE(Neuron::has_default_propagators());
+	EXPECT_EQ(DefaultPropagators::membrane, RuntimePropagators::membrane);
+	EXPECT_EQ(DefaultPropagators::current, RuntimePropagators::current);
+	EXPECT_EQ(DefaultPropagators::adaptation, RuntimePropagators::adaptation);
+	EXPECT_EQ(DefaultPropagators::adaptation_to_potential, RuntimePropagators::adaptation_to_potential);
+	EXPECT_EQ(DefaultPropagators::current_to_potential, RuntimePropagators::current_to_potential);
+	
+	// each spike of an adaptive neuron increases its adaptation current, which lowers its potential
+	Neuron adaptive(Cortex::get_excitatory_amplitude(), std::vector<short unsigned int>(), true);
+	adaptive.sum_input(THRESHOLD_POTENTIAL);
+	adaptive.reset_input();
+	adaptive.update_with<AdaptiveLif<DefaultPropagators> >(100);
+	adaptive.update_with<AdaptiveLif<DefaultPropagators> >(101);
+	EXPECT_EQ(101, adaptive.get_last_spike());
+	EXPECT_DOUBLE_EQ(ADAPTATION_JUMP * DefaultPropagators::adaptation, adaptive.get_adaptation());
+	
+	for (int t(102); t < 101 + REFRACTORY_PERIOD; ++t) {
+		adaptive.update_with<AdaptiveLif<DefaultPropagators> >(t);
+	}
+	Neuron plain(adaptive);
+	plain.adaptation_ = 0.0;
+	adaptive.update_with<AdaptiveLif<DefaultPropagators> >(101 + REFRACTORY_PERIOD);
+	plain.update_with<LifDelta<DefaultPropagators> >(101 + REFRACTORY_PERIOD);
+	EXPECT_LT(adaptive.get_potential(), plain.get_potential());
+	
+	Neuron::set_model(NeuronModel::lif_delta, DEFAULT_TAU_SYN);
+	Neuron::set_time_step(Cortex::timestep_);
+}
+
+// Test a simulation driven through the C interface, last as it replaces the network of the other tests
+// Test that precise spike times keep the rate and the synchrony of the synchronous regime at a five times coarser time step
+TEST(Neurosim_Test, precise_coarse_step) {
+	constexpr double DURATION(150.0);
+	std::vector<SpikeSummary> summaries;
+	for (char const* time_step : {"0.1", "0.5"}) {
+		char const* flags[] = {"-g", "3", "-s", "3", "--Statistics", "1", "--Precise", "1", "--Time_step", time_step};
+		neurosim* simulation(neurosim_create());
+		ASSERT_NE(nullptr, simulation);
+		ASSERT_EQ(NEUROSIM_OK, neurosim_configure(simulation, 10, flags, DURATION)) << neurosim_last_error(simulation);
+		ASSERT_EQ(NEUROSIM_OK, neurosim_run_until(simulation, DURATION));
+		ASSERT_NE(nullptr, Cortex::get_statistics());
+		summaries.push_back(Cortex::get_statistics()->summarize());
+		neurosim_destroy(simulation);
+	}
+	// on the grid, the intervals between the spikes are whole steps: 0.5 ms gives 25% less than 0.1 ms
+	EXPECT_NEAR(summaries[0].mean_rate, summaries[1].mean_rate, 0.03 * summaries[0].mean_rate);
+	EXPECT_NEAR(summaries[0].synchrony, summaries[1].synchrony, 0.05);
+	EXPECT_LT(0.3, summaries[1].synchrony);
+}
+
+TEST(Neurosim_Test, c_interface) {
+	neurosim* simulation(neurosim_create());
+	ASSERT_NE(nullptr, simulation);
+	EXPECT_EQ(nullptr, neurosim_create());
+	EXPECT_EQ(NEUROSIM_API_VERSION, neurosim_api_version());
+	EXPECT_EQ(NEUROSIM_ERROR, neurosim_step(simulation));
+	char const* ranks[] = {"--Ranks", "2"};
+	EXPECT_EQ(NEUROSIM_ERROR, neurosim_configure(simulation, 2, ranks, 20.0));
+	char const* negative[] = {"-g", "-1"};
+	EXPECT_EQ(NEUROSIM_ERROR, neurosim_configure(simulation, 2, negative, 20.0));
+	EXPECT_NE(std::string(), neurosim_last_error(simulation));
+	// TCLAP would end the process on these
+	char const* unknown[] = {"--Bogus", "1"};
+	EXPECT_EQ(NEUROSIM_ERROR, neurosim_configure(simulation, 2, unknown, 20.0));
+	EXPECT_NE(std::string::npos, std::string(neurosim_last_error(simulation)).find("Bogus"));
+	char const* help[] = {"--help"};
+	EXPECT_EQ(NEUROSIM_ERROR, neurosim_configure(simulation, 1, help, 20.0));
+	char const* malformed[] = {"-t", "two"};
+	EXPECT_EQ(NEUROSIM_ERROR, neurosim_configure(simulation, 2, malformed, 20.0));
+	
+	char const* flags[] = {"--Deterministic", "1", "-t", "2"};
+	ASSERT_EQ(NEUROSIM_OK, neurosim_configure(simulation, 4, flags, 20.0)) << neurosim_last_error(simulation);
+	EXPECT_EQ(12500u, neurosim_number_of_neurons(simulation));
+	EXPECT_DOUBLE_EQ(0.1, neurosim_time_step(simulation));
+	
+	// the neurons which spike in each step, in their order, are counted in the spikes of the network once their spikes are sent
+	std::vector<size_t> spikes;
+	for (int step(0); step < 150; ++step) {
+		ASSERT_EQ(NEUROSIM_OK, neurosim_step(simulation));
+		uint32_t const* neurons(nullptr);
+		size_t count(0);
+		ASSERT_EQ(NEUROSIM_OK, neurosim_get_spikes(simulation, &neurons, &count));
+		EXPECT_TRUE(std::is_sorted(neurons, neurons + count));
+		spikes.push_back(count);
+	}
+	// a spike is sent in the step before it is received, the transmission delay after its neuron spiked
+	long const sent(std::accumulate(spikes.begin(), spikes.end() - (Neuron::get_delay_steps() - 1), 0l));
+	EXPECT_GT(sent, 0);
+	EXPECT_EQ(sent, neurosim_total_spikes(simulation));
+	EXPECT_EQ(NEUROSIM_OK, neurosim_run_until(simulation, 20.0));
+	EXPECT_EQ(200, neurosim_steps(simulation));
+	EXPECT_DOUBLE_EQ(20.0, neurosim_time(simulation));
+	neurosim_destroy(simulation);
+	
+	simulation = neurosim_create();
+	EXPECT_NE(nullptr, simulation);
+	neurosim_destroy(simulation);
+}
+
 int main(int argc, char **argv) { 
 	
 	unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
@@ -0,0 +1,101 @@
+/*! \file ConvertRecording.cpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Converts a legacy sum_spikes.txt or spikes.txt into the .npy array the simulation writes with --Npy 1.
+ *  \details The spike sums become a uint32 array, one element per row or one row of the sum and the sums of the
+ *  \details populations, and the observed neurons a uint8 array of rows of bits packed as numpy.packbits does, so
+ *  \details that archives of text recordings are mapped into memory by the analysis tools like the new ones. The
+ *  \details text is streamed through TextRecordingReader, parsed by hand. Exits with 0 on success, -1 on errors.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <tclap/CmdLine.h>
+#include "../src/NpyExport.hpp"
+#include "../src/RecordingReader.hpp"
+
+int main(int argc, char** argv)
+{
+	try {
+		TCLAP::CmdLine cmd("Converts a legacy sum_spikes.txt or spikes.txt into a .npy array");
+		TCLAP::ValueArg<std::string> inputArg("", "Input", "Text recording (default: sum_spikes.txt)", false, "sum_spikes.txt", "file");
+		cmd.add(inputArg);
+		TCLAP::ValueArg<std::string> outputArg("", "Output", "Array written (default: the input with the extension .npy)", false, "", "file");
+		cmd.add(outputArg);
+		TCLAP::ValueArg<std::string> kindArg("", "Kind", "sums or observed (default: observed for a file named spikes.txt, sums otherwise)", false, "", "string");
+		cmd.add(kindArg);
+		cmd.parse(argc, argv);
+
+		std::string const input(inputArg.getValue());
+		std::string output(outputArg.getValue());
+		if (output.empty()) {
+			size_t const dot(input.rfind('.'));
+			output = (dot == std::string::npos or input.find('/', dot) != std::string::npos ? input : input.substr(0, dot)) + ".npy";
+		}
+		std::string kind(kindArg.getValue());
+		if (kind.empty()) {
+			size_t const slash(input.rfind('/'));
+			kind = input.substr(slash == std::string::npos ? 0 : slash + 1) == "spikes.txt" ? "observed" : "sums";
+		}
+		if (kind != "sums" and kind != "observed") {
+			throw std::runtime_error("the kind " + kind + " is neither sums nor observed");
+		}
+		bool const observed(kind == "observed");
+
+		auto const start(std::chrono::steady_clock::now());
+		TextRecordingReader reader(input);
+		std::unique_ptr<NpyWriter> array;
+		std::vector<std::uint32_t> sums;
+		std::vector<std::uint8_t> bits;
+		for (auto const& row : reader) {
+			if (!array) {
+				// the number of columns is that of the first row, a single sum makes a one-dimensional array
+				if (observed) {
+					array.reset(new NpyWriter(output, "u1", sizeof(std::uint8_t), (row.size() + 7) / 8));
+					bits.resize((row.size() + 7) / 8);
+				} else {
+					array.reset(new NpyWriter(output, "u4", sizeof(std::uint32_t), row.size() > 1 ? row.size() : 0));
+					sums.resize(row.size());
+				}
+			}
+			if (observed) {
+				std::fill(bits.begin(), bits.end(), 0);
+				for (size_t neuron(0); neuron < row.size(); ++neuron) {
+					if (row[neuron] > 1) {
+						throw std::runtime_error("row " + std::to_string(reader.rows_read()) + " of " + input + " isn't a row of 0 and 1");
+					}
+					bits[neuron / 8] |= row[neuron] << (7 - neuron % 8);
+				}
+				array->append(bits.data());
+			} else {
+				for (size_t column(0); column < row.size(); ++column) {
+					if (row[column] > UINT32_MAX) {
+						throw std::runtime_error("row " + std::to_string(reader.rows_read()) + " of " + input + " has a sum beyond uint32");
+					}
+					sums[column] = row[column];
+				}
+				array->append(sums.data());
+			}
+		}
+		if (!array) {
+			array.reset(new NpyWriter(output, observed ? "u1" : "u4", observed ? sizeof(std::uint8_t) : sizeof(std::uint32_t), 0));
+		}
+		array->close();
+
+		std::cout << input << " -> " << output << ": " << reader.rows_read() << " rows of " << reader.columns() << " " << kind << ", in "
+				  << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+		return 0;
+	} catch (TCLAP::ArgException& e) {
+		std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+	} catch (std::exception const& error) {
+		std::cerr << error.what() << std::endl;
+	}
+	return -1;
+}
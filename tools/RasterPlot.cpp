@@ -0,0 +1,144 @@
+/*! \file RasterPlot.cpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Renders the raster and the population rate of a spike store or a recording to a PNG or an SVG.
+ *  \details The chunks of the time range are streamed once from the mapped file into the pixels of the plot, so
+ *  \details that a raster of hundreds of millions of spikes renders in seconds, in memory proportional to the size of
+ *  \details the image. The recordings raster.npy, spikes.npy and spikes.txt are streamed through open_recording(),
+ *  \details twice if their time steps or neurons aren't given, as they don't store them. Exits with 0 on success,
+ *  \details -1 on errors.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <tclap/CmdLine.h>
+#include "../src/NeuronModel.hpp"
+#include "../src/RasterPlot.hpp"
+#include "../src/RecordingReader.hpp"
+#include "../src/SpikeStore.hpp"
+
+namespace {
+
+bool ends_with(std::string const& text, std::string const& end)
+{
+	return text.size() >= end.size() and text.compare(text.size() - end.size(), end.size(), end) == 0;
+}
+
+/*! \brief Passes the (neuron, time step) of each spike of a recording to a function
+ *  \details raster.npy has a (neuron, time step) row per spike, spikes.npy and spikes.txt a row per time step with
+ *  \details a column per observed neuron, which is 1 when it spiked.
+ * \throw runtime_error if the file can't be read or only holds spike sums
+ */
+template <typename Function>
+void for_each_recorded_spike(std::string const& file_name, Function function)
+{
+	std::string const base(file_name.substr(file_name.find_last_of('/') + 1));
+	if (base.compare(0, 10, "sum_spikes") == 0) {
+		throw std::runtime_error(file_name + " only holds the spike sums, which make no raster");
+	}
+	std::unique_ptr<RecordingReader> reader(open_recording(file_name));
+	NpyRecordingReader const* const npy(dynamic_cast<NpyRecordingReader const*>(reader.get()));
+	bool const packed(npy != nullptr and npy->descr() == "|u1");
+	bool const pairs(npy != nullptr and !packed);
+	if (pairs and npy->columns() != 2) {
+		throw std::runtime_error(file_name + " holds neither (neuron, time step) rows nor the bits of the observed neurons");
+	}
+	if (packed) {
+		// the bits of the observed neurons are packed, unpack them all
+		reader = open_recording(file_name, 8 * npy->columns());
+	}
+
+	int step(0);
+	for (auto const& row : *reader) {
+		if (pairs) {
+			function(row[0], row[1]);
+			continue;
+		}
+		for (size_t neuron(0); neuron < row.size(); ++neuron) {
+			if (row[neuron] != 0) {
+				function(neuron, step);
+			}
+		}
+		++step;
+	}
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	try {
+		TCLAP::CmdLine cmd("Renders the raster and the population rate of a spike store or a recording to a PNG or an SVG");
+		TCLAP::ValueArg<std::string> fileArg("", "File", "Spike store, or raster.npy, spikes.npy or spikes.txt (default: spikes.bin)", false, "spikes.bin", "file");
+		cmd.add(fileArg);
+		TCLAP::ValueArg<std::string> outputArg("", "Output", "Image written, .png or .svg (default: raster.png)", false, "raster.png", "file");
+		cmd.add(outputArg);
+		TCLAP::ValueArg<double> fromArg("", "From", "Beginning of the range (default: 0 ms)", false, 0.0, "double");
+		cmd.add(fromArg);
+		TCLAP::ValueArg<double> toArg("", "To", "End of the range, excluded (default: the end of the store)", false, -1.0, "double");
+		cmd.add(toArg);
+		TCLAP::ValueArg<unsigned int> firstNeuronArg("", "First_neuron", "First neuron plotted (default: 0)", false, 0, "unsigned int");
+		cmd.add(firstNeuronArg);
+		TCLAP::ValueArg<unsigned int> endNeuronArg("", "End_neuron", "Neuron after the last one plotted (default: all of them)", false, 0, "unsigned int");
+		cmd.add(endNeuronArg);
+		TCLAP::ValueArg<unsigned int> widthArg("", "Width", "Width of the plots (default: 1600 pixels)", false, DEFAULT_PLOT_WIDTH, "unsigned int");
+		cmd.add(widthArg);
+		TCLAP::ValueArg<unsigned int> heightArg("", "Height", "Height of the raster (default: 800 pixels)", false, DEFAULT_PLOT_HEIGHT, "unsigned int");
+		cmd.add(heightArg);
+		TCLAP::ValueArg<unsigned int> rateHeightArg("", "Rate_height", "Height of the rate plot, none if 0 (default: 200 pixels)", false, DEFAULT_RATE_HEIGHT, "unsigned int");
+		cmd.add(rateHeightArg);
+		TCLAP::ValueArg<double> timeStepArg("", "Time_step", "Time step of a recording, which doesn't store it, unlike a spike store (default: 0.1 ms)", false, DEFAULT_TIME_STEP, "double");
+		cmd.add(timeStepArg);
+		cmd.parse(argc, argv);
+
+		auto const start(std::chrono::steady_clock::now());
+		std::string const& file(fileArg.getValue());
+		bool const is_store(!ends_with(file, ".npy") and !ends_with(file, ".txt"));
+		std::unique_ptr<SpikeStoreReader> store(is_store ? new SpikeStoreReader(file) : nullptr);
+		double const time_step(is_store ? store->time_step() : timeStepArg.getValue());
+		if (time_step <= 0.0) {
+			throw std::runtime_error("the time step has to be positive");
+		}
+
+		int const first_step(std::lround(fromArg.getValue() / time_step));
+		int end_step(toArg.getValue() < 0.0 ? 0 : std::lround(toArg.getValue() / time_step));
+		unsigned int end_neuron(endNeuronArg.getValue());
+		if (is_store) {
+			end_step = toArg.getValue() < 0.0 ? store->end_step() : end_step;
+			end_neuron = end_neuron > 0 ? end_neuron : store->number_of_neurons();
+		} else if (toArg.getValue() < 0.0 or end_neuron == 0) {
+			// a first pass finds the end of the recording and its last neuron
+			int last_step(-1);
+			long last_neuron(-1);
+			for_each_recorded_spike(file, [&last_step, &last_neuron](long neuron, long step) {
+				last_step = std::max(last_step, static_cast<int>(step));
+				last_neuron = std::max(last_neuron, neuron);
+			});
+			end_step = toArg.getValue() < 0.0 ? last_step + 1 : end_step;
+			end_neuron = end_neuron > 0 ? end_neuron : last_neuron + 1;
+		}
+
+		RasterPlot plot(first_step, end_step, firstNeuronArg.getValue(), end_neuron, widthArg.getValue(), heightArg.getValue());
+		if (is_store) {
+			store->for_each_chunk(first_step, end_step, [&plot](SpikeEvent const* begin, SpikeEvent const* end) { plot.add(begin, end); });
+		} else {
+			for_each_recorded_spike(file, [&plot](long neuron, long step) { plot.add(neuron, step); });
+		}
+		plot.write(outputArg.getValue(), time_step, rateHeightArg.getValue());
+
+		std::cout << outputArg.getValue() << ": " << plot.spikes() << " spikes from " << first_step * time_step << " to "
+				  << end_step * time_step << " ms, neurons " << firstNeuronArg.getValue() << " to " << end_neuron - 1 << ", in "
+				  << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+		return 0;
+	} catch (TCLAP::ArgException& e) {
+		std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+	} catch (std::exception const& error) {
+		std::cerr << error.what() << std::endl;
+	}
+	return -1;
+}
@@ -0,0 +1,51 @@
+/*! \file SpikeRange.cpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Prints the spikes of a time range of a spike store, one "time neuron" line per spike.
+ *  \details Only the chunks of the range are read from the file, so that a window of a long simulation
+ *  \details can be plotted without reading the rest, e.g. from MATLAB: [status, text] = system('./SpikeRange --From 500 --To 600'); data = str2num(text);
+ *  \details Exits with 0 on success, -1 on errors.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <tclap/CmdLine.h>
+#include "../src/SpikeStore.hpp"
+
+int main(int argc, char** argv)
+{
+	try {
+		TCLAP::CmdLine cmd("Prints the spikes of a time range of a spike store");
+		TCLAP::ValueArg<std::string> fileArg("", "File", "Spike store (default: spikes.bin)", false, "spikes.bin", "file");
+		cmd.add(fileArg);
+		TCLAP::ValueArg<double> fromArg("", "From", "Beginning of the range (default: 0 ms)", false, 0.0, "double");
+		cmd.add(fromArg);
+		TCLAP::ValueArg<double> toArg("", "To", "End of the range, excluded (default: 1000 ms)", false, 1000.0, "double");
+		cmd.add(toArg);
+		TCLAP::ValueArg<std::string> neuronsArg("", "Neurons", "Comma-separated neurons whose spikes are printed (default: all)", false, "", "list");
+		cmd.add(neuronsArg);
+		cmd.parse(argc, argv);
+
+		std::vector<unsigned int> neurons;
+		std::stringstream list(neuronsArg.getValue());
+		std::string neuron;
+		while (std::getline(list, neuron, ',')) {
+			neurons.push_back(std::stoul(neuron));
+		}
+
+		SpikeStoreReader const store(fileArg.getValue());
+		for (auto const& spike : store.read(fromArg.getValue(), toArg.getValue(), neurons)) {
+			std::cout << spike.step * store.time_step() << " " << spike.neuron << "\n";
+		}
+		return 0;
+	} catch (TCLAP::ArgException& e) {
+		std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+	} catch (std::exception const& error) {
+		std::cerr << error.what() << std::endl;
+	}
+	return -1;
+}
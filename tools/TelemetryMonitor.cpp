@@ -0,0 +1,108 @@
+/*! \file TelemetryMonitor.cpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Attaches to the telemetry ring of a running simulation and prints its progress.
+ *  \details Prints one "time rate steps_per_second" line per interval, followed by the rate of each population, the
+ *  \details rates averaged over the time steps simulated since the previous line, or with --Samples one line per
+ *  \details time step, e.g. to log it into a file.
+ *  \details The simulation is started with --Telemetry 1 and prints the name of its segment; the monitor finds it
+ *  \details from the number of the process, and waits for it to appear. Exits with 0 once the simulation is
+ *  \details finished, -1 on errors.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <tclap/CmdLine.h>
+#include "../src/Telemetry.hpp"
+
+int main(int argc, char** argv)
+{
+	try {
+		TCLAP::CmdLine cmd("Prints the progress of a simulation started with --Telemetry 1");
+		TCLAP::ValueArg<int> pidArg("", "Pid", "Number of the process of the simulation", true, 0, "int");
+		cmd.add(pidArg);
+		TCLAP::ValueArg<int> intervalArg("", "Interval", "Interval between two lines (default: 500 ms)", false, 500, "int");
+		cmd.add(intervalArg);
+		TCLAP::ValueArg<bool> samplesArg("", "Samples", "Prints every time step instead of one line per interval (default: false)", false, false, "bool");
+		cmd.add(samplesArg);
+		TCLAP::ValueArg<int> waitArg("", "Wait", "Time waited for the simulation to create its segment (default: 10 s)", false, 10, "int");
+		cmd.add(waitArg);
+		cmd.parse(argc, argv);
+
+		std::string const name(telemetry_segment(pidArg.getValue()));
+		auto const deadline(std::chrono::steady_clock::now() + std::chrono::seconds(waitArg.getValue()));
+		std::unique_ptr<TelemetryReader> ring;
+		while (!ring) {
+			try {
+				ring.reset(new TelemetryReader(name));
+			} catch (std::runtime_error const&) {
+				if (std::chrono::steady_clock::now() > deadline) {
+					throw;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			}
+		}
+
+		std::cout << "# " << name << ": " << ring->number_of_neurons() << " neurons, time step " << ring->time_step() << " ms" << std::endl;
+		std::cout << "# time [ms] rate [Hz] steps/s";
+		for (unsigned int population(0); population < ring->populations(); ++population) {
+			std::cout << " " << ring->population_name(population) << " [Hz]";
+		}
+		std::cout << std::endl;
+		std::uint64_t next(0), missed(0);
+		std::vector<TelemetrySample> samples;
+		bool finished(false);
+		while (!finished) {
+			// the samples written before the simulation was marked finished are the last ones
+			finished = ring->finished();
+			samples.clear();
+			std::uint64_t const written(ring->read(next, samples));
+			missed += written - next - samples.size();
+			next = written;
+
+			if (samplesArg.getValue()) {
+				for (auto const& sample : samples) {
+					std::cout << sample.time << " " << sample.rate << " " << sample.steps_per_second;
+					for (unsigned int population(0); population < ring->populations(); ++population) {
+						std::cout << " " << sample.population_rates[population];
+					}
+					std::cout << "\n";
+				}
+			} else if (!samples.empty()) {
+				TelemetrySample mean = TelemetrySample();
+				for (auto const& sample : samples) {
+					mean.rate += sample.rate;
+					for (unsigned int population(0); population < ring->populations(); ++population) {
+						mean.population_rates[population] += sample.population_rates[population];
+					}
+				}
+				std::cout << samples.back().time << " " << mean.rate / samples.size() << " " << samples.back().steps_per_second;
+				for (unsigned int population(0); population < ring->populations(); ++population) {
+					std::cout << " " << mean.population_rates[population] / samples.size();
+				}
+				std::cout << "\n";
+			}
+			std::cout << std::flush;
+			if (!finished) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(intervalArg.getValue()));
+			}
+		}
+		std::cout << "# finished after " << next << " time steps";
+		if (missed > 0) {
+			std::cout << ", " << missed << " overwritten before they were read";
+		}
+		std::cout << std::endl;
+		return 0;
+	} catch (TCLAP::ArgException& e) {
+		std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+	} catch (std::exception const& error) {
+		std::cerr << error.what() << std::endl;
+	}
+	return -1;
+}
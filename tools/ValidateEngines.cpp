@@ -0,0 +1,113 @@
+/*! \file ValidateEngines.cpp
+ *
+ *  \author Neuro-1
+ *
+ *  \date 18.10.2026
+ *
+ *  \brief Checks that a candidate engine simulates the same network as the reference engine.
+ *  \details Exits with 0 if the engines are equivalent, 1 if they aren't, -1 on errors.
+ *  \details Exact comparisons are only accepted for engines which can be bitwise identical, see can_be_identical().
+ *  \details Example: ValidateEngines --Candidate deterministic:4 --Reference deterministic:1
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <tclap/CmdLine.h>
+#include "../src/EngineValidation.hpp"
+
+#define BOLD "\033[1m\033[37m"
+#define RED "\033[1m\033[31m"
+#define GREEN "\033[1m\033[32m"
+#define RESET "\033[0m"
+
+static const unsigned int NUMBER_OF_NEURONS(12500);
+static const double TIME_STEP(0.1);
+
+int main(int argc, char** argv)
+{
+	try {
+		TCLAP::CmdLine cmd("Compares a candidate engine with the reference engine");
+		TCLAP::ValueArg<std::string> referenceArg("", "Reference", "Reference engine: sequential, parallel:<threads> or deterministic:<threads> (default: deterministic:1)", false, "deterministic:1", "engine");
+		cmd.add(referenceArg);
+		TCLAP::ValueArg<std::string> candidateArg("", "Candidate", "Engine to validate (default: deterministic:2)", false, "deterministic:2", "engine");
+		cmd.add(candidateArg);
+		std::vector<std::string> modes {"exact", "statistical"};
+		TCLAP::ValuesConstraint<std::string> modeConstraint(modes);
+		TCLAP::ValueArg<std::string> modeArg("", "Mode", "Bitwise identical states, or same activity up to noise (default: exact if the engines can be identical, statistical otherwise)", false, "exact", &modeConstraint);
+		cmd.add(modeArg);
+		TCLAP::ValueArg<int> stepsArg("", "Steps", "Number of time steps to simulate (default: 5000)", false, 5000, "int");
+		cmd.add(stepsArg);
+		TCLAP::ValueArg<int> burnInArg("", "Burn_in", "Time steps left out of the statistics (default: 1000)", false, 1000, "int");
+		cmd.add(burnInArg);
+		TCLAP::ValueArg<double> toleranceArg("", "Tolerance", "Accepted relative difference of the rates and fluctuations (default: 0.1)", false, 0.1, "double");
+		cmd.add(toleranceArg);
+		TCLAP::ValueArg<unsigned long> seedArg("s", "Seed", "Seed given to both engines (default: 0)", false, 0, "unsigned long");
+		cmd.add(seedArg);
+		TCLAP::ValueArg<double> relAmplitudeArg("g", "Relative_inhibitory_amplitude", "Inhibitory amplitude (default: 5)", false, 5.0, "double");
+		cmd.add(relAmplitudeArg);
+		TCLAP::ValueArg<double> ratioArg("f", "Ratio_Vext_divide_by_Vthr", "Ratio between External frequency (Vext) and Threshold frequency (Vthr) (default: 2)", false, 2.0, "double");
+		cmd.add(ratioArg);
+		TCLAP::ValueArg<double> amplitudeArg("j", "Excitatory_amplitude", "Amplitude of the spike of an excitatory neuron (default: 0.1 mV)", false, 0.1, "double");
+		cmd.add(amplitudeArg);
+		cmd.parse(argc, argv);
+
+		if (stepsArg.getValue() < 1 or toleranceArg.getValue() < 0) {
+			throw std::runtime_error("the number of steps has to be positive and the tolerance positive or 0");
+		}
+
+		EngineSpec const reference(parse_engine(referenceArg.getValue()));
+		EngineSpec const candidate(parse_engine(candidateArg.getValue()));
+		bool const identical(can_be_identical(reference, candidate));
+		std::string const mode(modeArg.isSet() ? modeArg.getValue() : (identical ? "exact" : "statistical"));
+		if (mode == "exact" and !identical) {
+			throw std::runtime_error("the engines " + referenceArg.getValue() + " and " + candidateArg.getValue()
+									 + " draw different noise and are never bitwise identical, compare them with --Mode statistical");
+		}
+
+		NetworkParameters const parameters {relAmplitudeArg.getValue(), amplitudeArg.getValue(), ratioArg.getValue(),
+											NUMBER_OF_NEURONS, TIME_STEP, seedArg.getValue()};
+		EngineValidation validation(parameters, reference, candidate);
+
+		std::cout << "Reference: " << BOLD << referenceArg.getValue() << RESET
+				  << ", candidate: " << BOLD << candidateArg.getValue() << RESET
+				  << ", " << mode << ", " << stepsArg.getValue() << " steps, seed " << seedArg.getValue() << std::endl;
+
+		bool equivalent(false);
+		if (mode == "exact") {
+			ExactReport const report(validation.compare_exact(stepsArg.getValue()));
+			equivalent = report.equivalent;
+			if (!equivalent) {
+				std::cout << "First divergence after step " << report.step
+						  << ": " << report.reference_spikes << " spikes in the reference, "
+						  << report.candidate_spikes << " in the candidate" << std::endl;
+				if (report.neuron >= 0) {
+					std::cout << std::setprecision(17) << "  neuron " << report.neuron << ", " << report.variable
+							  << ": " << report.reference_value << " in the reference, "
+							  << report.candidate_value << " in the candidate" << std::endl;
+				}
+			}
+		} else {
+			StatisticalReport const report(validation.compare_statistics(stepsArg.getValue(), burnInArg.getValue(), toleranceArg.getValue()));
+			equivalent = report.equivalent;
+			std::cout << std::setw(30) << std::left << "" << std::setw(14) << "reference" << "candidate" << std::endl;
+			std::cout << std::setw(30) << "  mean rate [Hz]" << std::setw(14) << report.reference_rate << report.candidate_rate << std::endl;
+			std::cout << std::setw(30) << "  deviation [spikes/step]" << std::setw(14) << report.reference_deviation << report.candidate_deviation << std::endl;
+			std::cout << "  KS distance of the neuron rates: " << report.ks_distance
+					  << " (critical " << report.ks_critical << ")" << std::endl;
+		}
+
+		if (equivalent) {
+			std::cout << GREEN << "EQUIVALENT" << RESET << std::endl;
+			return 0;
+		}
+		std::cout << RED << "NOT EQUIVALENT" << RESET << std::endl;
+		return 1;
+
+	} catch (TCLAP::ArgException& e) {
+		std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+	} catch (std::runtime_error const& error) {
+		std::cerr << error.what() << std::endl;
+	}
+	return -1;
+}